@@ -0,0 +1,119 @@
+#include "arena_allocator.h"
+
+#include "hilog/log.h"
+
+#undef LOG_TAG
+#define LOG_TAG "Tncnn"
+
+namespace arena {
+
+// 每个分配前保留一个头部记录大小，头部长度等于对齐长度，保证返回的指针仍按NCNN_MALLOC_ALIGN对齐
+static const size_t HEADER_SIZE = NCNN_MALLOC_ALIGN;
+// 溢出内存池保留的空闲块数上限，超过时释放（各层blob尺寸不同，默认的10会导致每帧反复分配）
+static const size_t OVERFLOW_DROP_THRESHOLD = 256;
+// 溢出分配的标记，与arena内的分配区分
+static const size_t FALLBACK_FLAG = (size_t)1 << (sizeof(size_t) * 8 - 1);
+
+static inline size_t align_size(size_t size) { return (size + NCNN_MALLOC_ALIGN - 1) & ~(size_t)(NCNN_MALLOC_ALIGN - 1); }
+
+static inline void update_max(std::atomic<size_t> &target, size_t value) {
+    size_t prev = target.load(std::memory_order_relaxed);
+    while (prev < value && !target.compare_exchange_weak(prev, value, std::memory_order_relaxed)) {
+    }
+}
+
+ArenaAllocator::ArenaAllocator(size_t max_capacity)
+    : base(nullptr), max_capacity(max_capacity), capacity(0), offset(0), arena_live(0), frame_bytes(0),
+      peak_frame_bytes(0), live_bytes(0), peak_live_bytes(0), allocations(0), fallback_allocations(0),
+      live_allocations(0), frames(0) {
+    overflow.set_size_drop_threshold(OVERFLOW_DROP_THRESHOLD);
+}
+
+ArenaAllocator::~ArenaAllocator() {
+    if (live_allocations.load() != 0) {
+        OH_LOG_DEBUG(LogType::LOG_APP, "arena destroyed with %{public}zu live allocations", live_allocations.load());
+    }
+    ncnn::fastFree(base);
+}
+
+void ArenaAllocator::on_alloc(size_t size) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    live_allocations.fetch_add(1, std::memory_order_relaxed);
+    update_max(peak_frame_bytes, frame_bytes.fetch_add(size, std::memory_order_relaxed) + size);
+    update_max(peak_live_bytes, live_bytes.fetch_add(size, std::memory_order_relaxed) + size);
+}
+
+void *ArenaAllocator::fastMalloc(size_t size) {
+    size_t total = HEADER_SIZE + align_size(size);
+    on_alloc(total);
+
+    // 推进偏移，越过容量后的分配全部溢出到堆，直到reset
+    size_t begin = offset.fetch_add(total, std::memory_order_relaxed);
+    size_t *header;
+    if (base != nullptr && begin + total <= capacity.load(std::memory_order_relaxed)) {
+        arena_live.fetch_add(1, std::memory_order_relaxed);
+        header = (size_t *)(base + begin);
+        *header = total;
+    } else {
+        fallback_allocations.fetch_add(1, std::memory_order_relaxed);
+        // 内存池经ncnn::fastMalloc分配，末尾已预留NCNN_MALLOC_OVERREAD供SIMD越界读取
+        header = (size_t *)overflow.fastMalloc(total);
+        *header = total | FALLBACK_FLAG;
+    }
+    return (unsigned char *)header + HEADER_SIZE;
+}
+
+void ArenaAllocator::fastFree(void *ptr) {
+    if (ptr == nullptr) {
+        return;
+    }
+    size_t *header = (size_t *)((unsigned char *)ptr - HEADER_SIZE);
+    size_t total = *header & ~FALLBACK_FLAG;
+    live_bytes.fetch_sub(total, std::memory_order_relaxed);
+    live_allocations.fetch_sub(1, std::memory_order_relaxed);
+    if (*header & FALLBACK_FLAG) {
+        overflow.fastFree(header);
+    } else {
+        arena_live.fetch_sub(1, std::memory_order_relaxed);
+    }
+}
+
+bool ArenaAllocator::reset() {
+    if (arena_live.load() != 0) {
+        OH_LOG_DEBUG(LogType::LOG_APP, "arena reset skipped, %{public}zu blobs still alive", arena_live.load());
+        return false;
+    }
+
+    // 上一帧溢出：扩大到该帧的分配总量，之后同样大小的帧不再溢出
+    size_t used = offset.load();
+    size_t cap = capacity.load();
+    if (used > cap && cap < max_capacity) {
+        size_t grown = used < max_capacity ? align_size(used) : max_capacity;
+        unsigned char *grown_base = (unsigned char *)ncnn::fastMalloc(grown + NCNN_MALLOC_OVERREAD);
+        if (grown_base != nullptr) {
+            ncnn::fastFree(base);
+            base = grown_base;
+            capacity = grown;
+            OH_LOG_DEBUG(LogType::LOG_APP, "arena grown to %{public}zu bytes", grown);
+        }
+    }
+
+    offset = 0;
+    frame_bytes = 0;
+    frames.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+void ArenaAllocator::stats(Stats &out) const {
+    out.capacity = capacity.load();
+    out.frame_bytes = frame_bytes.load();
+    out.peak_frame_bytes = peak_frame_bytes.load();
+    out.live_bytes = live_bytes.load();
+    out.peak_live_bytes = peak_live_bytes.load();
+    out.allocations = allocations.load();
+    out.fallback_allocations = fallback_allocations.load();
+    out.live_allocations = live_allocations.load();
+    out.frames = frames.load();
+}
+
+} // namespace arena
@@ -0,0 +1,73 @@
+#ifndef ARENA_ALLOCATOR_H
+#define ARENA_ALLOCATOR_H
+
+#include "allocator.h"
+#include <atomic>
+#include <cstddef>
+
+namespace arena {
+
+// 内存统计（字节数与次数）
+typedef struct Stats {
+    size_t capacity;              // arena容量
+    size_t frame_bytes;           // 当前帧已分配（含溢出部分，释放不回退）
+    size_t peak_frame_bytes;      // 单帧分配量的最大值，即arena需要的容量
+    size_t live_bytes;            // 当前未释放
+    size_t peak_live_bytes;       // 未释放量的最大值
+    size_t allocations;           // 累计分配次数
+    size_t fallback_allocations;  // 累计超出arena、由溢出内存池分配的次数
+    size_t live_allocations;      // 当前未释放的分配次数
+    size_t frames;                // 已重置的帧数
+} Stats;
+
+// 按帧重置的bump分配器，作为ncnn的blob_allocator
+// 每次分配只是原子地推进偏移，释放只更新计数，reset时整块回收。
+// bump分配不复用帧内已释放的块（ncnn按层消费后释放输入，释放顺序不是后进先出，回退尾部也几乎无法回收），
+// 因此arena需要的容量是一帧的分配总量（peak_frame_bytes），而不是同时存活的峰值（peak_live_bytes），
+// YOLOv8 640输入约为数十到上百MB。arena只扩大到max_capacity为止，放不下的请求由溢出内存池分配并跨帧复用，
+// 内存占用约为 capacity + 溢出部分的存活峰值（不超过peak_live_bytes）。
+// 某帧发生溢出且未达上限时，下次reset把arena扩大到该帧的分配总量，此后推理blob完全来自arena
+// （fallback_allocations不再增加，见benchmark_pipeline的检查）；达到上限后溢出的blob由内存池回收，同样不再分配堆内存。
+// 只覆盖blob：workspace由内存池回收，extractor自身的blob表等ncnn内部结构每帧仍会分配。
+// 只能用于每帧都会全部释放的blob，常驻数据（如加载模型时转换的权重）不能使用。
+class ArenaAllocator : public ncnn::Allocator {
+public:
+    // max_capacity: arena自动扩大的上限，为0时不使用arena，全部由溢出内存池分配（只统计）
+    explicit ArenaAllocator(size_t max_capacity = 32 * 1024 * 1024);
+    virtual ~ArenaAllocator();
+
+    virtual void *fastMalloc(size_t size);
+    virtual void fastFree(void *ptr);
+
+    // 开始新的一帧：arena中的分配已全部释放时回绕偏移，按需扩容
+    // 仍有arena分配未释放时不回绕，返回false
+    bool reset();
+
+    void stats(Stats &out) const;
+
+private:
+    ArenaAllocator(const ArenaAllocator &) = delete;
+    ArenaAllocator &operator=(const ArenaAllocator &) = delete;
+
+    // 记录分配大小
+    void on_alloc(size_t size);
+
+    unsigned char *base;
+    size_t max_capacity;
+    ncnn::PoolAllocator overflow;             // arena放不下的分配（加锁，ncnn可能在多个线程分配blob）
+    std::atomic<size_t> capacity;
+    std::atomic<size_t> offset;               // 下一个分配在arena中的偏移（可能超过capacity，表示已溢出）
+    std::atomic<size_t> arena_live;           // arena中未释放的分配数
+    std::atomic<size_t> frame_bytes;
+    std::atomic<size_t> peak_frame_bytes;
+    std::atomic<size_t> live_bytes;
+    std::atomic<size_t> peak_live_bytes;
+    std::atomic<size_t> allocations;
+    std::atomic<size_t> fallback_allocations;
+    std::atomic<size_t> live_allocations;
+    std::atomic<size_t> frames;
+};
+
+} // namespace arena
+
+#endif // ARENA_ALLOCATOR_H
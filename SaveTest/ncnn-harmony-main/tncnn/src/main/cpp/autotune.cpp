@@ -0,0 +1,172 @@
+#include "autotune.h"
+#include "benchmark_ncnn.h"
+#include "core_binding.h"
+#include "cpu.h"
+#include <fstream>
+#include <sstream>
+#include <sys/stat.h>
+
+#include "hilog/log.h"
+
+#undef LOG_TAG
+#define LOG_TAG "Tncnn"
+
+namespace autotune {
+
+std::string device_key() {
+    std::ostringstream key;
+    key << "cpu" << ncnn::get_cpu_count() << "-big" << ncnn::get_big_cpu_count() << "-little"
+        << ncnn::get_little_cpu_count();
+    return key.str();
+}
+
+std::string config_path(const std::string &dir, const std::string &model_type) {
+    return dir + "/autotune_" + model_type + ".cfg";
+}
+
+bool load(const std::string &path, Config &config) {
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        return false;
+    }
+
+    // 每行一个 key=value，candidate可以有多行
+    config = Config();
+    config.num_threads = 0;
+    config.powersave = 0;
+    config.avg = 0;
+    std::string line;
+    while (std::getline(file, line)) {
+        size_t eq = line.find('=');
+        if (eq == std::string::npos) {
+            continue;
+        }
+        std::string key = line.substr(0, eq);
+        std::istringstream value(line.substr(eq + 1));
+        if (key == "model") {
+            value >> config.model_type;
+        } else if (key == "device") {
+            value >> config.device;
+        } else if (key == "threads") {
+            value >> config.num_threads;
+        } else if (key == "powersave") {
+            value >> config.powersave;
+        } else if (key == "avg") {
+            value >> config.avg;
+        } else if (key == "candidate") {
+            Candidate candidate;
+            if (value >> candidate.num_threads >> candidate.powersave >> candidate.min >> candidate.avg) {
+                config.candidates.push_back(candidate);
+            }
+        }
+    }
+
+    if (config.num_threads <= 0 || config.powersave < 0 || config.powersave > 2) {
+        OH_LOG_DEBUG(LogType::LOG_APP, "autotune config invalid:%{public}s", path.c_str());
+        return false;
+    }
+    if (config.device != device_key()) {
+        OH_LOG_DEBUG(LogType::LOG_APP, "autotune config for other device:%{public}s", config.device.c_str());
+        return false;
+    }
+    return true;
+}
+
+bool save(const std::string &path, const Config &config) {
+    // 模型直接从rawfile映射时沙盒中可能还没有该目录
+    size_t slash = path.rfind('/');
+    if (slash != std::string::npos && slash > 0) {
+        mkdir(path.substr(0, slash).c_str(), 0755);
+    }
+    std::ofstream file(path, std::ios::trunc);
+    if (!file.is_open()) {
+        OH_LOG_DEBUG(LogType::LOG_APP, "autotune save fail:%{public}s", path.c_str());
+        return false;
+    }
+    file << "model=" << config.model_type << "\n";
+    file << "device=" << config.device << "\n";
+    file << "threads=" << config.num_threads << "\n";
+    file << "powersave=" << config.powersave << "\n";
+    file << "avg=" << config.avg << "\n";
+    for (const auto &candidate : config.candidates) {
+        file << "candidate=" << candidate.num_threads << " " << candidate.powersave << " " << candidate.min << " "
+             << candidate.avg << "\n";
+    }
+    return file.good();
+}
+
+// 线程数候选：1, 2, 4, ...直到max_threads（包含max_threads本身）
+static void add_candidates(std::vector<Candidate> &candidates, int powersave, int max_threads) {
+    for (int threads = 1; threads <= max_threads; threads *= 2) {
+        candidates.push_back({threads, powersave, 0, 0});
+        if (threads * 2 > max_threads && threads != max_threads) {
+            candidates.push_back({max_threads, powersave, 0, 0});
+        }
+    }
+}
+
+bool tune(const modelloader::ModelData &model, const std::string &model_type, ncnn::Option option, int input_size,
+          int loops, Config &config) {
+    // 候选组合：全部核心，以及大小核分离时的大核、小核
+    std::vector<Candidate> candidates;
+    add_candidates(candidates, 0, ncnn::get_cpu_count());
+    int little = ncnn::get_little_cpu_count();
+    int big = ncnn::get_big_cpu_count();
+    if (little > 0 && big > 0) {
+        add_candidates(candidates, 2, big);
+        add_candidates(candidates, 1, little);
+    }
+
+    // 线程数只影响extractor（创建时复制net.opt），模型只需加载一次
+    option.use_vulkan_compute = false;
+    benchmark::BenchmarkNet net;
+    net.opt = option;
+    if (net.load_param_mem(model.param.c_str()) != 0 || net.load_model(model.bin.data()) <= 0) {
+        OH_LOG_DEBUG(LogType::LOG_APP, "autotune load fail:%{public}s", model_type.c_str());
+        return false;
+    }
+
+    config = Config();
+    config.model_type = model_type;
+    config.device = device_key();
+    config.num_threads = 0;
+    config.powersave = 0;
+    config.avg = 0;
+    for (auto &candidate : candidates) {
+        net.opt.num_threads = candidate.num_threads;
+
+        benchmark::BenchmarkResult result;
+        {
+            corebinding::ScopedBinding binding(candidate.powersave);
+            result = net.run(loops, input_size);
+        }
+        candidate.min = result.min;
+        candidate.avg = result.avg;
+        if (result.loop == 0) {
+            // 未找到输入层，无法测速
+            OH_LOG_DEBUG(LogType::LOG_APP, "autotune no input:%{public}s", model_type.c_str());
+            break;
+        }
+        config.candidates.push_back(candidate);
+        OH_LOG_DEBUG(LogType::LOG_APP,
+                     "autotune %{public}s threads:%{public}d powersave:%{public}d min:%{public}.2f avg:%{public}.2f",
+                     model_type.c_str(), candidate.num_threads, candidate.powersave, candidate.min, candidate.avg);
+
+        if (config.num_threads == 0 || candidate.avg < config.avg) {
+            config.num_threads = candidate.num_threads;
+            config.powersave = candidate.powersave;
+            config.avg = candidate.avg;
+        }
+    }
+    net.clear();
+
+    OH_LOG_DEBUG(LogType::LOG_APP, "autotune %{public}s best threads:%{public}d powersave:%{public}d avg:%{public}.2f",
+                 model_type.c_str(), config.num_threads, config.powersave, config.avg);
+    return config.num_threads > 0;
+}
+
+void apply(const Config &config, ncnn::Option &option) {
+    option.num_threads = config.num_threads;
+}
+
+} // namespace autotune
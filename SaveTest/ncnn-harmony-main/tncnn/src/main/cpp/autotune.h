@@ -0,0 +1,53 @@
+#ifndef AUTOTUNE_H
+#define AUTOTUNE_H
+
+#include "model_loader.h"
+#include "net.h"
+#include <string>
+#include <vector>
+
+namespace autotune {
+
+// 一组候选配置的测量结果（毫秒）
+typedef struct Candidate {
+    int num_threads;
+    int powersave;      // 同ncnn::set_cpu_powersave：0全部 1小核 2大核
+    double min;
+    double avg;
+} Candidate;
+
+// 调优结果，按设备与模型保存在沙盒中
+typedef struct Config {
+    std::string model_type;
+    std::string device;                // 设备标识（CPU核心布局），与当前设备不一致时配置失效
+    int num_threads;
+    int powersave;
+    double avg;                        // 所选配置的平均耗时
+    std::vector<Candidate> candidates; // 按测试顺序
+} Config;
+
+// 当前设备的标识，如 "cpu8-big4-little4"
+std::string device_key();
+
+// 配置文件路径：<dir>/autotune_<model_type>.cfg
+std::string config_path(const std::string &dir, const std::string &model_type);
+
+// 读取配置，文件不存在、格式错误或属于其他设备时返回false
+bool load(const std::string &path, Config &config);
+
+bool save(const std::string &path, const Config &config);
+
+// 对 num_threads × powersave 的候选组合逐一测速，选出平均耗时最短的配置
+// 使用实际的模型与option（强制CPU推理），每个组合预热后测试loops次。
+// 各组合的核心只绑定调用线程，测速后恢复，不影响其他推理。
+bool tune(const modelloader::ModelData &model, const std::string &model_type, ncnn::Option option, int input_size,
+          int loops, Config &config);
+
+// 将配置的线程数应用到option
+// 不设置powersave：set_cpu_powersave作用于整个进程，会影响其他实例的推理；
+// config.powersave由调用方交给detector::create，推理期间按实例绑定推理线程
+void apply(const Config &config, ncnn::Option &option);
+
+} // namespace autotune
+
+#endif // AUTOTUNE_H
@@ -0,0 +1,205 @@
+#include "batch.h"
+#include "benchmark.h"
+#include "cpu.h"
+#include <algorithm>
+
+#include "hilog/log.h"
+
+#undef LOG_TAG
+#define LOG_TAG "Tncnn"
+
+namespace batch {
+
+WorkStealingPool::WorkStealingPool(int workers, std::function<void(int)> on_start, std::function<void(int)> on_stop)
+    : on_start(on_start), on_stop(on_stop), task(nullptr), generation(0), remaining(0), stopping(false) {
+    workers = std::max(workers, 1);
+    for (int i = 0; i < workers; i++) {
+        queues.push_back(std::unique_ptr<TaskQueue>(new TaskQueue()));
+    }
+    for (int i = 0; i < workers; i++) {
+        threads.push_back(std::thread(&WorkStealingPool::worker_loop, this, i));
+    }
+}
+
+WorkStealingPool::~WorkStealingPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (auto &thread : threads) {
+        thread.join();
+    }
+}
+
+void WorkStealingPool::run(int count, const std::function<void(int, int)> &task) {
+    if (count <= 0) {
+        return;
+    }
+
+    // 按连续区间分给各worker，相邻图片通常尺寸相同，worker内的letterbox计划可以复用
+    int workers = size();
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        this->task = &task;
+        remaining = count;
+        for (int i = 0; i < workers; i++) {
+            std::lock_guard<std::mutex> queue_lock(queues[i]->mutex);
+            for (int index = (int)((long)count * i / workers); index < (int)((long)count * (i + 1) / workers);
+                 index++) {
+                queues[i]->indexes.push_back(index);
+            }
+        }
+        generation++;
+    }
+    wake.notify_all();
+
+    std::unique_lock<std::mutex> lock(mutex);
+    done.wait(lock, [this] { return remaining == 0; });
+    this->task = nullptr;
+}
+
+bool WorkStealingPool::pop(int worker, int &index) {
+    TaskQueue &queue = *queues[worker];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (queue.indexes.empty()) {
+        return false;
+    }
+    index = queue.indexes.front();
+    queue.indexes.pop_front();
+    return true;
+}
+
+bool WorkStealingPool::steal(int worker, int &index) {
+    // 从下一个worker开始轮询，窃取队尾（离对方当前处理位置最远）
+    int workers = size();
+    for (int i = 1; i < workers; i++) {
+        TaskQueue &queue = *queues[(worker + i) % workers];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (!queue.indexes.empty()) {
+            index = queue.indexes.back();
+            queue.indexes.pop_back();
+            return true;
+        }
+    }
+    return false;
+}
+
+void WorkStealingPool::worker_loop(int worker) {
+    if (on_start) {
+        on_start(worker);
+    }
+
+    unsigned int seen = 0;
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wake.wait(lock, [this, seen] { return stopping || generation != seen; });
+            if (stopping) {
+                break;
+            }
+            seen = generation;
+        }
+
+        int index;
+        while (pop(worker, index) || steal(worker, index)) {
+            // 任务在run持有mutex期间入队，取到任务后读到的一定是同一次run的task
+            const std::function<void(int, int)> *current;
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                current = task;
+            }
+            (*current)(worker, index);
+            bool finished;
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                finished = --remaining == 0;
+            }
+            if (finished) {
+                done.notify_all();
+            }
+        }
+    }
+
+    if (on_stop) {
+        on_stop(worker);
+    }
+}
+
+// 每个worker的推理上下文，分配器只在该worker线程使用（需在state之前构造、之后析构）
+typedef struct WorkerContext {
+    ncnn::UnlockedPoolAllocator blob_allocator;
+    ncnn::UnlockedPoolAllocator workspace_allocator;
+    yolo::FrameState state;
+} WorkerContext;
+
+void run(yolo::YOLOv8 &model, const std::vector<Image> &images, const Options &options,
+         std::vector<std::vector<yolo::BoxInfo>> &results, Stats &stats) {
+    results.assign(images.size(), std::vector<yolo::BoxInfo>());
+
+    // 有大小核时只用大核（小核上的extractor会拖慢整批），每个extractor单线程，图片间并行
+    int big = ncnn::get_big_cpu_count();
+    int little = ncnn::get_little_cpu_count();
+    bool pin_big = big > 0 && little > 0;
+    int workers = options.workers > 0 ? options.workers : (pin_big ? big : ncnn::get_cpu_count());
+    int threads_per_worker = options.threads_per_worker > 0 ? options.threads_per_worker : 1;
+    workers = std::max(std::min(workers, (int)images.size()), 1);
+    stats.workers = workers;
+    stats.threads_per_worker = threads_per_worker;
+    stats.wall = 0;
+    stats.busy = 0;
+    if (images.empty()) {
+        return;
+    }
+
+    std::vector<std::unique_ptr<WorkerContext>> contexts;
+    for (int i = 0; i < workers; i++) {
+        contexts.push_back(std::unique_ptr<WorkerContext>(new WorkerContext()));
+        model.init_frame(contexts.back()->state);
+    }
+    std::vector<double> busy(workers, 0.0);
+
+    double start = ncnn::get_current_time();
+    {
+        // set_cpu_thread_affinity同时绑定该线程的OpenMP线程组，这些线程可能回到OpenMP的线程池被其他推理复用，
+        // worker退出前恢复为进程的powersave设置
+        int saved_powersave = ncnn::get_cpu_powersave();
+        WorkStealingPool pool(
+            workers,
+            [pin_big](int /*worker*/) {
+                if (pin_big) {
+                    ncnn::set_cpu_thread_affinity(ncnn::get_cpu_thread_affinity_mask(2));
+                }
+            },
+            [pin_big, saved_powersave](int /*worker*/) {
+                if (pin_big) {
+                    ncnn::set_cpu_thread_affinity(ncnn::get_cpu_thread_affinity_mask(saved_powersave));
+                }
+            });
+        pool.run((int)images.size(), [&](int worker, int index) {
+            const Image &image = images[index];
+            WorkerContext &context = *contexts[worker];
+            double image_start = ncnn::get_current_time();
+            if (model.preprocess(context.state, image.rgba, image.width, image.height)) {
+                model.forward_concurrent(context.state, threads_per_worker, &context.blob_allocator,
+                                         &context.workspace_allocator);
+                results[index] = model.postprocess(context.state);
+            }
+            busy[worker] += ncnn::get_current_time() - image_start;
+        });
+    }
+    stats.wall = ncnn::get_current_time() - start;
+    for (double time : busy) {
+        stats.busy += time;
+    }
+
+    // 输出来自各worker的内存池，先于分配器释放
+    for (auto &context : contexts) {
+        context->state.output.release();
+    }
+    OH_LOG_DEBUG(LogType::LOG_APP,
+                 "batch %{public}zu images, workers:%{public}d threads:%{public}d wall:%{public}.2f busy:%{public}.2f",
+                 images.size(), workers, threads_per_worker, stats.wall, stats.busy);
+}
+
+} // namespace batch
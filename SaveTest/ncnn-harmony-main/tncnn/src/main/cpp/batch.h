@@ -0,0 +1,85 @@
+#ifndef BATCH_H
+#define BATCH_H
+
+#include "yolov8.h"
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace batch {
+
+// 工作窃取线程池
+// 每个worker有自己的任务队列，先从队头依次处理自己的任务，空了再从其他worker的队尾窃取，
+// 各张图片耗时不均（尺寸、检测框数量不同）时负载仍然均衡。
+class WorkStealingPool {
+public:
+    // on_start: 每个worker线程启动时调用一次（如绑定CPU核心），可以为空
+    // on_stop: 每个worker线程退出前调用一次（如恢复绑定），可以为空
+    WorkStealingPool(int workers, std::function<void(int)> on_start, std::function<void(int)> on_stop = nullptr);
+    ~WorkStealingPool();
+
+    int size() const { return (int)queues.size(); }
+
+    // 执行count个任务 task(worker, index)，全部完成后返回；调用线程只等待，不执行任务
+    // 不能同时从多个线程调用
+    void run(int count, const std::function<void(int, int)> &task);
+
+private:
+    typedef struct TaskQueue {
+        std::mutex mutex;
+        std::deque<int> indexes;
+    } TaskQueue;
+
+    void worker_loop(int worker);
+    bool pop(int worker, int &index);
+    bool steal(int worker, int &index);
+
+    std::vector<std::unique_ptr<TaskQueue>> queues;
+    std::vector<std::thread> threads;
+    std::function<void(int)> on_start;
+    std::function<void(int)> on_stop;
+    const std::function<void(int, int)> *task;
+
+    std::mutex mutex;                    // 保护以下状态
+    std::condition_variable wake;
+    std::condition_variable done;
+    unsigned int generation;             // 每次run递增，唤醒worker
+    int remaining;
+    bool stopping;
+};
+
+// 一张RGBA图片，识别期间必须保持有效
+typedef struct Image {
+    const unsigned char *rgba;
+    int width;
+    int height;
+} Image;
+
+// 并行度
+typedef struct Options {
+    int workers;              // 并发的extractor数，<=0时按核心数自动选择（有大小核时为大核数）
+    int threads_per_worker;   // 每个extractor的线程数，<=0时为1
+} Options;
+
+// 批量统计（毫秒）
+typedef struct Stats {
+    int workers;
+    int threads_per_worker;
+    double wall;              // 总耗时
+    double busy;              // 各图片识别耗时之和，busy / wall 即实际并行度
+} Stats;
+
+// 共用一个已加载的YOLOv8（同一ncnn::Net）批量识别RGBA图片，结果按图片顺序
+// 每个worker有独立的帧状态与无锁内存池，extractor之间互不影响，每张图片在一个worker上完成预处理、推理与后处理。
+// 执行期间模型不能用于其他推理（调用方持有实例锁）。
+void run(yolo::YOLOv8 &model, const std::vector<Image> &images, const Options &options,
+         std::vector<std::vector<yolo::BoxInfo>> &results, Stats &stats);
+
+} // namespace batch
+
+#endif // BATCH_H
@@ -1,6 +1,14 @@
 #include "benchmark_ncnn.h"
+#include "arena_allocator.h"
+#include "autotune.h"
+#include "nms.h"
+#include <algorithm>
 #include <cfloat>
+#include <chrono>
+#include <cmath>
 #include <map>
+#include <sstream>
+#include <thread>
 
 #include "hilog/log.h"
 
@@ -18,11 +26,67 @@ size_t benchmark::DataReaderFromEmpty::read(void *buf, size_t size) const {
 }
 
 
-benchmark::BenchmarkResult benchmark::BenchmarkNet::run(int loops, double &time_min, double &time_max, double &time_avg, int &width,
-                                 int &height, int size) {
-    time_min = DBL_MAX;
-    time_max = -DBL_MAX;
-    time_avg = 0;
+// 已排序样本的百分位（相邻秩之间线性插值）
+static double percentile(const std::vector<double> &sorted, double p) {
+    if (sorted.empty()) {
+        return 0;
+    }
+    double pos = p / 100.0 * (sorted.size() - 1);
+    size_t lower = (size_t)pos;
+    size_t upper = std::min(lower + 1, sorted.size() - 1);
+    return sorted[lower] + (sorted[upper] - sorted[lower]) * (pos - lower);
+}
+
+void compute_stats(BenchmarkResult &result) {
+    const std::vector<double> &samples = result.samples;
+    result.loop = (int)samples.size();
+    result.histogram.assign(HISTOGRAM_BINS, 0);
+    if (samples.empty()) {
+        result.min = result.max = result.avg = result.p50 = result.p90 = result.p99 = 0;
+        result.stddev = result.drift = result.histogram_width = 0;
+        return;
+    }
+
+    std::vector<double> sorted = samples;
+    std::sort(sorted.begin(), sorted.end());
+    result.min = sorted.front();
+    result.max = sorted.back();
+    result.p50 = percentile(sorted, 50);
+    result.p90 = percentile(sorted, 90);
+    result.p99 = percentile(sorted, 99);
+
+    double sum = 0;
+    for (double time : samples) {
+        sum += time;
+    }
+    result.avg = sum / samples.size();
+    double variance = 0;
+    for (double time : samples) {
+        variance += (time - result.avg) * (time - result.avg);
+    }
+    result.stddev = std::sqrt(variance / samples.size());
+
+    result.histogram_width = (result.max - result.min) / HISTOGRAM_BINS;
+    for (double time : samples) {
+        int bin = result.histogram_width > 0 ? (int)((time - result.min) / result.histogram_width) : 0;
+        result.histogram[std::min(bin, HISTOGRAM_BINS - 1)]++;
+    }
+
+    // 按测试顺序比较首尾1/4，样本太少时为0
+    size_t quarter = samples.size() / 4;
+    result.drift = 0;
+    if (quarter > 0) {
+        double head = 0, tail = 0;
+        for (size_t i = 0; i < quarter; i++) {
+            head += samples[i];
+            tail += samples[samples.size() - 1 - i];
+        }
+        result.drift = (tail - head) / quarter;
+    }
+}
+
+benchmark::BenchmarkResult benchmark::BenchmarkNet::run(int loops, int size, const RunSettings &settings) {
+    BenchmarkResult benchmarkResult = BenchmarkResult();
 
     // resolve input shape
     const std::vector<const char *> &input_names_x = input_names();
@@ -46,51 +110,26 @@ benchmark::BenchmarkResult benchmark::BenchmarkNet::run(int loops, double &time_
                 const ncnn::Mat &shape = layer->top_shapes[0];
                 if (shape.c == 0 || shape.h == 0 || shape.w == 0) {
                     in.create(size, size, 3);
-                    width = size;
-                    height = size;
+                    benchmarkResult.width = size;
+                    benchmarkResult.height = size;
                 } else {
                     in.create(shape.w, shape.h, shape.c);
-                    width = shape.w;
-                    height = shape.h;
+                    benchmarkResult.width = shape.w;
+                    benchmarkResult.height = shape.h;
                 }
                 in.fill(0.01f);
                 input_mats_x.push_back(in);
             }
         }
 
-        if (input_names_x.empty()) {
-            BenchmarkResult benchmarkResult;
-            return benchmarkResult;
-        }
-        if (input_mats_x.empty()) {
-            BenchmarkResult benchmarkResult;
-            return benchmarkResult;
-        }
-        if (input_names_x.size() != input_mats_x.size()) {
-            BenchmarkResult benchmarkResult;
+        if (input_names_x.empty() || input_mats_x.empty() || input_names_x.size() != input_mats_x.size()) {
+            compute_stats(benchmarkResult);
             return benchmarkResult;
         }
     }
 
     ncnn::Mat out;
-
-    // warm up
-    const int g_warmup_loop_count = 5; // FIXME hardcode
-    for (int i = 0; i < g_warmup_loop_count; i++) {
-//         OH_LOG_DEBUG(LogType::LOG_APP, "warm up:%{public}d", i + 1);
-
-        ncnn::Extractor ex = create_extractor();
-        for (int j = 0; j < input_names_x.size(); j++) {
-            ex.input(input_names_x[j], input_mats_x[j]);
-        }
-        for (int j = 0; j < output_names_x.size(); j++) {
-            ex.extract(output_names_x[j], out);
-        }
-    }
-
-    for (int i = 0; i < loops; i++) {
-//         OH_LOG_DEBUG(LogType::LOG_APP, "benchmark run:%{public}d", i + 1);
-
+    auto forward = [&]() {
         double start = ncnn::get_current_time();
         {
             ncnn::Extractor ex = create_extractor();
@@ -101,28 +140,242 @@ benchmark::BenchmarkResult benchmark::BenchmarkNet::run(int loops, double &time_
                 ex.extract(output_names_x[j], out);
             }
         }
+        return ncnn::get_current_time() - start;
+    };
 
-        double end = ncnn::get_current_time();
+    // cold start
+    benchmarkResult.cold = forward();
 
-        double time = end - start;
+    // warm up：按时长或按次数
+    double warmup_start = ncnn::get_current_time();
+    benchmarkResult.warmup_loops = 0;
+    if (settings.warmup_ms > 0) {
+        do {
+            forward();
+            benchmarkResult.warmup_loops++;
+        } while (ncnn::get_current_time() - warmup_start < settings.warmup_ms);
+    } else {
+        for (; benchmarkResult.warmup_loops < settings.warmup_loops; benchmarkResult.warmup_loops++) {
+            forward();
+        }
+    }
+    benchmarkResult.warmup_ms = ncnn::get_current_time() - warmup_start;
 
-        time_min = std::min(time_min, time);
-        time_max = std::max(time_max, time);
-        time_avg += time;
+    // 逐层计时只统计正式测试的轮次，trace只记录最后一轮
+    // 计时层只支持CPU，GPU推理时不计时（调用方应在加载前关闭use_vulkan_compute）
+    bool profile = settings.profile && !opt.use_vulkan_compute;
+    if (settings.profile && !profile) {
+        OH_LOG_DEBUG(LogType::LOG_APP, "benchmark profile skipped: vulkan compute enabled");
+    }
+    if (profile) {
+        if (!layer_profiler.attached()) {
+            layer_profiler.attach(*this);
+        }
+        layer_profiler.reset();
     }
 
-    time_avg /= loops;
-    
-    BenchmarkResult benchmarkResult;
-    benchmarkResult.loop = loops;
-    benchmarkResult.min = time_min;
-    benchmarkResult.max = time_max;
-    benchmarkResult.avg = time_avg;
-    benchmarkResult.width = width;
-    benchmarkResult.height = height;
+    benchmarkResult.samples.reserve(loops);
+    for (int i = 0; i < loops; i++) {
+        if (settings.cooldown_ms > 0 && i > 0) {
+            std::this_thread::sleep_for(std::chrono::microseconds((long long)(settings.cooldown_ms * 1000)));
+        }
+        if (profile && i == loops - 1) {
+            layer_profiler.set_tracing(true);
+        }
+        benchmarkResult.samples.push_back(forward());
+    }
+
+    if (profile) {
+        layer_profiler.set_tracing(false);
+        benchmarkResult.layers_by_name = layer_profiler.by_name(settings.top_n);
+        benchmarkResult.layers_by_type = layer_profiler.by_type(0);
+        benchmarkResult.layers_total = layer_profiler.total();
+        benchmarkResult.trace = layer_profiler.chrome_trace();
+    }
 
+    compute_stats(benchmarkResult);
     return benchmarkResult;
 };
 
 
+NmsBenchmarkResult run_nms(int num_boxes, int loops) {
+    // 固定种子的线性同余序列，保证每次生成相同的候选框
+    unsigned int seed = 12345;
+    auto next = [&seed](int range) {
+        seed = seed * 1103515245 + 12345;
+        return (int)((seed >> 16) % range);
+    };
+
+    nms::NmsSolver solver;
+    solver.reserve(num_boxes);
+    for (int i = 0; i < num_boxes; i++) {
+        // 货架场景：候选框聚集在少量目标附近
+        int cluster = next(64);
+        float cx = (cluster % 8) * 80.f + 40.f + next(16);
+        float cy = (cluster / 8) * 80.f + 40.f + next(16);
+        float w = 40.f + next(40);
+        float h = 40.f + next(40);
+        solver.add(cx - w / 2, cy - h / 2, cx + w / 2, cy + h / 2, next(10000) / 10000.f, next(80));
+    }
+
+    nms::Params params;
+    params.iou_threshold = 0.45f;
+    params.mode = nms::MODE_CLASS_AWARE;
+    params.coord_offset = 0.f;
+
+    NmsBenchmarkResult result;
+    result.boxes = num_boxes;
+    result.kept = 0;
+    result.min = DBL_MAX;
+    result.avg = 0;
+    for (int i = 0; i < loops; i++) {
+        double start = ncnn::get_current_time();
+        result.kept = (int)solver.run(params).size();
+        double time = ncnn::get_current_time() - start;
+
+        result.min = std::min(result.min, time);
+        result.avg += time;
+    }
+    result.avg /= std::max(loops, 1);
+
+    return result;
+}
+
+static bool support_fp16_storage() {
+#if defined(__aarch64__) || defined(__arm__)
+    return ncnn::cpu_support_arm_vfpv4() || ncnn::cpu_support_arm_asimdhp();
+#elif defined(__x86_64__) || defined(__i386__)
+    return ncnn::cpu_support_x86_f16c();
+#else
+    return false;
+#endif
+}
+
+static bool support_fp16_arithmetic() {
+#if defined(__aarch64__) || defined(__arm__)
+    return ncnn::cpu_support_arm_asimdhp();
+#elif defined(__x86_64__) || defined(__i386__)
+    return ncnn::cpu_support_x86_avx512_fp16();
+#else
+    return false;
+#endif
+}
+
+std::vector<SweepEntry> sweep_candidates() {
+    // 精度：fp32, bf16存储, fp16存储, fp16存储+计算
+    std::vector<int> precisions = {0, 1};
+    if (support_fp16_storage()) {
+        precisions.push_back(2);
+        if (support_fp16_arithmetic()) {
+            precisions.push_back(3);
+        }
+    }
+
+    std::vector<SweepEntry> entries;
+    for (int winograd = 0; winograd < 2; winograd++) {
+        for (int sgemm = 0; sgemm < 2; sgemm++) {
+            for (int packing = 0; packing < 2; packing++) {
+                for (int lightmode = 0; lightmode < 2; lightmode++) {
+                    for (int precision : precisions) {
+                        SweepEntry entry = SweepEntry();
+                        entry.winograd = winograd;
+                        entry.sgemm = sgemm;
+                        entry.packing = packing;
+                        entry.lightmode = lightmode;
+                        entry.bf16_storage = precision == 1;
+                        entry.fp16_storage = precision >= 2;
+                        entry.fp16_arithmetic = precision == 3;
+                        entries.push_back(entry);
+                    }
+                }
+            }
+        }
+    }
+    return entries;
+}
+
+static void run_sweep_entry(SweepEntry &entry, const std::string &param_text, const std::string &param_path,
+                            const ncnn::Option &base, int size, int loops, const RunSettings &settings) {
+    // 统计分配器需在net之后析构
+    arena::ArenaAllocator blob_counter(0);
+    arena::ArenaAllocator workspace_counter(0);
+
+    BenchmarkNet net;
+    net.opt = base;
+    net.opt.use_vulkan_compute = false;
+    net.opt.use_winograd_convolution = entry.winograd;
+    net.opt.use_sgemm_convolution = entry.sgemm;
+    net.opt.use_packing_layout = entry.packing;
+    net.opt.lightmode = entry.lightmode;
+    net.opt.use_bf16_storage = entry.bf16_storage;
+    net.opt.use_fp16_packed = entry.fp16_storage;
+    net.opt.use_fp16_storage = entry.fp16_storage;
+    net.opt.use_fp16_arithmetic = entry.fp16_arithmetic;
+    net.opt.blob_allocator = &blob_counter;
+    net.opt.workspace_allocator = &workspace_counter;
+
+    int rp = param_text.empty() ? net.load_param(param_path.c_str()) : net.load_param_mem(param_text.c_str());
+    DataReaderFromEmpty dr;
+    if (rp != 0 || net.load_model(dr) != 0) {
+        entry.ok = false;
+        return;
+    }
+
+    BenchmarkResult result = net.run(loops, size, settings);
+    entry.ok = result.loop > 0;
+    entry.loop = result.loop;
+    entry.min = result.min;
+    entry.p50 = result.p50;
+    entry.p90 = result.p90;
+    entry.p99 = result.p99;
+    entry.max = result.max;
+    entry.avg = result.avg;
+    net.clear();
+
+    arena::Stats stats;
+    blob_counter.stats(stats);
+    entry.peak_blob_bytes = stats.peak_live_bytes;
+    workspace_counter.stats(stats);
+    entry.peak_workspace_bytes = stats.peak_live_bytes;
+}
+
+std::vector<SweepEntry> run_sweep(const std::string &param_text, const std::string &param_path,
+                                  const ncnn::Option &base, int size, int loops, const RunSettings &settings) {
+    std::vector<SweepEntry> entries = sweep_candidates();
+    for (size_t i = 0; i < entries.size(); i++) {
+        run_sweep_entry(entries[i], param_text, param_path, base, size, loops, settings);
+        OH_LOG_DEBUG(LogType::LOG_APP, "sweep %{public}zu/%{public}zu ok:%{public}d p50:%{public}.3f",
+                     i + 1, entries.size(), entries[i].ok, entries[i].p50);
+    }
+
+    std::stable_sort(entries.begin(), entries.end(), [](const SweepEntry &a, const SweepEntry &b) {
+        if (a.ok != b.ok) {
+            return a.ok;
+        }
+        return a.p50 != b.p50 ? a.p50 < b.p50 : a.p90 < b.p90;
+    });
+    return entries;
+}
+
+std::string sweep_to_json(const std::string &model_name, const std::vector<SweepEntry> &entries) {
+    std::ostringstream json;
+    json.setf(std::ios::fixed);
+    json.precision(3);
+    json << std::boolalpha;
+    json << "{\"model\":\"" << model_name << "\",\"device\":\"" << autotune::device_key() << "\",\"results\":[";
+    for (size_t i = 0; i < entries.size(); i++) {
+        const SweepEntry &e = entries[i];
+        json << (i == 0 ? "" : ",") << "\n{\"rank\":" << i + 1 << ",\"ok\":" << e.ok
+             << ",\"winograd\":" << e.winograd << ",\"sgemm\":" << e.sgemm << ",\"packing\":" << e.packing
+             << ",\"lightMode\":" << e.lightmode << ",\"bf16Storage\":" << e.bf16_storage
+             << ",\"fp16Storage\":" << e.fp16_storage << ",\"fp16Arithmetic\":" << e.fp16_arithmetic
+             << ",\"loop\":" << e.loop << ",\"min\":" << e.min << ",\"p50\":" << e.p50 << ",\"p90\":" << e.p90
+             << ",\"p99\":" << e.p99 << ",\"max\":" << e.max << ",\"avg\":" << e.avg
+             << ",\"peakBlobBytes\":" << e.peak_blob_bytes << ",\"peakWorkspaceBytes\":" << e.peak_workspace_bytes
+             << "}";
+    }
+    json << "]}";
+    return json.str();
+}
+
 } // namespace benchmark
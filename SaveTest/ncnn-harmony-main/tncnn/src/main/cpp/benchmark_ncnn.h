@@ -7,19 +7,63 @@
 #include "net.h"
 #include "gpu.h"
 #include "benchmark.h"
+#include "layer_profiler.h"
 #include <string>
+#include <vector>
 
 namespace benchmark {
 
+// 直方图区间数
+static const int HISTOGRAM_BINS = 10;
+
+// 基准测试结果，耗时均为毫秒
 typedef struct BenchmarkResult {
     int loop;
-    int min;
-    int max;
-    int avg;
+    double min;
+    double max;
+    double avg;
+    double p50;
+    double p90;
+    double p99;
+    double stddev;
+    double cold;                 // 加载后的第一次推理（首次分配、缓存未命中），不计入统计
+    double drift;                // 后1/4样本均值 - 前1/4样本均值，为正说明越测越慢（如发热降频）
+    int warmup_loops;            // 实际预热次数（不含冷启动那一次）
+    double warmup_ms;            // 预热总耗时
+    double histogram_width;      // 直方图区间宽度，区间从min开始
+    std::vector<int> histogram;  // 各区间样本数（HISTOGRAM_BINS个）
+    std::vector<double> samples; // 按测试顺序的每轮耗时
     int width;
     int height;
+    // 逐层计时（RunSettings::profile开启时）：各层在所有测试轮次中的累计耗时
+    std::vector<profiler::LayerStat> layers_by_name;  // 前top_n个
+    std::vector<profiler::LayerStat> layers_by_type;
+    double layers_total;         // 所有层的累计耗时，与samples之和的差为层之间的开销
+    std::string trace;           // 最后一轮的Chrome trace JSON
 } BenchmarkResult;
 
+// 预热与冷却设置
+typedef struct RunSettings {
+    int warmup_loops = 5;        // 预热次数
+    double warmup_ms = 0;        // 大于0时按时长预热（至少一次），忽略warmup_loops
+    double cooldown_ms = 0;      // 每轮之间休眠的时长（不计入耗时），用于观察降频的影响
+    bool profile = false;        // 逐层计时（计时本身有少量开销，总耗时会略高；只支持CPU推理，需在加载前关闭use_vulkan_compute）
+    int top_n = 20;              // 按层名汇总时返回的层数
+} RunSettings;
+
+// 由result.samples计算min/max/avg/百分位/标准差/直方图/漂移
+void compute_stats(BenchmarkResult &result);
+
+typedef struct NmsBenchmarkResult {
+    int boxes;
+    int kept;
+    double min;
+    double avg;
+} NmsBenchmarkResult;
+
+// NMS微基准：随机生成num_boxes个候选框（80类，成簇分布），按类别NMS执行loops次
+NmsBenchmarkResult run_nms(int num_boxes, int loops);
+
 class DataReaderFromEmpty : public ncnn::DataReader {
 public:
     virtual int scan(const char *format, void *p) const;
@@ -28,10 +72,48 @@ public:
 
 class BenchmarkNet : public ncnn::Net {
 public:
-    BenchmarkResult run(int loops, double &time_min, double &time_max, double &time_avg, int &width, int &height, int size);
+    // 输入形状未知时按 size x size x 3，输入无法解析时返回的loop为0
+    // 需在load_model之后调用；开启profile时首次调用会用计时层替换网络中的层（GPU推理时不计时）
+    BenchmarkResult run(int loops, int size, const RunSettings &settings = RunSettings());
 
+private:
+    profiler::Profiler layer_profiler;
 };
 
+// 选项组合的测试结果，耗时为毫秒
+typedef struct SweepEntry {
+    bool winograd;
+    bool sgemm;
+    bool packing;
+    bool fp16_storage;        // 同时开启fp16_packed
+    bool fp16_arithmetic;
+    bool bf16_storage;
+    bool lightmode;
+    bool ok;                  // 加载与推理是否成功
+    int loop;
+    double min;
+    double p50;
+    double p90;
+    double p99;
+    double max;
+    double avg;
+    size_t peak_blob_bytes;       // blob分配器同时占用的最大字节数（含加载时转换的权重）
+    size_t peak_workspace_bytes;  // workspace分配器同时占用的最大字节数
+} SweepEntry;
+
+// 在base上枚举 winograd × sgemm × packing × lightmode × 精度（fp32/bf16/fp16存储/fp16计算）的组合
+// 按cpu特性剪枝：不支持的fp16存储或计算不测试；bf16只在fp16关闭时测试（两者同时开启时ncnn优先fp16）
+std::vector<SweepEntry> sweep_candidates();
+
+// 逐一测试各组合，模型使用空权重，返回按p50升序（失败的排在最后）
+// param_text不为空时从内存加载，否则从param_path加载
+std::vector<SweepEntry> run_sweep(const std::string &param_text, const std::string &param_path,
+                                  const ncnn::Option &base, int size, int loops,
+                                  const RunSettings &settings = RunSettings());
+
+// 结果表转换为JSON：{"model", "device", "loop", "results": [{rank, option..., latency..., memory...}]}
+std::string sweep_to_json(const std::string &model_name, const std::vector<SweepEntry> &entries);
+
 
 } // namespace benchmark
 
@@ -0,0 +1,20 @@
+#include "core_binding.h"
+#include "cpu.h"
+
+namespace corebinding {
+
+ScopedBinding::ScopedBinding(int powersave) : bound(false) {
+    // 与进程设置相同时绑定前后的掩码一致，省去每帧两次系统调用
+    if (powersave < 0 || powersave == ncnn::get_cpu_powersave()) {
+        return;
+    }
+    bound = ncnn::set_cpu_thread_affinity(ncnn::get_cpu_thread_affinity_mask(powersave)) == 0;
+}
+
+ScopedBinding::~ScopedBinding() {
+    if (bound) {
+        ncnn::set_cpu_thread_affinity(ncnn::get_cpu_thread_affinity_mask(ncnn::get_cpu_powersave()));
+    }
+}
+
+} // namespace corebinding
@@ -0,0 +1,24 @@
+#ifndef CORE_BINDING_H
+#define CORE_BINDING_H
+
+namespace corebinding {
+
+// 在作用域内把调用线程（及其OpenMP线程组）绑定到指定核心，离开作用域时恢复为进程的powersave设置
+// powersave同set_cpu_powersave：0全部，1小核，2大核；-1或与进程设置相同时不绑定。
+// set_cpu_thread_affinity只作用于调用线程，但libuv/taskpool线程与OpenMP线程组在各任务之间共享，
+// 不恢复的话之后在这些线程上运行的其他任务也会留在该核心上。
+class ScopedBinding {
+public:
+    explicit ScopedBinding(int powersave);
+    ~ScopedBinding();
+
+    ScopedBinding(const ScopedBinding &) = delete;
+    ScopedBinding &operator=(const ScopedBinding &) = delete;
+
+private:
+    bool bound;
+};
+
+} // namespace corebinding
+
+#endif // CORE_BINDING_H
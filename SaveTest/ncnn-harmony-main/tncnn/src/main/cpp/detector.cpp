@@ -0,0 +1,145 @@
+#include "detector.h"
+#include "core_binding.h"
+#include <map>
+
+#include "hilog/log.h"
+
+#undef LOG_TAG
+#define LOG_TAG "Tncnn"
+
+namespace detector {
+
+static std::mutex g_registry_mutex;
+static std::map<int, std::weak_ptr<Instance>> g_registry;
+static int g_next_id = 1;
+
+bool is_nanodet(const std::string &model_type) { return model_type.compare(0, 7, "nanodet") == 0; }
+
+std::shared_ptr<Instance> create(const std::string &model_type, ncnn::Option option,
+                                 std::unique_ptr<modelloader::ModelData> model, int powersave) {
+    if (!model) {
+        return nullptr;
+    }
+
+    std::shared_ptr<Instance> instance(new Instance());
+    instance->model_type = model_type;
+    instance->latest_seq = 0;
+    instance->packed_results = false;
+    instance->threshold_generation = 0;
+    instance->powersave = powersave;
+
+    // 两个模型的init返回值约定不同：NanoDet成功返回1，YOLOv8失败返回0
+    bool ok = false;
+    if (is_nanodet(model_type)) {
+        instance->nanodet.reset(new nanodet::NanoDet());
+        ok = instance->nanodet->init(option, std::move(model), model_type.c_str()) != 0;
+    } else {
+        instance->yolov8.reset(new yolo::YOLOv8());
+        ok = instance->yolov8->init(option, std::move(model), model_type.c_str()) != 0;
+    }
+    if (!ok) {
+        OH_LOG_DEBUG(LogType::LOG_APP, "detector init fail:%{public}s", model_type.c_str());
+        return nullptr;
+    }
+
+    std::lock_guard<std::mutex> lock(g_registry_mutex);
+    // 顺便清理已释放的实例
+    for (auto it = g_registry.begin(); it != g_registry.end();) {
+        it = it->second.expired() ? g_registry.erase(it) : std::next(it);
+    }
+    instance->id = g_next_id++;
+    g_registry[instance->id] = instance;
+    OH_LOG_DEBUG(LogType::LOG_APP, "detector created id:%{public}d type:%{public}s, alive:%{public}zu",
+                 instance->id, model_type.c_str(), g_registry.size());
+    return instance;
+}
+
+std::shared_ptr<Instance> find(int id) {
+    std::lock_guard<std::mutex> lock(g_registry_mutex);
+    auto it = g_registry.find(id);
+    if (it == g_registry.end()) {
+        return nullptr;
+    }
+    return it->second.lock();
+}
+
+void unregister(int id) {
+    std::lock_guard<std::mutex> lock(g_registry_mutex);
+    g_registry.erase(id);
+}
+
+int class_count(const Instance &instance) {
+    return instance.nanodet ? instance.nanodet->class_count() : instance.yolov8->class_count();
+}
+
+void memory_stats(const Instance &instance, arena::Stats &out) {
+    if (instance.nanodet) {
+        instance.nanodet->memory_stats(out);
+    } else {
+        instance.yolov8->memory_stats(out);
+    }
+}
+
+unsigned int next_seq(Instance &instance) {
+    // 跳过0（表示不检查）
+    unsigned int seq = ++instance.latest_seq;
+    return seq != 0 ? seq : ++instance.latest_seq;
+}
+
+// 序号是否已被更新的任务取代
+static inline bool superseded(const Instance &instance, unsigned int seq) {
+    return seq != 0 && seq != instance.latest_seq.load();
+}
+
+Status run(Instance &instance, const unsigned char *rgba, int img_w, int img_h, Result &result, unsigned int seq) {
+    if (superseded(instance, seq)) {
+        return STATUS_SUPERSEDED;
+    }
+
+    std::lock_guard<std::mutex> lock(instance.mutex);
+    // 等待实例锁期间可能有新帧排队
+    if (superseded(instance, seq)) {
+        return STATUS_SUPERSEDED;
+    }
+
+    // 推理期间绑定到实例的核心，返回前恢复（推理线程由其他任务共享）
+    corebinding::ScopedBinding binding(instance.powersave);
+    ncnn::Mat input = ncnn::Mat(img_w, img_h, 4, (void *)rgba);
+    // assign复用result已有的容量，调用方跨帧复用result时拷贝结果不分配内存
+    if (instance.nanodet) {
+        const std::vector<nanodet::BoxInfo> &boxes = instance.nanodet->run(input, img_w, img_h,
+                                                                            instance.model_type.c_str());
+        result.nanodet_boxes.assign(boxes.begin(), boxes.end());
+        result.stages = instance.nanodet->stage_times();
+    } else {
+        const std::vector<yolo::BoxInfo> &boxes = instance.yolov8->run(input, img_w, img_h,
+                                                                        instance.model_type.c_str());
+        result.yolo_boxes.assign(boxes.begin(), boxes.end());
+        result.stages = instance.yolov8->stage_times();
+    }
+    return STATUS_OK;
+}
+
+Status run_nv21(Instance &instance, const unsigned char *nv21, int img_w, int img_h, int stride, int rotation,
+                Result &result, unsigned int seq) {
+    if (!instance.yolov8) {
+        return STATUS_NOT_READY;
+    }
+    if (superseded(instance, seq)) {
+        return STATUS_SUPERSEDED;
+    }
+
+    std::lock_guard<std::mutex> lock(instance.mutex);
+    if (superseded(instance, seq)) {
+        return STATUS_SUPERSEDED;
+    }
+
+    corebinding::ScopedBinding binding(instance.powersave);
+    const std::vector<yolo::BoxInfo> &boxes =
+        instance.yolov8->run_nv21(nv21, img_w, img_h, stride, rotation, instance.model_type.c_str());
+    result.yolo_boxes.assign(boxes.begin(), boxes.end());
+    result.stages = instance.yolov8->stage_times();
+    return STATUS_OK;
+}
+
+} // namespace detector
@@ -0,0 +1,79 @@
+#ifndef DETECTOR_H
+#define DETECTOR_H
+
+#include "model_loader.h"
+#include "nanodet.h"
+#include "yolov8.h"
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+
+namespace detector {
+
+// 检测器实例
+// 由shared_ptr管理生命周期：JS句柄、默认实例以及进行中的推理各持有一个引用，最后一个引用释放时销毁模型。
+// 同一实例的推理与阈值设置通过mutex串行执行，不同实例之间互不影响，可在多个taskpool线程并行推理。
+typedef struct Instance {
+    int id;                                    // 注册表中的编号（可跨线程传递）
+    std::string model_type;                    // 模型类型（"nanodet-m", "yolov8n"等）
+    std::mutex mutex;                          // 串行化该实例的推理
+    std::unique_ptr<yolo::YOLOv8> yolov8;      // YOLOv8模型（二者其一）
+    std::unique_ptr<nanodet::NanoDet> nanodet; // NanoDet模型
+    std::atomic<unsigned int> latest_seq;      // 最近一次排队的异步推理序号，用于丢弃被新帧取代的任务
+    std::atomic<bool> packed_results;          // 结果以打包的二进制记录返回（见napi_init.cpp），否则为对象数组
+    std::atomic<unsigned int> threshold_generation;  // 每次设置阈值后递增，推流据此丢弃按旧阈值识别的缓存结果
+    int powersave;                             // 推理时绑定的核心（同set_cpu_powersave：0全部，1小核，2大核），-1表示不绑定
+} Instance;
+
+// 识别状态
+enum Status {
+    STATUS_OK = 0,
+    STATUS_NOT_READY = 1,     // 实例为空或不支持该输入
+    STATUS_SUPERSEDED = 2     // 排队期间已有更新的帧，未执行
+};
+
+// 一次识别的结果（按实例类型二者其一）
+typedef struct Result {
+    std::vector<yolo::BoxInfo> yolo_boxes;
+    std::vector<nanodet::BoxInfo> nanodet_boxes;
+    netutils::StageTimes stages;    // 各阶段耗时
+    std::vector<int> track_ids;     // 跟踪ID，与yolo_boxes一一对应（推流开启跟踪时），否则为空
+} Result;
+
+// 是否为NanoDet模型类型
+bool is_nanodet(const std::string &model_type);
+
+// 创建并初始化实例，成功后登记到注册表；失败返回空
+// powersave: 每次run/run_nv21期间绑定推理线程，返回前恢复（见corebinding::ScopedBinding），
+// 不修改进程级的设置，不同实例可以使用不同的核心；-1表示不绑定
+std::shared_ptr<Instance> create(const std::string &model_type, ncnn::Option option,
+                                 std::unique_ptr<modelloader::ModelData> model, int powersave = -1);
+
+// 按编号查找实例，实例已释放时返回空
+// 注册表只保存弱引用，不延长实例的生命周期
+std::shared_ptr<Instance> find(int id);
+
+// 从注册表移除（之后无法再按编号查找，已持有的引用仍然有效）
+void unregister(int id);
+
+// 类别数量
+int class_count(const Instance &instance);
+
+// 推理blob的内存统计，可在推理进行中读取
+void memory_stats(const Instance &instance, arena::Stats &out);
+
+// 为异步推理分配序号，之前分配的序号随之过期
+unsigned int next_seq(Instance &instance);
+
+// 识别RGBA图像，同一实例的调用串行执行
+// seq: 异步推理的序号，取得实例锁时已过期则不执行并返回STATUS_SUPERSEDED；0表示不检查
+Status run(Instance &instance, const unsigned char *rgba, int img_w, int img_h, Result &result, unsigned int seq = 0);
+
+// 识别NV21相机帧（仅YOLOv8），参数含义同YOLOv8::run_nv21
+Status run_nv21(Instance &instance, const unsigned char *nv21, int img_w, int img_h, int stride, int rotation,
+                Result &result, unsigned int seq = 0);
+
+} // namespace detector
+
+#endif // DETECTOR_H
@@ -0,0 +1,149 @@
+#include "frame_queue.h"
+#include "benchmark.h"
+#include <chrono>
+#include <cstring>
+
+namespace framequeue {
+
+FrameRing::FrameRing(int slot_count, size_t slot_bytes)
+    : count(slot_count < 2 ? 2 : slot_count), bytes(slot_bytes), slots(new Slot[count]), next_seq(0),
+      is_stopped(false), waiting(false), pushed(0), dropped(0), rejected(0), taken(0) {
+    for (int i = 0; i < count; i++) {
+        slots[i].tag.store(make_tag(0, SLOT_FREE));
+        slots[i].data.resize(bytes);
+    }
+}
+
+bool FrameRing::push(const unsigned char *data, const FrameInfo &info) {
+    if (is_stopped.load() || info.size > bytes) {
+        rejected++;
+        return false;
+    }
+
+    // 选槽：优先空槽，否则覆盖序号最小（最旧）的就绪帧；消费者同时取走时CAS失败，重新选
+    int target = -1;
+    for (;;) {
+        uint64_t expected = 0;
+        int oldest = -1;
+        uint64_t oldest_tag = 0;
+        for (int i = 0; i < count; i++) {
+            uint64_t tag = slots[i].tag.load(std::memory_order_acquire);
+            if (tag_state(tag) == SLOT_FREE) {
+                target = i;
+                expected = tag;
+                break;
+            }
+            if (tag_state(tag) == SLOT_READY && (oldest < 0 || tag_seq(tag) < tag_seq(oldest_tag))) {
+                oldest = i;
+                oldest_tag = tag;
+            }
+        }
+        if (target < 0) {
+            target = oldest;
+            expected = oldest_tag;
+        }
+        if (target >= 0 && slots[target].tag.compare_exchange_strong(
+                               expected, make_tag(tag_seq(expected), SLOT_WRITING), std::memory_order_acq_rel)) {
+            if (tag_state(expected) == SLOT_READY) {
+                dropped++;
+            }
+            break;
+        }
+        target = -1;
+    }
+
+    Slot &slot = slots[target];
+    memcpy(slot.data.data(), data, info.size);
+    slot.info = info;
+    slot.info.seq = ++next_seq;
+    slot.info.time = ncnn::get_current_time();
+    // 与消费者的waiting为Dekker式同步，发布与检查都使用seq_cst
+    slot.tag.store(make_tag(slot.info.seq, SLOT_READY));
+    pushed++;
+
+    if (waiting.load()) {
+        // 加锁保证消费者已进入等待或能看到新帧，避免丢失唤醒
+        std::lock_guard<std::mutex> lock(mutex);
+        ready.notify_one();
+    }
+    return true;
+}
+
+bool FrameRing::has_ready() const {
+    for (int i = 0; i < count; i++) {
+        if (tag_state(slots[i].tag.load()) == SLOT_READY) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool FrameRing::take_newest(Frame &frame) {
+    int newest = -1;
+    uint64_t newest_tag = 0;
+    for (;;) {
+        newest = -1;
+        for (int i = 0; i < count; i++) {
+            uint64_t tag = slots[i].tag.load(std::memory_order_acquire);
+            if (tag_state(tag) == SLOT_READY && (newest < 0 || tag_seq(tag) > tag_seq(newest_tag))) {
+                newest = i;
+                newest_tag = tag;
+            }
+        }
+        if (newest < 0) {
+            return false;
+        }
+        if (slots[newest].tag.compare_exchange_strong(newest_tag, make_tag(tag_seq(newest_tag), SLOT_READING),
+                                                      std::memory_order_acq_rel)) {
+            break;
+        }
+    }
+
+    // 更旧的帧已无处理价值，直接回收
+    for (int i = 0; i < count; i++) {
+        uint64_t tag = slots[i].tag.load(std::memory_order_acquire);
+        if (i != newest && tag_state(tag) == SLOT_READY && tag_seq(tag) < tag_seq(newest_tag) &&
+            slots[i].tag.compare_exchange_strong(tag, make_tag(tag_seq(tag), SLOT_FREE), std::memory_order_acq_rel)) {
+            dropped++;
+        }
+    }
+
+    frame.data = slots[newest].data.data();
+    frame.info = slots[newest].info;
+    frame.slot = newest;
+    taken++;
+    return true;
+}
+
+bool FrameRing::acquire(Frame &frame, int timeout_ms) {
+    if (take_newest(frame)) {
+        return true;
+    }
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        waiting.store(true);
+        ready.wait_for(lock, std::chrono::milliseconds(timeout_ms),
+                       [this] { return is_stopped.load() || has_ready(); });
+        waiting.store(false);
+    }
+    return !is_stopped.load() && take_newest(frame);
+}
+
+void FrameRing::release(const Frame &frame) {
+    slots[frame.slot].tag.store(make_tag(frame.info.seq, SLOT_FREE), std::memory_order_release);
+}
+
+void FrameRing::stop() {
+    is_stopped.store(true);
+    std::lock_guard<std::mutex> lock(mutex);
+    ready.notify_all();
+}
+
+void FrameRing::stats(Stats &out) const {
+    out.pushed = pushed.load();
+    out.dropped = dropped.load();
+    out.rejected = rejected.load();
+    out.taken = taken.load();
+}
+
+} // namespace framequeue
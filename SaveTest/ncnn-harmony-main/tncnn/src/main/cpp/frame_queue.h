@@ -0,0 +1,114 @@
+#ifndef FRAME_QUEUE_H
+#define FRAME_QUEUE_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace framequeue {
+
+// 帧格式
+enum Format {
+    FORMAT_RGBA = 0,
+    FORMAT_NV21 = 1
+};
+
+// 帧描述，由生产者填写
+typedef struct FrameInfo {
+    int format;
+    int width;
+    int height;
+    int stride;         // 仅NV21，行跨度
+    int rotation;       // 仅NV21，顺时针旋转角度
+    size_t size;        // 数据字节数
+    unsigned int seq;   // 入队序号，由push分配，从1开始
+    double time;        // 入队时间（ncnn::get_current_time，毫秒）
+} FrameInfo;
+
+// 消费者取得的一帧，处理完后交还release
+typedef struct Frame {
+    const unsigned char *data;
+    FrameInfo info;
+    int slot;
+} Frame;
+
+// 计数
+typedef struct Stats {
+    uint64_t pushed;      // 入队帧数
+    uint64_t dropped;     // 未处理即被覆盖或被更新的帧取代的帧数
+    uint64_t rejected;    // 超出槽大小或已停止而未入队的帧数
+    uint64_t taken;       // 消费者取得的帧数
+} Stats;
+
+// 单生产者单消费者的帧环，槽大小固定，构造时一次分配
+// 生产者总是能写入：优先使用空槽，没有空槽时覆盖最旧的未取帧（消费者正在处理的槽除外）；
+// 消费者总是取最新的一帧，更旧的未取帧直接丢弃。
+// 槽的状态与序号合并在一个原子量中，两端都只做CAS，数据通路上没有锁；
+// mutex与条件变量只用于消费者在空环上休眠，生产者仅在消费者休眠时才加锁唤醒。
+class FrameRing {
+public:
+    // slot_count至少为2（消费者持有一个槽时生产者仍有槽可写）
+    FrameRing(int slot_count, size_t slot_bytes);
+
+    size_t slot_bytes() const { return bytes; }
+
+    // 生产者：拷贝一帧入队，info中的seq与time由此填写
+    bool push(const unsigned char *data, const FrameInfo &info);
+
+    // 消费者：取最新的一帧，无帧时最多等待timeout_ms；超时或已停止返回false
+    bool acquire(Frame &frame, int timeout_ms);
+
+    // 消费者：交还acquire取得的槽
+    void release(const Frame &frame);
+
+    // 停止：之后push失败，等待中的acquire立即返回
+    void stop();
+    bool stopped() const { return is_stopped.load(); }
+
+    void stats(Stats &out) const;
+
+private:
+    enum SlotState {
+        SLOT_FREE = 0,
+        SLOT_WRITING = 1,
+        SLOT_READY = 2,
+        SLOT_READING = 3
+    };
+
+    // 状态在低2位，序号在高位；CAS整个tag，避免槽被重写后误判（ABA）
+    static uint64_t make_tag(unsigned int seq, int state) { return ((uint64_t)seq << 2) | (uint64_t)state; }
+    static int tag_state(uint64_t tag) { return (int)(tag & 3); }
+    static unsigned int tag_seq(uint64_t tag) { return (unsigned int)(tag >> 2); }
+
+    // 取序号最大的就绪帧，并丢弃更旧的就绪帧
+    bool take_newest(Frame &frame);
+    bool has_ready() const;
+
+    typedef struct Slot {
+        std::atomic<uint64_t> tag;
+        FrameInfo info;
+        std::vector<unsigned char> data;
+    } Slot;
+
+    int count;
+    size_t bytes;
+    std::unique_ptr<Slot[]> slots;
+    unsigned int next_seq;                 // 仅生产者访问
+    std::atomic<bool> is_stopped;
+    std::atomic<bool> waiting;             // 消费者正在休眠
+    std::mutex mutex;
+    std::condition_variable ready;
+
+    std::atomic<uint64_t> pushed;
+    std::atomic<uint64_t> dropped;
+    std::atomic<uint64_t> rejected;
+    std::atomic<uint64_t> taken;
+};
+
+} // namespace framequeue
+
+#endif // FRAME_QUEUE_H
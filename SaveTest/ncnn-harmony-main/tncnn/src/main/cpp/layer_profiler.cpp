@@ -0,0 +1,213 @@
+#include "layer_profiler.h"
+#include "benchmark.h"
+#include "layer_type.h"
+#include <algorithm>
+#include <map>
+#include <sstream>
+
+#include "hilog/log.h"
+
+#undef LOG_TAG
+#define LOG_TAG "Tncnn"
+
+namespace profiler {
+
+// 计时层：对外表现为原来的层（相同的类型、名称、blob与各项support标记），forward转发并计时
+class TimingLayer : public ncnn::Layer {
+public:
+    TimingLayer(ncnn::Layer *inner, Profiler *profiler, int index) : inner(inner), profiler(profiler), index(index) {
+        one_blob_only = inner->one_blob_only;
+        support_inplace = inner->support_inplace;
+        support_vulkan = false;
+        support_packing = inner->support_packing;
+        support_bf16_storage = inner->support_bf16_storage;
+        support_fp16_storage = inner->support_fp16_storage;
+        support_int8_storage = inner->support_int8_storage;
+        support_image_storage = inner->support_image_storage;
+        support_tensor_storage = inner->support_tensor_storage;
+        featmask = inner->featmask;
+        userdata = inner->userdata;
+        // 保留原类型下标，但去掉自定义层标记，释放时由net直接delete
+        typeindex = inner->typeindex & ~ncnn::LayerType::CustomBit;
+        type = inner->type;
+        name = inner->name;
+        bottoms = inner->bottoms;
+        tops = inner->tops;
+        bottom_shapes = inner->bottom_shapes;
+        top_shapes = inner->top_shapes;
+    }
+
+    virtual ~TimingLayer() { delete inner; }
+
+    virtual int destroy_pipeline(const ncnn::Option &opt) { return inner->destroy_pipeline(opt); }
+
+    virtual int forward(const std::vector<ncnn::Mat> &bottom_blobs, std::vector<ncnn::Mat> &top_blobs,
+                        const ncnn::Option &opt) const {
+        double start = ncnn::get_current_time();
+        int ret = inner->forward(bottom_blobs, top_blobs, opt);
+        profiler->record(index, start, ncnn::get_current_time());
+        return ret;
+    }
+
+    virtual int forward(const ncnn::Mat &bottom_blob, ncnn::Mat &top_blob, const ncnn::Option &opt) const {
+        double start = ncnn::get_current_time();
+        int ret = inner->forward(bottom_blob, top_blob, opt);
+        profiler->record(index, start, ncnn::get_current_time());
+        return ret;
+    }
+
+    virtual int forward_inplace(std::vector<ncnn::Mat> &bottom_top_blobs, const ncnn::Option &opt) const {
+        double start = ncnn::get_current_time();
+        int ret = inner->forward_inplace(bottom_top_blobs, opt);
+        profiler->record(index, start, ncnn::get_current_time());
+        return ret;
+    }
+
+    virtual int forward_inplace(ncnn::Mat &bottom_top_blob, const ncnn::Option &opt) const {
+        double start = ncnn::get_current_time();
+        int ret = inner->forward_inplace(bottom_top_blob, opt);
+        profiler->record(index, start, ncnn::get_current_time());
+        return ret;
+    }
+
+private:
+    ncnn::Layer *inner;
+    Profiler *profiler;
+    int index;
+};
+
+Profiler::Profiler() : tracing(false), trace_origin(0) {}
+
+void Profiler::attach(ncnn::Net &net) {
+    std::vector<ncnn::Layer *> &net_layers = net.mutable_layers();
+    std::lock_guard<std::mutex> lock(mutex);
+    layers.resize(net_layers.size());
+    for (size_t i = 0; i < net_layers.size(); i++) {
+        layers[i].name = net_layers[i]->name;
+        layers[i].type = net_layers[i]->type;
+        layers[i].count = 0;
+        layers[i].total = 0;
+        layers[i].max = 0;
+        net_layers[i] = new TimingLayer(net_layers[i], this, (int)i);
+    }
+    OH_LOG_DEBUG(LogType::LOG_APP, "profiler attached %{public}zu layers", layers.size());
+}
+
+void Profiler::reset() {
+    std::lock_guard<std::mutex> lock(mutex);
+    for (auto &layer : layers) {
+        layer.count = 0;
+        layer.total = 0;
+        layer.max = 0;
+    }
+    events.clear();
+}
+
+void Profiler::set_tracing(bool enable) {
+    std::lock_guard<std::mutex> lock(mutex);
+    tracing = enable;
+    if (enable) {
+        events.clear();
+        trace_origin = ncnn::get_current_time();
+    }
+}
+
+void Profiler::record(int layer, double start, double end) {
+    std::lock_guard<std::mutex> lock(mutex);
+    LayerInfo &info = layers[layer];
+    double duration = end - start;
+    info.count++;
+    info.total += duration;
+    info.max = std::max(info.max, duration);
+    if (tracing) {
+        events.push_back({layer, start - trace_origin, duration});
+    }
+}
+
+static void sort_and_trim(std::vector<LayerStat> &stats, int top_n) {
+    std::sort(stats.begin(), stats.end(), [](const LayerStat &a, const LayerStat &b) { return a.total > b.total; });
+    if (top_n > 0 && (int)stats.size() > top_n) {
+        stats.resize(top_n);
+    }
+}
+
+std::vector<LayerStat> Profiler::by_name(int top_n) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    std::vector<LayerStat> stats;
+    stats.reserve(layers.size());
+    for (const auto &layer : layers) {
+        if (layer.count > 0) {
+            stats.push_back({layer.name, layer.type, layer.count, layer.total, layer.max});
+        }
+    }
+    sort_and_trim(stats, top_n);
+    return stats;
+}
+
+std::vector<LayerStat> Profiler::by_type(int top_n) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    std::map<std::string, LayerStat> types;
+    for (const auto &layer : layers) {
+        if (layer.count == 0) {
+            continue;
+        }
+        LayerStat &stat = types[layer.type];
+        stat.type = layer.type;
+        stat.count += layer.count;
+        stat.total += layer.total;
+        stat.max = std::max(stat.max, layer.max);
+    }
+    std::vector<LayerStat> stats;
+    for (const auto &it : types) {
+        stats.push_back(it.second);
+    }
+    sort_and_trim(stats, top_n);
+    return stats;
+}
+
+double Profiler::total() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    double total = 0;
+    for (const auto &layer : layers) {
+        total += layer.total;
+    }
+    return total;
+}
+
+// JSON字符串转义（层名来自.param，通常只有字母数字与符号）
+static void write_json_string(std::ostringstream &out, const std::string &text) {
+    out << '"';
+    for (char c : text) {
+        if (c == '"' || c == '\\') {
+            out << '\\' << c;
+        } else if ((unsigned char)c < 0x20) {
+            out << ' ';
+        } else {
+            out << c;
+        }
+    }
+    out << '"';
+}
+
+std::string Profiler::chrome_trace() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    std::ostringstream json;
+    json.setf(std::ios::fixed);
+    json.precision(1);
+    json << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    for (size_t i = 0; i < events.size(); i++) {
+        const TraceEvent &event = events[i];
+        const LayerInfo &layer = layers[event.layer];
+        json << (i == 0 ? "" : ",") << "\n{\"name\":";
+        write_json_string(json, layer.name);
+        json << ",\"cat\":";
+        write_json_string(json, layer.type);
+        // trace的时间单位为微秒
+        json << ",\"ph\":\"X\",\"pid\":1,\"tid\":1,\"ts\":" << event.start * 1000 << ",\"dur\":" << event.duration * 1000
+             << "}";
+    }
+    json << "]}";
+    return json.str();
+}
+
+} // namespace profiler
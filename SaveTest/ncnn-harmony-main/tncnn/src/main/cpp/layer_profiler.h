@@ -0,0 +1,74 @@
+#ifndef LAYER_PROFILER_H
+#define LAYER_PROFILER_H
+
+#include "net.h"
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace profiler {
+
+// 按层名或层类型汇总的耗时（毫秒）
+typedef struct LayerStat {
+    std::string name;      // 层名（按类型汇总时为空）
+    std::string type;
+    int count;             // forward次数
+    double total;
+    double max;
+} LayerStat;
+
+// 一次forward的记录，时间相对于trace开始（毫秒）
+typedef struct TraceEvent {
+    int layer;
+    double start;
+    double duration;
+} TraceEvent;
+
+// 逐层计时
+// attach用计时层替换net中的所有层（需在load_model之后，仅CPU推理），计时层转发到原来的层并记录耗时，
+// 原来的层由计时层持有，随net一起释放。
+class Profiler {
+public:
+    Profiler();
+
+    void attach(ncnn::Net &net);
+    bool attached() const { return !layers.empty(); }
+
+    // 清空统计（如预热结束后）
+    void reset();
+
+    // 开启后记录每次forward的事件，用于生成Chrome trace；重新开启时清空已有事件
+    void set_tracing(bool enable);
+
+    // 由计时层调用
+    void record(int layer, double start, double end);
+
+    // 按总耗时降序，top_n<=0时返回全部
+    std::vector<LayerStat> by_name(int top_n) const;
+    std::vector<LayerStat> by_type(int top_n) const;
+
+    // 所有层的总耗时
+    double total() const;
+
+    // Chrome trace格式（chrome://tracing 或 Perfetto 打开）
+    std::string chrome_trace() const;
+
+private:
+    typedef struct LayerInfo {
+        std::string name;
+        std::string type;
+        int count;
+        double total;
+        double max;
+    } LayerInfo;
+
+    mutable std::mutex mutex;
+    std::vector<LayerInfo> layers;   // 下标同net.layers()
+    bool tracing;
+    double trace_origin;
+    std::vector<TraceEvent> events;
+};
+
+} // namespace profiler
+
+#endif // LAYER_PROFILER_H
@@ -0,0 +1,166 @@
+#include "model_loader.h"
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <sstream>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "hilog/log.h"
+
+#undef LOG_TAG
+#define LOG_TAG "Tncnn"
+
+namespace modelloader {
+
+MappedFile::MappedFile() : map_base(nullptr), map_length(0), ptr(nullptr), length(0) {}
+
+MappedFile::~MappedFile() { release(); }
+
+void MappedFile::release() {
+    if (map_base != nullptr) {
+        munmap(map_base, map_length);
+        map_base = nullptr;
+        map_length = 0;
+    }
+    std::vector<unsigned char>().swap(copy);
+    ptr = nullptr;
+    length = 0;
+}
+
+unsigned char *MappedFile::allocate(size_t length) {
+    release();
+    copy.resize(length);
+    this->ptr = copy.data();
+    this->length = length;
+    return copy.data();
+}
+
+bool MappedFile::map_fd(int fd, long offset, long length) {
+    release();
+    if (fd < 0 || offset < 0 || length <= 0) {
+        return false;
+    }
+
+    // mmap的偏移必须按页对齐
+    long page_size = sysconf(_SC_PAGESIZE);
+    long aligned_offset = offset & ~(page_size - 1);
+    size_t delta = (size_t)(offset - aligned_offset);
+    void *base = mmap(nullptr, length + delta, PROT_READ, MAP_PRIVATE, fd, aligned_offset);
+    if (base == MAP_FAILED) {
+        OH_LOG_DEBUG(LogType::LOG_APP, "mmap failed, errno:%{public}d", errno);
+
+        // 退回到读取
+        if (pread(fd, allocate(length), length, offset) != length) {
+            release();
+            return false;
+        }
+        return true;
+    }
+
+    const unsigned char *data = (const unsigned char *)base + delta;
+    if (((uintptr_t)data & 3) != 0) {
+        // load_model要求4字节对齐
+        OH_LOG_DEBUG(LogType::LOG_APP, "mapped data not 4-byte aligned, copying");
+        memcpy(allocate(length), data, length);
+        munmap(base, length + delta);
+        return true;
+    }
+
+    madvise(base, length + delta, MADV_WILLNEED);
+    map_base = base;
+    map_length = length + delta;
+    this->ptr = data;
+    this->length = length;
+    return true;
+}
+
+bool MappedFile::map_file(const char *path) {
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat st;
+    bool ok = fstat(fd, &st) == 0 && map_fd(fd, 0, (long)st.st_size);
+    close(fd);
+    return ok;
+}
+
+static bool read_text_file(const char *path, std::string &text) {
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        return false;
+    }
+    std::stringstream buffer;
+    buffer << file.rdbuf();
+    text = buffer.str();
+    return true;
+}
+
+bool read_rawfile_text(const NativeResourceManager *mgr, const char *name, std::string &text) {
+    RawFile *raw_file = OH_ResourceManager_OpenRawFile(mgr, name);
+    if (raw_file == nullptr) {
+        return false;
+    }
+    long len = OH_ResourceManager_GetRawFileSize(raw_file);
+    text.resize(len > 0 ? len : 0);
+    int n = len > 0 ? OH_ResourceManager_ReadRawFile(raw_file, &text[0], len) : 0;
+    OH_ResourceManager_CloseRawFile(raw_file);
+    return n == len;
+}
+
+bool ModelData::load_files(const char *param_path, const char *bin_path) {
+    if (!read_text_file(param_path, param)) {
+        OH_LOG_DEBUG(LogType::LOG_APP, "%{public}s open fail", param_path);
+        return false;
+    }
+    if (!read_text_file((std::string(param_path) + ".meta").c_str(), meta)) {
+        meta.clear();
+    }
+    if (!bin.map_file(bin_path)) {
+        OH_LOG_DEBUG(LogType::LOG_APP, "%{public}s map fail", bin_path);
+        return false;
+    }
+    return true;
+}
+
+bool ModelData::load_rawfile(const NativeResourceManager *mgr, const char *param_name, const char *bin_name) {
+    if (mgr == nullptr || !read_rawfile_text(mgr, param_name, param)) {
+        OH_LOG_DEBUG(LogType::LOG_APP, "%{public}s open fail", param_name);
+        return false;
+    }
+    if (!read_rawfile_text(mgr, (std::string(param_name) + ".meta").c_str(), meta)) {
+        meta.clear();
+    }
+
+    RawFile *raw_file = OH_ResourceManager_OpenRawFile(mgr, bin_name);
+    if (raw_file == nullptr) {
+        OH_LOG_DEBUG(LogType::LOG_APP, "%{public}s open fail", bin_name);
+        return false;
+    }
+
+    // 未压缩的rawfile可通过hap文件描述符直接映射
+    bool ok = false;
+    RawFileDescriptor descriptor;
+    if (OH_ResourceManager_GetRawFileDescriptor(raw_file, descriptor)) {
+        ok = bin.map_fd(descriptor.fd, descriptor.start, descriptor.length);
+        OH_ResourceManager_ReleaseRawFileDescriptor(descriptor);
+    }
+    if (!ok) {
+        long len = OH_ResourceManager_GetRawFileSize(raw_file);
+        ok = len > 0 && OH_ResourceManager_ReadRawFile(raw_file, bin.allocate(len), len) == len;
+        if (!ok) {
+            bin.release();
+        }
+    }
+    OH_ResourceManager_CloseRawFile(raw_file);
+
+    OH_LOG_DEBUG(LogType::LOG_APP, "%{public}s size:%{public}zu mapped:%{public}d", bin_name, bin.size(),
+                 bin.mapped());
+    return ok;
+}
+
+} // namespace modelloader
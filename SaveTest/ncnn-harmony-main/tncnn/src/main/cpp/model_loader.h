@@ -0,0 +1,65 @@
+#ifndef MODEL_LOADER_H
+#define MODEL_LOADER_H
+
+#include <rawfile/raw_file_manager.h>
+#include <string>
+#include <vector>
+
+namespace modelloader {
+
+// 只读映射的文件区域
+// 映射失败或映射地址不满足4字节对齐（ncnn::Net::load_model(const unsigned char*) 的要求）时退回到对齐的堆拷贝
+class MappedFile {
+public:
+    MappedFile();
+    ~MappedFile();
+
+    // 映射整个文件
+    bool map_file(const char *path);
+
+    // 映射描述符中 [offset, offset + length) 的区域（rawfile在hap中未压缩时的位置）
+    bool map_fd(int fd, long offset, long length);
+
+    // 释放已有内容并分配length字节的对齐缓冲区，用于无法映射时读入数据
+    unsigned char *allocate(size_t length);
+
+    // 解除映射并释放拷贝
+    void release();
+
+    const unsigned char *data() const { return ptr; }
+    size_t size() const { return length; }
+    bool mapped() const { return map_base != nullptr; }
+
+private:
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    void *map_base;
+    size_t map_length;
+    const unsigned char *ptr;
+    size_t length;
+    std::vector<unsigned char> copy;
+};
+
+// 一个模型的文件内容
+// param与meta文本很小，拷贝为以NUL结尾的字符串供 load_param_mem 使用；bin为映射，权重在原地引用，
+// 因此必须在ncnn::Net释放之后才能销毁
+class ModelData {
+public:
+    // 从文件系统加载（param_path为空时失败，meta可选为 <param_path>.meta）
+    bool load_files(const char *param_path, const char *bin_path);
+
+    // 从rawfile加载，name为rawfile内的相对路径（如 "models/yolov8n.param"）
+    bool load_rawfile(const NativeResourceManager *mgr, const char *param_name, const char *bin_name);
+
+    std::string param;   // .param文本
+    std::string meta;    // 可选的.meta文本，不存在时为空
+    MappedFile bin;      // .bin内容
+};
+
+// 读取rawfile全部内容为字符串，不存在时返回false
+bool read_rawfile_text(const NativeResourceManager *mgr, const char *name, std::string &text);
+
+} // namespace modelloader
+
+#endif // MODEL_LOADER_H
@@ -1,4 +1,6 @@
 #include "nanodet.h"
+#include "benchmark.h"
+#include "simd_math.h"
 #include <map>
 
 #include "hilog/log.h"
@@ -8,39 +10,35 @@
 
 namespace nanodet {
 
-inline float fast_exp(float x) {
-    union {
-        uint32_t i;
-        float f;
-    } v{};
-    v.i = (1 << 23) * (1.4426950409 * x + 126.93490512f);
-    return v.f;
+NanoDet::NanoDet() {
+    plan.input_blob = -1;
+    stages = netutils::StageTimes();
 }
 
-inline float sigmoid(float x) { return 1.0f / (1.0f + fast_exp(-x)); }
-
-template <typename _Tp> int activation_function_softmax(const _Tp *src, _Tp *dst, int length) {
-    const _Tp alpha = *std::max_element(src, src + length);
-    _Tp denominator{0};
+NanoDet::~NanoDet() { net.clear(); }
 
-    for (int i = 0; i < length; ++i) {
-        dst[i] = fast_exp(src[i] - alpha);
-        denominator += dst[i];
-    }
+int NanoDet::init(ncnn::Option option, const char *param, const char *model, const char *modeltype) {
+    OH_LOG_DEBUG(LogType::LOG_APP, "load param:%{public}s", param);
+    OH_LOG_DEBUG(LogType::LOG_APP, "load bin:%{public}s", model);
 
-    for (int i = 0; i < length; ++i) {
-        dst[i] /= denominator;
+    std::unique_ptr<modelloader::ModelData> data(new modelloader::ModelData());
+    if (!data->load_files(param, model)) {
+        return 0;
     }
-
-    return 0;
+    return init(option, std::move(data), modeltype);
 }
 
-NanoDet::NanoDet() {}
-
-NanoDet::~NanoDet() { net.clear(); }
-
-int NanoDet::init(ncnn::Option option, const char *param, const char *model, const char *modeltype) {
+int NanoDet::init(ncnn::Option option, std::unique_ptr<modelloader::ModelData> model, const char *modeltype) {
     net.opt = option;
+    // option未指定分配器时使用检测器自有的内存池，预热后blob与workspace不再分配堆内存
+    // 开启mempool时，加载期间转换的权重常驻blob内存池，推理的blob改用按帧重置的arena（在init末尾切换）
+    use_arena = net.opt.use_local_pool_allocator && net.opt.blob_allocator == nullptr;
+    if (net.opt.blob_allocator == nullptr) {
+        net.opt.blob_allocator = &blob_pool_allocator;
+    }
+    if (net.opt.workspace_allocator == nullptr) {
+        net.opt.workspace_allocator = &workspace_pool_allocator;
+    }
 
     const std::map<std::string, int> _target_sizes = {
         {"nanodet-m", 320},
@@ -62,60 +60,103 @@ int NanoDet::init(ncnn::Option option, const char *param, const char *model, con
     norm_vals[1] = _norm_vals.at(modeltype)[1];
     norm_vals[2] = _norm_vals.at(modeltype)[2];
 
-    OH_LOG_DEBUG(LogType::LOG_APP, "load param:%{public}s", param);
-    OH_LOG_DEBUG(LogType::LOG_APP, "load bin:%{public}s", model);
-
     int pr, mr;
-//     pr = net.load_param_mem(param); // 加载 content 的
-    pr = net.load_param(param);
-    mr = net.load_model(model);
+    model_data = std::move(model);
+    pr = net.load_param_mem(model_data->param.c_str());
+    mr = pr == 0 && net.load_model(model_data->bin.data()) > 0 ? 0 : -1;
 
     if (pr != 0 || mr != 0) {
         OH_LOG_DEBUG(LogType::LOG_APP, "load param:%{public}d, load model:%{public}d", pr, mr);
-    } else {
-        OH_LOG_DEBUG(LogType::LOG_APP, "load success");
+        return 0;
+    }
+    OH_LOG_DEBUG(LogType::LOG_APP, "load success");
+
+    // 解析输入与检测头blob
+    static const char *input_candidates[] = {"input.1"};
+    plan.input_blob = netutils::resolve_blob_index(net, input_candidates, 1, net.input_indexes());
+    plan.cls_blobs.clear();
+    plan.dis_blobs.clear();
+    for (const auto &head_info : heads_info) {
+        int cls_blob = netutils::find_blob_index(net, head_info.cls_layer.c_str());
+        int dis_blob = netutils::find_blob_index(net, head_info.dis_layer.c_str());
+        if (cls_blob < 0 || dis_blob < 0) {
+            OH_LOG_DEBUG(LogType::LOG_APP, "head blob not found: %{public}s %{public}s", head_info.cls_layer.c_str(),
+                         head_info.dis_layer.c_str());
+            return 0;
+        }
+        plan.cls_blobs.push_back(cls_blob);
+        plan.dis_blobs.push_back(dis_blob);
+    }
+    if (plan.input_blob < 0) {
+        OH_LOG_DEBUG(LogType::LOG_APP, "input blob not found");
+        return 0;
     }
-    return (pr == 0) && (mr == 0);
+
+    plan.input.create(target_size, target_size, 3);
+    plan.cls_preds.resize(heads_info.size());
+    plan.dis_preds.resize(heads_info.size());
+
+    // 之后extractor创建的blob都来自arena，每帧开始时整块回收
+    if (use_arena) {
+        net.opt.blob_allocator = &blob_arena;
+    }
+    return 1;
 }
 
 
-std::vector<BoxInfo> NanoDet::run(ncnn::Mat &data, int img_w, int img_h, const char *modeltype) {
+const std::vector<BoxInfo> &NanoDet::run(ncnn::Mat &data, int img_w, int img_h, const char *modeltype) {
+    results.clear();
+    if (plan.input.empty()) {
+        return results;
+    }
+
     float width_ratio = (float)img_w / (float)target_size;
     float height_ratio = (float)img_h / (float)target_size;
 
-    ncnn::Mat resize_input =
-        ncnn::Mat::from_pixels_resize(data, ncnn::Mat::PIXEL_RGBA2BGR, img_w, img_h, target_size, target_size);
+    // RGBA转BGR、拉伸缩放与归一化一次完成，直接写入常驻输入
+    double start = ncnn::get_current_time();
+    resizer.prepare(img_w, img_h, 4, target_size, target_size);
+    resizer.run((const unsigned char *)data.data, img_w * 4, plan.input, 0, 0, mean_vals, norm_vals, true);
+    stages.convert = 0;
+    stages.resize = ncnn::get_current_time() - start;
+    stages.normalize = 0;
+    stages.forward = 0;
+    stages.decode = 0;
+
+    // 上一帧的extractor已析构，释放保留的输出后回收arena
+    if (use_arena) {
+        for (size_t i = 0; i < plan.cls_preds.size(); i++) {
+            plan.cls_preds[i].release();
+            plan.dis_preds[i].release();
+        }
+        blob_arena.reset();
+    }
 
-    resize_input.substract_mean_normalize(mean_vals, norm_vals);
-    
     ncnn::Extractor ex = net.create_extractor();
-    ex.input("input.1", resize_input);
-    std::vector<std::vector<BoxInfo>> results;
-    results.resize(this->num_class);
-
-    for (const auto &head_info : this->heads_info) {
-        ncnn::Mat dis_pred;
-        ncnn::Mat cls_pred;
-        ex.extract(head_info.dis_layer.c_str(), dis_pred);
-        ex.extract(head_info.cls_layer.c_str(), cls_pred);
-
-        decode_infer(cls_pred, dis_pred, head_info.stride, 0.3f, results, width_ratio, height_ratio);
+    ex.input(plan.input_blob, plan.input);
+
+    // 各检测头按需推理，推理与解码交替进行，分别累计
+    for (int i = 0; i < (int)heads_info.size(); i++) {
+        double forward_start = ncnn::get_current_time();
+        ex.extract(plan.dis_blobs[i], plan.dis_preds[i]);
+        ex.extract(plan.cls_blobs[i], plan.cls_preds[i]);
+        double decode_start = ncnn::get_current_time();
+
+        decode_infer(plan.cls_preds[i], plan.dis_preds[i], heads_info[i].stride, 0.3f, results, width_ratio,
+                     height_ratio);
+        stages.forward += decode_start - forward_start;
+        stages.decode += ncnn::get_current_time() - decode_start;
     }
 
-    std::vector<BoxInfo> dets;
-    for (int i = 0; i < (int)results.size(); i++) {
-        nms(results[i], 0.7f);
-
-        for (auto box : results[i]) {
-            dets.push_back(box);
-        }
-    }
-    return dets;
+    double nms_start = ncnn::get_current_time();
+    nms(results, 0.7f);
+    stages.nms = ncnn::get_current_time() - nms_start;
+    return results;
 }
 
 
 void NanoDet::decode_infer(ncnn::Mat &cls_pred, ncnn::Mat &dis_pred, int stride, float threshold,
-                           std::vector<std::vector<BoxInfo>> &results, float width_ratio, float height_ratio) {
+                           std::vector<BoxInfo> &results, float width_ratio, float height_ratio) {
     int feature_h = target_size / stride;
     int feature_w = target_size / stride;
 
@@ -135,7 +176,7 @@ void NanoDet::decode_infer(ncnn::Mat &cls_pred, ncnn::Mat &dis_pred, int stride,
         if (score > threshold) {
             // std::cout << "label:" << cur_label << " score:" << score << std::endl;
             const float *bbox_pred = dis_pred.row(idx);
-            results[cur_label].push_back(
+            results.push_back(
                 this->disPred2Bbox(bbox_pred, cur_label, score, col, row, stride, width_ratio, height_ratio));
             // debug_heatmap.at<cv::Vec3b>(row, col)[0] = 255;
             // cv::imshow("debug", debug_heatmap);
@@ -147,19 +188,10 @@ BoxInfo NanoDet::disPred2Bbox(const float *&dfl_det, int label, float score, int
                               float width_ratio, float height_ratio) {
     float ct_x = (x + 0.5) * stride;
     float ct_y = (y + 0.5) * stride;
-    std::vector<float> dis_pred;
-    dis_pred.resize(4);
+    // 每条边的分布取softmax期望，直接在输出上计算，不需要临时缓冲区
+    float dis_pred[4];
     for (int i = 0; i < 4; i++) {
-        float dis = 0;
-        float *dis_after_sm = new float[reg_max + 1];
-        activation_function_softmax(dfl_det + i * (reg_max + 1), dis_after_sm, reg_max + 1);
-        for (int j = 0; j < reg_max + 1; j++) {
-            dis += j * dis_after_sm[j];
-        }
-        dis *= stride;
-        // std::cout << "dis:" << dis << std::endl;
-        dis_pred[i] = dis;
-        delete[] dis_after_sm;
+        dis_pred[i] = simd::softmax_expectation(dfl_det + i * (reg_max + 1), reg_max + 1) * stride;
     }
     float xmin = (std::max)(ct_x - dis_pred[0], .0f) * width_ratio;
     float ymin = (std::max)(ct_y - dis_pred[1], .0f) * height_ratio;
@@ -171,30 +203,29 @@ BoxInfo NanoDet::disPred2Bbox(const float *&dfl_det, int label, float score, int
 }
 
 void NanoDet::nms(std::vector<BoxInfo> &input_boxes, float NMS_THRESH) {
-    std::sort(input_boxes.begin(), input_boxes.end(), [](BoxInfo a, BoxInfo b) { return a.score > b.score; });
-    std::vector<float> vArea(input_boxes.size());
-    for (int i = 0; i < int(input_boxes.size()); ++i) {
-        vArea[i] =
-            (input_boxes.at(i).x2 - input_boxes.at(i).x1 + 1) * (input_boxes.at(i).y2 - input_boxes.at(i).y1 + 1);
+    if (input_boxes.empty()) {
+        return;
     }
-    for (int i = 0; i < int(input_boxes.size()); ++i) {
-        for (int j = i + 1; j < int(input_boxes.size());) {
-            float xx1 = (std::max)(input_boxes[i].x1, input_boxes[j].x1);
-            float yy1 = (std::max)(input_boxes[i].y1, input_boxes[j].y1);
-            float xx2 = (std::min)(input_boxes[i].x2, input_boxes[j].x2);
-            float yy2 = (std::min)(input_boxes[i].y2, input_boxes[j].y2);
-            float w = (std::max)(float(0), xx2 - xx1 + 1);
-            float h = (std::max)(float(0), yy2 - yy1 + 1);
-            float inter = w * h;
-            float ovr = inter / (vArea[i] + vArea[j] - inter);
-            if (ovr >= NMS_THRESH) {
-                input_boxes.erase(input_boxes.begin() + j);
-                vArea.erase(vArea.begin() + j);
-            } else {
-                j++;
-            }
-        }
+
+    nms_solver.clear();
+    nms_solver.reserve((int)input_boxes.size());
+    for (const BoxInfo &box : input_boxes) {
+        nms_solver.add(box.x1, box.y1, box.x2, box.y2, box.score, box.label);
+    }
+
+    // 面积按像素包含式计算（宽高 +1）
+    nms::Params params;
+    params.iou_threshold = NMS_THRESH;
+    params.mode = nms::MODE_CLASS_AWARE;
+    params.coord_offset = 1.f;
+    const std::vector<int> &keep = nms_solver.run(params);
+
+    // 两个缓冲区交替使用
+    kept_boxes.clear();
+    for (int idx : keep) {
+        kept_boxes.push_back(input_boxes[idx]);
     }
+    input_boxes.swap(kept_boxes);
 }
 
 } // namespace nanodet
@@ -1,7 +1,13 @@
 #ifndef NANODET_H
 #define NANODET_H
 
+#include "arena_allocator.h"
+#include "model_loader.h"
 #include "net.h"
+#include "net_utils.h"
+#include "nms.h"
+#include "preprocess.h"
+#include <memory>
 #include <string>
 
 namespace nanodet {
@@ -12,6 +18,16 @@ typedef struct HeadInfo {
     int stride;
 } HeadInfo;
 
+// 推理计划：init时解析输入与各检测头的blob下标，run时按下标直接输入与提取
+typedef struct InferencePlan {
+    int input_blob;
+    std::vector<int> cls_blobs;      // 与heads_info一一对应
+    std::vector<int> dis_blobs;
+    ncnn::Mat input;                 // 常驻网络输入（target_size x target_size x 3）
+    std::vector<ncnn::Mat> cls_preds;
+    std::vector<ncnn::Mat> dis_preds;
+} InferencePlan;
+
 typedef struct BoxInfo {
     float x1;
     float y1;
@@ -29,18 +45,36 @@ public:
 
     
     int init(ncnn::Option option, const char *param, const char *model, const char *modeltype);
-    std::vector<BoxInfo> run(ncnn::Mat &data, int img_w, int img_h, const char *modeltype);
+    int init(ncnn::Option option, std::unique_ptr<modelloader::ModelData> model, const char *modeltype);
+    // 返回的结果由NanoDet持有，下次推理前有效（结果缓冲区跨帧复用，预热后解码与NMS不再分配内存）
+    const std::vector<BoxInfo> &run(ncnn::Mat &data, int img_w, int img_h, const char *modeltype);
+
+    // 类别数量（COCO 80类）
+    int class_count() const { return num_class; }
+
+    // 推理blob的内存统计（未使用arena时全部为0）
+    void memory_stats(arena::Stats &out) const { blob_arena.stats(out); }
+
+    // 最近一次推理各阶段的耗时
+    const netutils::StageTimes &stage_times() const { return stages; }
 
 private:
     void decode_infer(ncnn::Mat &cls_pred, ncnn::Mat &dis_pred, int stride, float threshold,
-                      std::vector<std::vector<BoxInfo>> &results, float width_ratio, float height_ratio);
+                      std::vector<BoxInfo> &results, float width_ratio, float height_ratio);
 
     BoxInfo disPred2Bbox(const float *&dfl_det, int label, float score, int x, int y, int stride, float width_ratio,
                          float height_ratio);
 
-    static void nms(std::vector<BoxInfo> &result, float nms_threshold);
+    void nms(std::vector<BoxInfo> &result, float nms_threshold);
+
+    // 自有分配器（option未指定时使用；arena仅在开启mempool时使用），需在net与plan之后析构
+    ncnn::UnlockedPoolAllocator blob_pool_allocator;
+    ncnn::PoolAllocator workspace_pool_allocator;
+    arena::ArenaAllocator blob_arena;
+    bool use_arena = false;       // 推理blob是否来自blob_arena
 
     ncnn::Net net;
+    std::unique_ptr<modelloader::ModelData> model_data;
     int target_size = 320;
     float mean_vals[3];
     float norm_vals[3];
@@ -52,6 +86,12 @@ private:
         {"814", "817", 16},
         {"836", "839", 32},
     };
+    InferencePlan plan;
+    netutils::StageTimes stages;      // 最近一次推理各阶段的耗时
+    std::vector<BoxInfo> results;     // 解码与NMS后的结果（复用）
+    std::vector<BoxInfo> kept_boxes;  // NMS保留结果的交替缓冲区
+    preprocess::ResizeNormalizer resizer;
+    nms::NmsSolver nms_solver;
 };
 
 } // namespace nanodet
@@ -1,7 +1,12 @@
 #include "c_api.h"
 #include "napi/native_api.h"
+#include <cstdio>
 #include <cstring>
+#include <fstream>
 #include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
 #include <rawfile/raw_file.h>
 #include <rawfile/raw_file_manager.h>
 #include "platform.h"
@@ -9,7 +14,16 @@
 // #include "yolov4.h"  // YOLOv4已移除，只使用YOLOv8
 #include "nanodet.h"
 #include "yolov8.h"
+#include "detector.h"
 #include "benchmark_ncnn.h"
+#include "model_loader.h"
+#include "autotune.h"
+#include "frame_queue.h"
+#include "pipeline.h"
+#include "batch.h"
+#include "scene_gate.h"
+#include "tracker.h"
+#include "core_binding.h"
 
 #include "hilog/log.h"
 
@@ -20,8 +34,33 @@
     { name, nullptr, func, nullptr, nullptr, nullptr, napi_default, nullptr }
 
 // static yolo::YOLOv4 *g_yolov4 = nullptr;  // YOLOv4已移除
-static nanodet::NanoDet *g_nanodet = nullptr;
-static yolo::YOLOv8 *g_yolov8 = nullptr;
+// 旧接口（nanodet_init / yolov8_init）使用的默认实例
+// 重新初始化只替换指针，正在推理的旧实例由推理方持有的引用保活，推理结束后才销毁
+static std::mutex g_default_mutex;
+static std::shared_ptr<detector::Instance> g_nanodet;
+static std::shared_ptr<detector::Instance> g_yolov8;
+
+/**
+ * 读取默认实例（返回的引用在推理期间保持实例存活）
+ */
+static std::shared_ptr<detector::Instance> get_default_instance(const std::shared_ptr<detector::Instance> &slot) {
+    std::lock_guard<std::mutex> lock(g_default_mutex);
+    return slot;
+}
+
+/**
+ * 替换默认实例，旧实例在锁外释放
+ */
+static void set_default_instance(std::shared_ptr<detector::Instance> &slot,
+                                 std::shared_ptr<detector::Instance> instance) {
+    {
+        std::lock_guard<std::mutex> lock(g_default_mutex);
+        slot.swap(instance);
+    }
+    if (instance) {
+        detector::unregister(instance->id);
+    }
+}
 
 /**
  * 从 napi 转换字符串到 cpp
@@ -39,41 +78,48 @@ static std::string value_to_string(napi_env env, napi_value value) {
 }
 
 /**
- * 获取文件内容
- * example: const char* param_ptr = readFileContent(mNativeResMgr, "yolov4-tiny.param");
- * @param mNativeResMgr
- * @param file_name 包含文件扩展名
+ * 获取可选的字符串参数
+ * @param env
+ * @param args 参数数组
+ * @param argc 实际参数个数
+ * @param index 参数下标
+ * @param default_value 参数缺省时的默认值
  * @return
  */
-const char *read_file_content(NativeResourceManager *native_res_mgr, std::string file_name) {
-    // 通过资源对象打开文件
-    RawFile *raw_file = OH_ResourceManager_OpenRawFile(native_res_mgr, file_name.c_str());
-    if (raw_file != nullptr) {
-        OH_LOG_DEBUG(LogType::LOG_APP, "%{public}s open success", file_name.c_str());
-    } else {
-        OH_LOG_DEBUG(LogType::LOG_APP, "%{public}s open fail", file_name.c_str());
+static std::string optional_string_arg(napi_env env, napi_value *args, size_t argc, size_t index,
+                                       const char *default_value) {
+    if (argc <= index || args[index] == nullptr) {
+        return default_value;
     }
-
-    // 获取rawfile大小并申请内存
-    long len = OH_ResourceManager_GetRawFileSize(raw_file);
-    OH_LOG_DEBUG(LogType::LOG_APP, "%{public}s len:%{public}ld", file_name.c_str(), len);
-    std::unique_ptr<uint8_t[]> data = std::make_unique<uint8_t[]>(len);
-
-    // 一次性读取rawfile全部内容
-    int res = OH_ResourceManager_ReadRawFile(raw_file, data.get(), len);
-
-    // 将数据转换为const unsigned char*并确保32位对齐
-    const char *aligned_ptr = reinterpret_cast<const char *>(data.get());
-
-    // 检查是否32位对齐
-    if (reinterpret_cast<uintptr_t>(aligned_ptr) % 4 != 0) {
-        OH_LOG_DEBUG(LogType::LOG_APP, "memory pointer must be 32-bit aligned");
+    napi_valuetype type = napi_undefined;
+    napi_typeof(env, args[index], &type);
+    if (type != napi_string) {
+        return default_value;
     }
+    return value_to_string(env, args[index]);
+}
 
-    OH_ResourceManager_CloseRawFile(raw_file);
-//     OH_ResourceManager_ReleaseNativeResourceManager(native_res_mgr);
-
-    return aligned_ptr;
+/**
+ * 加载模型内容，优先直接映射rawfile中的 models/<name>.param/.bin，失败时读取沙盒中的文件
+ * @param native_res_mgr 可以为空
+ * @param sanbox_path 沙盒中的模型目录
+ * @param name 模型名称（不含扩展名）
+ * @return 失败时为空
+ */
+static std::unique_ptr<modelloader::ModelData> load_model_data(const NativeResourceManager *native_res_mgr,
+                                                               const std::string &sanbox_path,
+                                                               const std::string &name) {
+    std::unique_ptr<modelloader::ModelData> data(new modelloader::ModelData());
+    if (native_res_mgr != nullptr &&
+        data->load_rawfile(native_res_mgr, ("models/" + name + ".param").c_str(), ("models/" + name + ".bin").c_str())) {
+        OH_LOG_DEBUG(LogType::LOG_APP, "%{public}s loaded from rawfile", name.c_str());
+        return data;
+    }
+    if (data->load_files((sanbox_path + "/" + name + ".param").c_str(), (sanbox_path + "/" + name + ".bin").c_str())) {
+        OH_LOG_DEBUG(LogType::LOG_APP, "%{public}s loaded from sanbox", name.c_str());
+        return data;
+    }
+    return nullptr;
 }
 
 // ==========================================================================================================
@@ -123,22 +169,16 @@ ncnn::Option get_option_from_napi(napi_env env, napi_value args_option, napi_val
     napi_get_value_bool(env, v_light_mode, &light_mode);
 
     // config 参数
+    // core不在这里处理：set_cpu_powersave作用于整个进程，由调用方按实例或按任务绑定（见get_powersave_from_napi）
     napi_value v_is_gpu;
-    napi_value v_core;
     napi_value v_thread;
     napi_get_named_property(env, args_config, "isGPU", &v_is_gpu);
-    napi_get_named_property(env, args_config, "core", &v_core);
     napi_get_named_property(env, args_config, "thread", &v_thread);
     bool is_gpu;
-    int core;
     int thread;
     napi_get_value_bool(env, v_is_gpu, &is_gpu);
-    napi_get_value_int32(env, v_core, &core);
     napi_get_value_int32(env, v_thread, &thread);
 
-    ncnn::UnlockedPoolAllocator *blob_pool_allocator = 0;
-    ncnn::UnlockedPoolAllocator *workspace_pool_allocator = 0;
-
 #if NCNN_VULKAN
     ncnn::VulkanDevice *vkdev = 0;
     ncnn::VkBlobAllocator *blob_vkallocator = 0;
@@ -147,16 +187,19 @@ ncnn::Option get_option_from_napi(napi_env env, napi_value args_option, napi_val
 
     ncnn::Option option;
     option.lightmode = light_mode;
+    // 0表示自动：CPU推理使用ncnn的默认线程数，存在自动调优结果时由apply_saved_autotune覆盖；GPU推理按GPU数量
+    if (thread > 0) {
+        option.num_threads = thread;
+    }
 #if NCNN_VULKAN
-    option.num_threads = (thread == 0) ? ncnn::get_gpu_count() : thread;
-#endif
-    if (mempool) {
-        blob_pool_allocator = new ncnn::UnlockedPoolAllocator;
-        workspace_pool_allocator = new ncnn::UnlockedPoolAllocator;
-
-        option.blob_allocator = blob_pool_allocator;
-        option.workspace_allocator = workspace_pool_allocator;
+    else if (is_gpu) {
+        option.num_threads = ncnn::get_gpu_count();
     }
+#endif
+    // 内存池由使用者持有：检测器总是使用自有的内存池（生命周期与实例一致），mempool只决定推理blob是否改用按帧重置的arena；
+    // 基准测试由ncnn按网络创建本地内存池
+    // 这里不再new分配器，避免每次初始化泄漏
+    option.use_local_pool_allocator = mempool;
 #if NCNN_VULKAN
     if (is_gpu) {
         const int gpu_device = 0;
@@ -183,10 +226,48 @@ ncnn::Option get_option_from_napi(napi_env env, napi_value args_option, napi_val
     option.use_int8_arithmetic = false;
 
 //     option.use_shader_pack8 = gpupack8;
-    ncnn::set_cpu_powersave(core);
     return option;
 }
 
+/**
+ * config.core：推理使用的核心（同set_cpu_powersave：0全部，1小核，2大核）
+ * 检测器保存在实例上，基准测试保存在任务上，推理期间绑定推理线程后恢复（见corebinding::ScopedBinding），
+ * 不修改进程级的设置，不同实例与任务互不影响
+ */
+static int get_powersave_from_napi(napi_env env, napi_value args_config) {
+    napi_value v_core;
+    int core = 0;
+    napi_get_named_property(env, args_config, "core", &v_core);
+    napi_get_value_int32(env, v_core, &core);
+    return core;
+}
+
+/**
+ * 线程数为自动（config.thread为0）时，应用沙盒中保存的自动调优结果（见autotune_run）
+ * 线程数写入option，核心选择写入powersave（由调用方交给detector::create按实例绑定）
+ * @return 是否应用
+ */
+static bool apply_saved_autotune(napi_env env, napi_value args_config, const std::string &sanbox_path,
+                                 const std::string &model_type, ncnn::Option &option, int &powersave) {
+    napi_value v_thread;
+    int thread = 0;
+    napi_get_named_property(env, args_config, "thread", &v_thread);
+    napi_get_value_int32(env, v_thread, &thread);
+    if (thread != 0 || option.use_vulkan_compute) {
+        return false;
+    }
+
+    autotune::Config config;
+    if (!autotune::load(autotune::config_path(sanbox_path, model_type), config)) {
+        return false;
+    }
+    autotune::apply(config, option);
+    powersave = config.powersave;
+    OH_LOG_DEBUG(LogType::LOG_APP, "autotune applied %{public}s threads:%{public}d powersave:%{public}d",
+                 model_type.c_str(), config.num_threads, config.powersave);
+    return true;
+}
+
 /**
  * ncnn版本号
  */
@@ -203,66 +284,127 @@ static napi_value NcnnVersion(napi_env env, napi_callback_info info) {
 }
 
 // --------------------------------------------[ yolo start ]--------------------------------------------
-// 转换增强的BoxInfo到JavaScript对象
-napi_value convert_boxinfo_to_js_yolo(napi_env env, const yolo::BoxInfo &box) {
+// 一帧结果转换时共享的JS值
+// 属性名、透传数据与各类别的名称每帧只创建一次，框之间复用，转换过程不在native侧分配字符串
+typedef struct YoloFrameValues {
+    napi_value kx1, ky1, kx2, ky2, kx_center, ky_center;
+    napi_value kscore, klabel, klabel_name, kuuid, ktime_sent, kimglabel, ktrack_id;
+    napi_value uuid;
+    napi_value time_sent;
+    bool use_snha;
+    std::vector<napi_value> label_names;  // 按label缓存，未用到的类别为nullptr
+    std::vector<napi_value> imglabels;
+} YoloFrameValues;
+
+static void init_frame_values(napi_env env, YoloFrameValues &values, const std::string &user_id,
+                              const std::string &uuid, const std::string &time_sent) {
+    // 创建键
+    napi_create_string_utf8(env, "x1", NAPI_AUTO_LENGTH, &values.kx1);
+    napi_create_string_utf8(env, "y1", NAPI_AUTO_LENGTH, &values.ky1);
+    napi_create_string_utf8(env, "x2", NAPI_AUTO_LENGTH, &values.kx2);
+    napi_create_string_utf8(env, "y2", NAPI_AUTO_LENGTH, &values.ky2);
+    napi_create_string_utf8(env, "x_center", NAPI_AUTO_LENGTH, &values.kx_center);
+    napi_create_string_utf8(env, "y_center", NAPI_AUTO_LENGTH, &values.ky_center);
+    napi_create_string_utf8(env, "score", NAPI_AUTO_LENGTH, &values.kscore);
+    napi_create_string_utf8(env, "label", NAPI_AUTO_LENGTH, &values.klabel);
+    napi_create_string_utf8(env, "labelName", NAPI_AUTO_LENGTH, &values.klabel_name);
+    napi_create_string_utf8(env, "uuid", NAPI_AUTO_LENGTH, &values.kuuid);
+    napi_create_string_utf8(env, "timeSent", NAPI_AUTO_LENGTH, &values.ktime_sent);
+    napi_create_string_utf8(env, "imglabel", NAPI_AUTO_LENGTH, &values.kimglabel);
+    napi_create_string_utf8(env, "trackId", NAPI_AUTO_LENGTH, &values.ktrack_id);
+
+    // 透传数据
+    napi_create_string_utf8(env, uuid.c_str(), uuid.size(), &values.uuid);
+    napi_create_string_utf8(env, time_sent.c_str(), time_sent.size(), &values.time_sent);
+    values.use_snha = yolo::is_snha_user(user_id.c_str());
+}
+
+// 转换BoxInfo到JavaScript对象
+napi_value convert_boxinfo_to_js_yolo(napi_env env, const yolo::BoxInfo &box, YoloFrameValues &values) {
     napi_value js_object;
     napi_create_object(env, &js_object);
 
-    // 创建键
-    napi_value kx1, ky1, kx2, ky2, kx_center, ky_center;
-    napi_value kscore, klabel, klabel_name, kuuid, ktime_sent, kimglabel;
-    
-    napi_create_string_utf8(env, "x1", NAPI_AUTO_LENGTH, &kx1);
-    napi_create_string_utf8(env, "y1", NAPI_AUTO_LENGTH, &ky1);
-    napi_create_string_utf8(env, "x2", NAPI_AUTO_LENGTH, &kx2);
-    napi_create_string_utf8(env, "y2", NAPI_AUTO_LENGTH, &ky2);
-    napi_create_string_utf8(env, "x_center", NAPI_AUTO_LENGTH, &kx_center);
-    napi_create_string_utf8(env, "y_center", NAPI_AUTO_LENGTH, &ky_center);
-    napi_create_string_utf8(env, "score", NAPI_AUTO_LENGTH, &kscore);
-    napi_create_string_utf8(env, "label", NAPI_AUTO_LENGTH, &klabel);
-    napi_create_string_utf8(env, "labelName", NAPI_AUTO_LENGTH, &klabel_name);
-    napi_create_string_utf8(env, "uuid", NAPI_AUTO_LENGTH, &kuuid);
-    napi_create_string_utf8(env, "timeSent", NAPI_AUTO_LENGTH, &ktime_sent);
-    napi_create_string_utf8(env, "imglabel", NAPI_AUTO_LENGTH, &kimglabel);
+    // 类别名称按label解析一次
+    if (box.label >= (int)values.label_names.size()) {
+        values.label_names.resize(box.label + 1, nullptr);
+        values.imglabels.resize(box.label + 1, nullptr);
+    }
+    if (box.label >= 0 && values.label_names[box.label] == nullptr) {
+        napi_create_string_utf8(env, yolo::label_name(box.label, values.use_snha), NAPI_AUTO_LENGTH,
+                                &values.label_names[box.label]);
+        napi_create_string_utf8(env, yolo::image_label(box.label, values.use_snha), NAPI_AUTO_LENGTH,
+                                &values.imglabels[box.label]);
+    }
+    napi_value label_name = nullptr;
+    napi_value imglabel = nullptr;
+    if (box.label >= 0) {
+        label_name = values.label_names[box.label];
+        imglabel = values.imglabels[box.label];
+    } else {
+        napi_create_string_utf8(env, "unknown", NAPI_AUTO_LENGTH, &label_name);
+        napi_create_string_utf8(env, "", NAPI_AUTO_LENGTH, &imglabel);
+    }
 
     // 创建值
-    napi_value x1, y1, x2, y2, x_center, y_center, score, label, label_name, uuid, time_sent, imglabel;
+    napi_value x1, y1, x2, y2, x_center, y_center, score, label;
     napi_create_double(env, box.x1, &x1);
     napi_create_double(env, box.y1, &y1);
     napi_create_double(env, box.x2, &x2);
     napi_create_double(env, box.y2, &y2);
-    napi_create_double(env, box.x_center, &x_center);
-    napi_create_double(env, box.y_center, &y_center);
+    napi_create_double(env, (box.x1 + box.x2) / 2.0f, &x_center);
+    napi_create_double(env, (box.y1 + box.y2) / 2.0f, &y_center);
     napi_create_double(env, box.score, &score);
     napi_create_int32(env, box.label, &label);
-    napi_create_string_utf8(env, box.label_name.c_str(), NAPI_AUTO_LENGTH, &label_name);
-    napi_create_string_utf8(env, box.uuid.c_str(), NAPI_AUTO_LENGTH, &uuid);
-    napi_create_string_utf8(env, box.time_sent.c_str(), NAPI_AUTO_LENGTH, &time_sent);
-    napi_create_string_utf8(env, box.imglabel.c_str(), NAPI_AUTO_LENGTH, &imglabel);
 
     // 设置属性
-    napi_set_property(env, js_object, kx1, x1);
-    napi_set_property(env, js_object, ky1, y1);
-    napi_set_property(env, js_object, kx2, x2);
-    napi_set_property(env, js_object, ky2, y2);
-    napi_set_property(env, js_object, kx_center, x_center);
-    napi_set_property(env, js_object, ky_center, y_center);
-    napi_set_property(env, js_object, kscore, score);
-    napi_set_property(env, js_object, klabel, label);
-    napi_set_property(env, js_object, klabel_name, label_name);
-    napi_set_property(env, js_object, kuuid, uuid);
-    napi_set_property(env, js_object, ktime_sent, time_sent);
-    napi_set_property(env, js_object, kimglabel, imglabel);
+    napi_set_property(env, js_object, values.kx1, x1);
+    napi_set_property(env, js_object, values.ky1, y1);
+    napi_set_property(env, js_object, values.kx2, x2);
+    napi_set_property(env, js_object, values.ky2, y2);
+    napi_set_property(env, js_object, values.kx_center, x_center);
+    napi_set_property(env, js_object, values.ky_center, y_center);
+    napi_set_property(env, js_object, values.kscore, score);
+    napi_set_property(env, js_object, values.klabel, label);
+    napi_set_property(env, js_object, values.klabel_name, label_name);
+    napi_set_property(env, js_object, values.kuuid, values.uuid);
+    napi_set_property(env, js_object, values.ktime_sent, values.time_sent);
+    napi_set_property(env, js_object, values.kimglabel, imglabel);
 
     return js_object;
 }
 
+// 转换检测结果数组
+// user_id: "SNHA"时类别名称使用物料编码；uuid、time_sent为透传数据
+// track_ids: 与objects一一对应的跟踪ID（推流开启跟踪时），不为空时每个框增加trackId属性
+napi_value convert_boxes_to_js_yolo(napi_env env, const std::vector<yolo::BoxInfo> &objects,
+                                    const std::string &user_id, const std::string &uuid,
+                                    const std::string &time_sent, const std::vector<int> *track_ids = nullptr) {
+    napi_value js_array;
+    napi_create_array_with_length(env, objects.size(), &js_array);
+    if (objects.empty()) {
+        return js_array;
+    }
+
+    YoloFrameValues values;
+    init_frame_values(env, values, user_id, uuid, time_sent);
+    for (size_t i = 0; i < objects.size(); i++) {
+        napi_value js_box = convert_boxinfo_to_js_yolo(env, objects[i], values);
+        if (track_ids != nullptr && i < track_ids->size()) {
+            napi_value track_id;
+            napi_create_int32(env, (*track_ids)[i], &track_id);
+            napi_set_property(env, js_box, values.ktrack_id, track_id);
+        }
+        napi_set_element(env, js_array, i, js_box);
+    }
+    return js_array;
+}
+
 // YOLOv4已移除，只使用YOLOv8
 // 如需使用YOLOv4，请参考git历史记录
 
 // --------------------------------------------[ yolo end ]--------------------------------------------
 
-// --------------------------------------------[ nanodet start ]--------------------------------------------
+// --------------------------------------------[ detector start ]--------------------------------------------
 napi_value convert_boxinfo_to_js_nanodet(napi_env env, const nanodet::BoxInfo &box) {
     napi_value js_object;
     napi_create_object(env, &js_object);
@@ -293,289 +435,2529 @@ napi_value convert_boxinfo_to_js_nanodet(napi_env env, const nanodet::BoxInfo &b
     return js_object;
 }
 
+napi_value convert_boxes_to_js_nanodet(napi_env env, const std::vector<nanodet::BoxInfo> &objects) {
+    napi_value js_array;
+    napi_create_array_with_length(env, objects.size(), &js_array);
+    for (size_t i = 0; i < objects.size(); i++) {
+        napi_value js_box = convert_boxinfo_to_js_nanodet(env, objects[i]);
+        napi_set_element(env, js_array, i, js_box);
+    }
+    return js_array;
+}
+
+// 打包结果的记录布局：每个框8个4字节字段，JS端用同一ArrayBuffer上的Float32Array/Int32Array视图读取
+// [0] x1 [1] y1 [2] x2 [3] y2 [4] x_center [5] y_center [6] score（float32） [7] label（int32）
+// 类别名称与图像级标签不随每帧返回，由detector_labels一次取得并按label查表
+static const int PACKED_STRIDE = 8;
+
+static inline void pack_box(float *record, float x1, float y1, float x2, float y2, float score, int label) {
+    record[0] = x1;
+    record[1] = y1;
+    record[2] = x2;
+    record[3] = y2;
+    record[4] = (x1 + x2) / 2.0f;
+    record[5] = (y1 + y2) / 2.0f;
+    record[6] = score;
+    memcpy(record + 7, &label, sizeof(int));
+}
+
 /**
- * 初始化
+ * 创建打包结果对象 {count, stride, boxes, uuid, timeSent}，记录写入由调用方完成
+ * @param records 输出，指向boxes的数据区
  */
-static napi_value NanoDetInit(napi_env env, napi_callback_info info) {
-    size_t argc = 4;
-    napi_value args[4] = {nullptr};
-    // 获取参数信息
-    napi_get_cb_info(env, info, &argc, args, nullptr, nullptr);
+static napi_value create_packed_result(napi_env env, size_t count, const std::string &uuid,
+                                       const std::string &time_sent, float *&records) {
+    void *data = nullptr;
+    napi_value boxes;
+    napi_create_arraybuffer(env, count * PACKED_STRIDE * sizeof(float), &data, &boxes);
+    records = static_cast<float *>(data);
 
-    // 将传入的resource manager对象转换为Native对象
-    NativeResourceManager *mNativeResMgr = OH_ResourceManager_InitNativeResourceManager(env, args[0]);
-    if (mNativeResMgr != nullptr) {
-        OH_LOG_DEBUG(LogType::LOG_APP, "NativeResourceManager success");
-    } else {
-        OH_LOG_DEBUG(LogType::LOG_APP, "NativeResourceManager fail");
+    napi_value js_object, js_count, js_stride, js_uuid, js_time_sent;
+    napi_create_object(env, &js_object);
+    napi_create_uint32(env, (uint32_t)count, &js_count);
+    napi_create_int32(env, PACKED_STRIDE, &js_stride);
+    napi_create_string_utf8(env, uuid.c_str(), uuid.size(), &js_uuid);
+    napi_create_string_utf8(env, time_sent.c_str(), time_sent.size(), &js_time_sent);
+    napi_set_named_property(env, js_object, "count", js_count);
+    napi_set_named_property(env, js_object, "stride", js_stride);
+    napi_set_named_property(env, js_object, "boxes", boxes);
+    napi_set_named_property(env, js_object, "uuid", js_uuid);
+    napi_set_named_property(env, js_object, "timeSent", js_time_sent);
+    return js_object;
+}
+
+napi_value convert_boxes_to_js_packed(napi_env env, const std::vector<yolo::BoxInfo> &objects,
+                                      const std::string &uuid, const std::string &time_sent) {
+    float *records = nullptr;
+    napi_value js_object = create_packed_result(env, objects.size(), uuid, time_sent, records);
+    for (size_t i = 0; i < objects.size(); i++) {
+        const yolo::BoxInfo &box = objects[i];
+        pack_box(records + i * PACKED_STRIDE, box.x1, box.y1, box.x2, box.y2, box.score, box.label);
     }
+    return js_object;
+}
 
-    napi_value str = args[1];
-    std::string sanbox_path = value_to_string(env, str);
-    OH_LOG_DEBUG(LogType::LOG_APP, "sanbox path:%{public}s", sanbox_path.c_str());
+napi_value convert_boxes_to_js_packed(napi_env env, const std::vector<nanodet::BoxInfo> &objects,
+                                      const std::string &uuid, const std::string &time_sent) {
+    float *records = nullptr;
+    napi_value js_object = create_packed_result(env, objects.size(), uuid, time_sent, records);
+    for (size_t i = 0; i < objects.size(); i++) {
+        const nanodet::BoxInfo &box = objects[i];
+        pack_box(records + i * PACKED_STRIDE, box.x1, box.y1, box.x2, box.y2, box.score, box.label);
+    }
+    return js_object;
+}
 
-    // 参数
-    ncnn::Option option = get_option_from_napi(env, args[2], args[3]);
+/**
+ * 转换识别结果（按实例类型与结果模式）
+ */
+static napi_value convert_result_to_js(napi_env env, const detector::Instance &instance,
+                                       const detector::Result &result, const std::string &user_id,
+                                       const std::string &uuid, const std::string &time_sent) {
+    if (instance.packed_results) {
+        if (instance.nanodet) {
+            return convert_boxes_to_js_packed(env, result.nanodet_boxes, uuid, time_sent);
+        }
+        return convert_boxes_to_js_packed(env, result.yolo_boxes, uuid, time_sent);
+    }
+    if (instance.nanodet) {
+        return convert_boxes_to_js_nanodet(env, result.nanodet_boxes);
+    }
+    return convert_boxes_to_js_yolo(env, result.yolo_boxes, user_id, uuid, time_sent,
+                                    result.track_ids.empty() ? nullptr : &result.track_ids);
+}
 
-    if (g_nanodet != nullptr) {
-        OH_LOG_DEBUG(LogType::LOG_APP, "delete g_nanodet");
-        delete g_nanodet;
+/**
+ * 在实例上识别RGBA图像
+ * 调用方持有实例引用，推理期间实例不会被销毁；同一实例的推理串行执行
+ * @return 实例为空时返回空数组
+ */
+static napi_value run_instance(napi_env env, const std::shared_ptr<detector::Instance> &instance, ncnn::Mat &input,
+                               int width, int height, const std::string &user_id, const std::string &uuid,
+                               const std::string &time_sent) {
+    if (!instance) {
+        OH_LOG_DEBUG(LogType::LOG_APP, "detector not initialized");
+        return convert_boxes_to_js_yolo(env, std::vector<yolo::BoxInfo>(), user_id, uuid, time_sent);
     }
-    g_nanodet = new nanodet::NanoDet();
-    int r = g_nanodet->init(option, (sanbox_path + "/nanodet-m.param").c_str(),
-                            (sanbox_path + "/nanodet-m.bin").c_str(), "nanodet-m");
 
-    const char *r_str = r == 0 ? "success" : "fail";
-    napi_value nr_str;
-    napi_create_string_utf8(env, r_str, strlen(r_str), &nr_str);
-    return nr_str;
+    detector::Result result;
+    detector::run(*instance, (const unsigned char *)input.data, width, height, result);
+    return convert_result_to_js(env, *instance, result, user_id, uuid, time_sent);
 }
 
 /**
- * 识别
+ * 在实例上识别NV21相机帧（仅YOLOv8）
  */
-static napi_value NanoDetRun(napi_env env, napi_callback_info info) {
-    size_t argc = 3;
-    napi_value args[3] = {nullptr};
-    // 获取参数信息
-    napi_get_cb_info(env, info, &argc, args, nullptr, nullptr);
-
-    void *data = nullptr;
-    size_t byte_length = 0;
-    // 获取ArrayBuffer的底层数据缓冲区和长度
-    napi_status status = napi_get_arraybuffer_info(env, args[0], &data, &byte_length);
-    if (status != napi_ok) {
-        OH_LOG_DEBUG(LogType::LOG_APP, "Failed to get ArrayBuffer info");
+static napi_value run_instance_nv21(napi_env env, const std::shared_ptr<detector::Instance> &instance,
+                                    const unsigned char *nv21, int width, int height, int stride, int rotation,
+                                    const std::string &user_id, const std::string &uuid,
+                                    const std::string &time_sent) {
+    detector::Result result;
+    if (!instance ||
+        detector::run_nv21(*instance, nv21, width, height, stride, rotation, result) != detector::STATUS_OK) {
+        OH_LOG_DEBUG(LogType::LOG_APP, "nv21 input requires a yolov8 detector");
         return nullptr;
     }
-    OH_LOG_DEBUG(LogType::LOG_APP, "byte length:%{public}zu", byte_length);
-    int width;
-    int height;
-    napi_get_value_int32(env, args[1], &width);
-    napi_get_value_int32(env, args[2], &height);
-    OH_LOG_DEBUG(LogType::LOG_APP, "image size:%{public}d x %{public}d", width, height);
-
-    ncnn::Mat input = ncnn::Mat(width, height, 4, data);
-    OH_LOG_DEBUG(LogType::LOG_APP, "mat size:%{public}d x %{public}d x %{public}d", input.w, input.h, input.c);
+    return convert_result_to_js(env, *instance, result, user_id, uuid, time_sent);
+}
 
-    std::vector<nanodet::BoxInfo> objects;
-    objects = g_nanodet->run(input, width, height, "nanodet-m");
+/**
+ * 设置实例的阈值（仅YOLOv8）
+ * 参数: 置信度阈值, NMS阈值, [每个类别的置信度阈值数组]
+ * @return 实例为空或不支持时返回false
+ */
+static napi_value set_instance_thresholds(napi_env env, const std::shared_ptr<detector::Instance> &instance,
+                                          napi_value *args, size_t argc) {
+    double conf_threshold = 0.25;
+    double nms_threshold = 0.45;
+    napi_get_value_double(env, args[0], &conf_threshold);
+    napi_get_value_double(env, args[1], &nms_threshold);
+
+    std::vector<float> class_thresholds;
+    bool is_array = false;
+    if (argc > 2 && napi_is_array(env, args[2], &is_array) == napi_ok && is_array) {
+        uint32_t length = 0;
+        napi_get_array_length(env, args[2], &length);
+        class_thresholds.resize(length);
+        for (uint32_t i = 0; i < length; i++) {
+            napi_value element;
+            double value = conf_threshold;
+            napi_get_element(env, args[2], i, &element);
+            napi_get_value_double(env, element, &value);
+            class_thresholds[i] = (float)value;
+        }
+    }
 
-    napi_value js_array;
-    napi_create_array_with_length(env, objects.size(), &js_array);
-    for (size_t i = 0; i < objects.size(); i++) {
-        napi_value js_box = convert_boxinfo_to_js_nanodet(env, objects[i]);
-        napi_set_element(env, js_array, i, js_box);
+    bool ok = instance && instance->yolov8;
+    if (ok) {
+        std::lock_guard<std::mutex> lock(instance->mutex);
+        instance->yolov8->set_thresholds((float)conf_threshold, (float)nms_threshold, class_thresholds);
+        instance->threshold_generation++;
     }
+    OH_LOG_DEBUG(LogType::LOG_APP, "thresholds conf:%{public}f nms:%{public}f classes:%{public}zu", conf_threshold,
+                 nms_threshold, class_thresholds.size());
 
-    return js_array;
+    napi_value result;
+    napi_get_boolean(env, ok, &result);
+    return result;
 }
 
-// --------------------------------------------[ nanodet end ]--------------------------------------------
+/**
+ * JS句柄析构时释放其持有的实例引用
+ */
+static void detector_handle_finalize(napi_env env, void *data, void *hint) {
+    delete static_cast<std::shared_ptr<detector::Instance> *>(data);
+}
 
-// --------------------------------------------[ yolov8 start ]--------------------------------------------
 /**
- * 初始化YOLOv8
+ * 由参数取得实例
+ * 参数可以是detector_create返回的句柄，也可以是句柄的id（taskpool传递后的句柄只保留id属性）
  */
-static napi_value YOLOv8Init(napi_env env, napi_callback_info info) {
+static std::shared_ptr<detector::Instance> instance_from_arg(napi_env env, napi_value value) {
+    napi_valuetype type = napi_undefined;
+    napi_typeof(env, value, &type);
+    int32_t id = 0;
+    if (type == napi_number) {
+        napi_get_value_int32(env, value, &id);
+        return detector::find(id);
+    }
+    if (type != napi_object) {
+        return nullptr;
+    }
+
+    void *data = nullptr;
+    if (napi_unwrap(env, value, &data) == napi_ok && data != nullptr) {
+        return *static_cast<std::shared_ptr<detector::Instance> *>(data);
+    }
+    napi_value id_value;
+    if (napi_get_named_property(env, value, "id", &id_value) == napi_ok &&
+        napi_get_value_int32(env, id_value, &id) == napi_ok) {
+        return detector::find(id);
+    }
+    return nullptr;
+}
+
+/**
+ * 创建检测器实例
+ * 参数: resMgr, 沙盒路径, 模型类型, option, config
+ * @return 句柄对象 {id, modelType}，失败返回undefined
+ * 句柄持有实例，句柄被回收或detector_release后（且没有进行中的推理）实例才销毁
+ */
+static napi_value DetectorCreate(napi_env env, napi_callback_info info) {
     size_t argc = 5;
     napi_value args[5] = {nullptr};
     napi_get_cb_info(env, info, &argc, args, nullptr, nullptr);
 
-    // 将传入的resource manager对象转换为Native对象
     NativeResourceManager *mNativeResMgr = OH_ResourceManager_InitNativeResourceManager(env, args[0]);
-    if (mNativeResMgr != nullptr) {
-        OH_LOG_DEBUG(LogType::LOG_APP, "NativeResourceManager success");
-    } else {
-        OH_LOG_DEBUG(LogType::LOG_APP, "NativeResourceManager fail");
-    }
-
-    napi_value str = args[1];
-    std::string sanbox_path = value_to_string(env, str);
-    OH_LOG_DEBUG(LogType::LOG_APP, "sanbox path:%{public}s", sanbox_path.c_str());
-
-    // 获取模型类型（如"yolov8n", "yolov8s"等）
-    napi_value model_type_value = args[2];
-    std::string model_type = value_to_string(env, model_type_value);
-    OH_LOG_DEBUG(LogType::LOG_APP, "model type:%{public}s", model_type.c_str());
-
-    // 参数
+    std::string sanbox_path = value_to_string(env, args[1]);
+    std::string model_type = value_to_string(env, args[2]);
     ncnn::Option option = get_option_from_napi(env, args[3], args[4]);
+    int powersave = get_powersave_from_napi(env, args[4]);
+    apply_saved_autotune(env, args[4], sanbox_path, model_type, option, powersave);
 
-    if (g_yolov8 != nullptr) {
-        OH_LOG_DEBUG(LogType::LOG_APP, "delete g_yolov8");
-        delete g_yolov8;
+    std::unique_ptr<modelloader::ModelData> model_data = load_model_data(mNativeResMgr, sanbox_path, model_type);
+    std::shared_ptr<detector::Instance> instance = detector::create(model_type, option, std::move(model_data), powersave);
+    if (mNativeResMgr != nullptr) {
+        OH_ResourceManager_ReleaseNativeResourceManager(mNativeResMgr);
+    }
+    if (!instance) {
+        return nullptr;
     }
-    g_yolov8 = new yolo::YOLOv8();
-    
-    // 构建模型文件路径
-    std::string param_path = sanbox_path + "/" + model_type + ".param";
-    std::string bin_path = sanbox_path + "/" + model_type + ".bin";
-    
-    int r = g_yolov8->init(option, param_path.c_str(), bin_path.c_str(), model_type.c_str());
 
-    const char *r_str = (r == 0) ? "fail" : "success";
-    napi_value nr_str;
-    napi_create_string_utf8(env, r_str, strlen(r_str), &nr_str);
-    return nr_str;
+    napi_value handle, id, type;
+    napi_create_object(env, &handle);
+    napi_create_int32(env, instance->id, &id);
+    napi_create_string_utf8(env, instance->model_type.c_str(), NAPI_AUTO_LENGTH, &type);
+    napi_set_named_property(env, handle, "id", id);
+    napi_set_named_property(env, handle, "modelType", type);
+
+    std::shared_ptr<detector::Instance> *ref = new std::shared_ptr<detector::Instance>(instance);
+    if (napi_wrap(env, handle, ref, detector_handle_finalize, nullptr, nullptr) != napi_ok) {
+        delete ref;
+        detector::unregister(instance->id);
+        return nullptr;
+    }
+    return handle;
 }
 
 /**
- * YOLOv8识别（增强版，支持透传数据和SNHA标签映射）
+ * 使用句柄识别RGBA图像
+ * 参数: 句柄或id, 图像数据, 宽, 高, [用户ID, uuid, 时间戳]
  */
-static napi_value YOLOv8Run(napi_env env, napi_callback_info info) {
-    size_t argc = 7;  // 增加参数数量
+static napi_value DetectorRun(napi_env env, napi_callback_info info) {
+    size_t argc = 7;
     napi_value args[7] = {nullptr};
     napi_get_cb_info(env, info, &argc, args, nullptr, nullptr);
 
     void *data = nullptr;
     size_t byte_length = 0;
-    napi_status status = napi_get_arraybuffer_info(env, args[0], &data, &byte_length);
-    if (status != napi_ok) {
+    if (napi_get_arraybuffer_info(env, args[1], &data, &byte_length) != napi_ok) {
         OH_LOG_DEBUG(LogType::LOG_APP, "Failed to get ArrayBuffer info");
         return nullptr;
     }
-    OH_LOG_DEBUG(LogType::LOG_APP, "byte length:%{public}zu", byte_length);
-    
     int width;
     int height;
-    napi_get_value_int32(env, args[1], &width);
-    napi_get_value_int32(env, args[2], &height);
-    OH_LOG_DEBUG(LogType::LOG_APP, "image size:%{public}d x %{public}d", width, height);
-
-    // 获取模型类型（可选，默认yolov8n）
-    std::string model_type = "yolov8n";
-    if (argc > 3 && args[3] != nullptr) {
-        model_type = value_to_string(env, args[3]);
-    }
-    
-    // 获取透传数据（可选）
-    std::string user_id = "";
-    if (argc > 4 && args[4] != nullptr) {
-        user_id = value_to_string(env, args[4]);
-    }
-    
-    std::string uuid = "";
-    if (argc > 5 && args[5] != nullptr) {
-        uuid = value_to_string(env, args[5]);
-    }
-    
-    std::string time_sent = "";
-    if (argc > 6 && args[6] != nullptr) {
-        time_sent = value_to_string(env, args[6]);
+    napi_get_value_int32(env, args[2], &width);
+    napi_get_value_int32(env, args[3], &height);
+    if (byte_length < (size_t)width * height * 4) {
+        OH_LOG_DEBUG(LogType::LOG_APP, "rgba buffer too small:%{public}zu", byte_length);
+        return nullptr;
     }
-    
-    OH_LOG_DEBUG(LogType::LOG_APP, "model:%{public}s, userId:%{public}s", 
-                 model_type.c_str(), user_id.c_str());
+
+    std::string user_id = optional_string_arg(env, args, argc, 4, "");
+    std::string uuid = optional_string_arg(env, args, argc, 5, "");
+    std::string time_sent = optional_string_arg(env, args, argc, 6, "");
 
     ncnn::Mat input = ncnn::Mat(width, height, 4, data);
-    OH_LOG_DEBUG(LogType::LOG_APP, "mat size:%{public}d x %{public}d x %{public}d", input.w, input.h, input.c);
+    return run_instance(env, instance_from_arg(env, args[0]), input, width, height, user_id, uuid, time_sent);
+}
 
-    // 执行推理，传入透传数据
-    std::vector<yolo::BoxInfo> objects;
-    objects = g_yolov8->run(input, width, height, model_type.c_str(), 
-                           user_id.c_str(), uuid.c_str(), time_sent.c_str());
+/**
+ * 使用句柄识别NV21相机帧（仅YOLOv8）
+ * 参数: 句柄或id, nv21数据, 宽, 高, 行跨度, 顺时针旋转角度, [用户ID, uuid, 时间戳]
+ */
+static napi_value DetectorRunNV21(napi_env env, napi_callback_info info) {
+    size_t argc = 9;
+    napi_value args[9] = {nullptr};
+    napi_get_cb_info(env, info, &argc, args, nullptr, nullptr);
 
-    napi_value js_array;
-    napi_create_array_with_length(env, objects.size(), &js_array);
-    for (size_t i = 0; i < objects.size(); i++) {
-        napi_value js_box = convert_boxinfo_to_js_yolo(env, objects[i]);
-        napi_set_element(env, js_array, i, js_box);
+    void *data = nullptr;
+    size_t byte_length = 0;
+    if (napi_get_arraybuffer_info(env, args[1], &data, &byte_length) != napi_ok) {
+        OH_LOG_DEBUG(LogType::LOG_APP, "Failed to get ArrayBuffer info");
+        return nullptr;
+    }
+    int width;
+    int height;
+    int stride;
+    int rotation;
+    napi_get_value_int32(env, args[2], &width);
+    napi_get_value_int32(env, args[3], &height);
+    napi_get_value_int32(env, args[4], &stride);
+    napi_get_value_int32(env, args[5], &rotation);
+    if (!yolo::valid_nv21(width, height, rotation)) {
+        OH_LOG_DEBUG(LogType::LOG_APP, "invalid nv21 frame %{public}dx%{public}d rotation:%{public}d", width, height,
+                     rotation);
+        return nullptr;
+    }
+    if (stride < width) {
+        stride = width;
+    }
+    if (byte_length < (size_t)stride * height * 3 / 2) {
+        OH_LOG_DEBUG(LogType::LOG_APP, "nv21 buffer too small:%{public}zu", byte_length);
+        return nullptr;
     }
 
-    return js_array;
-}
+    std::string user_id = optional_string_arg(env, args, argc, 6, "");
+    std::string uuid = optional_string_arg(env, args, argc, 7, "");
+    std::string time_sent = optional_string_arg(env, args, argc, 8, "");
 
-// --------------------------------------------[ yolov8 end ]--------------------------------------------
+    return run_instance_nv21(env, instance_from_arg(env, args[0]), static_cast<const unsigned char *>(data), width,
+                             height, stride, rotation, user_id, uuid, time_sent);
+}
 
-// --------------------------------------------[ benchmark start ]--------------------------------------------
+/**
+ * 设置句柄对应实例的阈值
+ * 参数: 句柄或id, 置信度阈值, NMS阈值, [每个类别的置信度阈值数组]
+ */
+static napi_value DetectorSetThresholds(napi_env env, napi_callback_info info) {
+    size_t argc = 4;
+    napi_value args[4] = {nullptr};
+    napi_get_cb_info(env, info, &argc, args, nullptr, nullptr);
+    return set_instance_thresholds(env, instance_from_arg(env, args[0]), args + 1, argc > 0 ? argc - 1 : 0);
+}
 
-static const std::map<std::string, int> g_models_size = {
-    // {"YOLOv4-tiny", 416},  // YOLOv4已移除
-    {"nanodet-m", 320},
-    {"yolov8n", 640},
-    {"yolov8s", 640},
-    {"yolov8m", 640},
-    {"yolov8l", 640},
-    {"yolov8x", 640},
-};
+/**
+ * 释放句柄
+ * 句柄不再可用，进行中的推理结束后实例销毁；传入id时只从注册表移除
+ */
+static napi_value DetectorRelease(napi_env env, napi_callback_info info) {
+    size_t argc = 1;
+    napi_value args[1] = {nullptr};
+    napi_get_cb_info(env, info, &argc, args, nullptr, nullptr);
+
+    std::shared_ptr<detector::Instance> instance = instance_from_arg(env, args[0]);
+    napi_valuetype type = napi_undefined;
+    napi_typeof(env, args[0], &type);
+    void *data = nullptr;
+    if (type == napi_object && napi_remove_wrap(env, args[0], &data) == napi_ok && data != nullptr) {
+        delete static_cast<std::shared_ptr<detector::Instance> *>(data);
+    }
+    if (instance) {
+        detector::unregister(instance->id);
+    }
+
+    napi_value result;
+    napi_get_boolean(env, instance != nullptr, &result);
+    return result;
+}
+
+/**
+ * 设置结果模式
+ * 参数: 句柄或id, 是否返回打包结果（{count, stride, boxes: ArrayBuffer, uuid, timeSent}）
+ */
+static napi_value DetectorSetPacked(napi_env env, napi_callback_info info) {
+    size_t argc = 2;
+    napi_value args[2] = {nullptr};
+    napi_get_cb_info(env, info, &argc, args, nullptr, nullptr);
+
+    std::shared_ptr<detector::Instance> instance = instance_from_arg(env, args[0]);
+    bool packed = false;
+    napi_get_value_bool(env, args[1], &packed);
+    if (instance) {
+        instance->packed_results = packed;
+    }
+    napi_value result;
+    napi_get_boolean(env, instance != nullptr, &result);
+    return result;
+}
+
+/**
+ * 类别表（配合打包结果使用，每个模型取一次即可）
+ * 参数: 句柄或id, [用户ID（"SNHA"时为物料编码）]
+ * @return {names: string[], imglabels: string[]}，下标为label
+ */
+static napi_value DetectorLabels(napi_env env, napi_callback_info info) {
+    size_t argc = 2;
+    napi_value args[2] = {nullptr};
+    napi_get_cb_info(env, info, &argc, args, nullptr, nullptr);
+
+    std::shared_ptr<detector::Instance> instance = instance_from_arg(env, args[0]);
+    if (!instance) {
+        return nullptr;
+    }
+    bool use_snha = yolo::is_snha_user(optional_string_arg(env, args, argc, 1, "").c_str());
+
+    int count = detector::class_count(*instance);
+    napi_value names, imglabels;
+    napi_create_array_with_length(env, count, &names);
+    napi_create_array_with_length(env, count, &imglabels);
+    for (int i = 0; i < count; i++) {
+        napi_value js_name, js_imglabel;
+        napi_create_string_utf8(env, yolo::label_name(i, use_snha), NAPI_AUTO_LENGTH, &js_name);
+        napi_create_string_utf8(env, yolo::image_label(i, use_snha), NAPI_AUTO_LENGTH, &js_imglabel);
+        napi_set_element(env, names, i, js_name);
+        napi_set_element(env, imglabels, i, js_imglabel);
+    }
 
-napi_value convert_benchmark_to_js(napi_env env, const benchmark::BenchmarkResult &result) {
     napi_value js_object;
     napi_create_object(env, &js_object);
+    napi_set_named_property(env, js_object, "names", names);
+    napi_set_named_property(env, js_object, "imglabels", imglabels);
+    return js_object;
+}
 
-    napi_value kloop, kmin, kmax, kavg, kwidth, kheight;
-    napi_create_string_utf8(env, "loop", NAPI_AUTO_LENGTH, &kloop);
-    napi_create_string_utf8(env, "min", NAPI_AUTO_LENGTH, &kmin);
-    napi_create_string_utf8(env, "max", NAPI_AUTO_LENGTH, &kmax);
-    napi_create_string_utf8(env, "avg", NAPI_AUTO_LENGTH, &kavg);
-    napi_create_string_utf8(env, "width", NAPI_AUTO_LENGTH, &kwidth);
-    napi_create_string_utf8(env, "height", NAPI_AUTO_LENGTH, &kheight);
-
-    napi_value loop, min, max, avg, width, height;
-    napi_create_double(env, result.loop, &loop);
-    napi_create_double(env, result.min, &min);
-    napi_create_double(env, result.max, &max);
-    napi_create_double(env, result.avg, &avg);
-    napi_create_double(env, result.width, &width);
-    napi_create_int32(env, result.height, &height);
-
-    napi_set_property(env, js_object, kloop, loop);
-    napi_set_property(env, js_object, kmin, min);
-    napi_set_property(env, js_object, kmax, max);
-    napi_set_property(env, js_object, kavg, avg);
-    napi_set_property(env, js_object, kwidth, width);
-    napi_set_property(env, js_object, kheight, height);
+/**
+ * 推理blob的内存统计（字节数与次数，开启mempool时有效）
+ * 内存占用约为capacity加溢出部分的存活峰值（不超过peakLiveBytes），见arena::ArenaAllocator
+ * 参数: 句柄或id
+ * @return {capacity, frameBytes, peakFrameBytes, liveBytes, peakLiveBytes, allocations, fallbackAllocations,
+ *          liveAllocations, frames}
+ */
+static napi_value DetectorMemoryStats(napi_env env, napi_callback_info info) {
+    size_t argc = 1;
+    napi_value args[1] = {nullptr};
+    napi_get_cb_info(env, info, &argc, args, nullptr, nullptr);
 
+    std::shared_ptr<detector::Instance> instance = instance_from_arg(env, args[0]);
+    if (!instance) {
+        return nullptr;
+    }
+    arena::Stats stats;
+    detector::memory_stats(*instance, stats);
+
+    const struct {
+        const char *key;
+        size_t value;
+    } fields[] = {
+        {"capacity", stats.capacity},
+        {"frameBytes", stats.frame_bytes},
+        {"peakFrameBytes", stats.peak_frame_bytes},
+        {"liveBytes", stats.live_bytes},
+        {"peakLiveBytes", stats.peak_live_bytes},
+        {"allocations", stats.allocations},
+        {"fallbackAllocations", stats.fallback_allocations},
+        {"liveAllocations", stats.live_allocations},
+        {"frames", stats.frames},
+    };
+    napi_value js_object;
+    napi_create_object(env, &js_object);
+    for (const auto &field : fields) {
+        napi_value js_value;
+        napi_create_double(env, (double)field.value, &js_value);
+        napi_set_named_property(env, js_object, field.key, js_value);
+    }
     return js_object;
 }
 
-static napi_value BenchmarkNCNN(napi_env env, napi_callback_info info) {
-    size_t argc = 6;
-    napi_value args[6] = {nullptr};
+// --------------------------------------------[ detector end ]--------------------------------------------
+
+// --------------------------------------------[ nanodet start ]--------------------------------------------
+/**
+ * 初始化
+ */
+static napi_value NanoDetInit(napi_env env, napi_callback_info info) {
+    size_t argc = 4;
+    napi_value args[4] = {nullptr};
     // 获取参数信息
     napi_get_cb_info(env, info, &argc, args, nullptr, nullptr);
 
-    napi_value str0 = args[0];
-    std::string sanbox_path = value_to_string(env, str0);
-    napi_value str1 = args[1];
-    std::string model_name = value_to_string(env, str1);
-    napi_value str2 = args[2];
-    std::string param_name = value_to_string(env, str2);
-    OH_LOG_DEBUG(LogType::LOG_APP, "sanbox path:%{public}s, model name:%{public}s, param name:%{public}s",
-                 sanbox_path.c_str(), model_name.c_str(), param_name.c_str());
+    // 将传入的resource manager对象转换为Native对象
+    NativeResourceManager *mNativeResMgr = OH_ResourceManager_InitNativeResourceManager(env, args[0]);
+    if (mNativeResMgr != nullptr) {
+        OH_LOG_DEBUG(LogType::LOG_APP, "NativeResourceManager success");
+    } else {
+        OH_LOG_DEBUG(LogType::LOG_APP, "NativeResourceManager fail");
+    }
+
+    napi_value str = args[1];
+    std::string sanbox_path = value_to_string(env, str);
+    OH_LOG_DEBUG(LogType::LOG_APP, "sanbox path:%{public}s", sanbox_path.c_str());
+
+    // 参数
+    ncnn::Option option = get_option_from_napi(env, args[2], args[3]);
+    int powersave = get_powersave_from_napi(env, args[3]);
+    apply_saved_autotune(env, args[3], sanbox_path, "nanodet-m", option, powersave);
+
+    std::unique_ptr<modelloader::ModelData> model_data = load_model_data(mNativeResMgr, sanbox_path, "nanodet-m");
+    std::shared_ptr<detector::Instance> instance = detector::create("nanodet-m", option, std::move(model_data), powersave);
+    if (mNativeResMgr != nullptr) {
+        OH_ResourceManager_ReleaseNativeResourceManager(mNativeResMgr);
+    }
+    // 初始化失败时保留原有实例
+    if (instance) {
+        set_default_instance(g_nanodet, instance);
+    }
+
+    const char *r_str = instance ? "success" : "fail";
+    napi_value nr_str;
+    napi_create_string_utf8(env, r_str, strlen(r_str), &nr_str);
+    return nr_str;
+}
+
+/**
+ * 识别
+ */
+static napi_value NanoDetRun(napi_env env, napi_callback_info info) {
+    size_t argc = 3;
+    napi_value args[3] = {nullptr};
+    // 获取参数信息
+    napi_get_cb_info(env, info, &argc, args, nullptr, nullptr);
+
+    void *data = nullptr;
+    size_t byte_length = 0;
+    // 获取ArrayBuffer的底层数据缓冲区和长度
+    napi_status status = napi_get_arraybuffer_info(env, args[0], &data, &byte_length);
+    if (status != napi_ok) {
+        OH_LOG_DEBUG(LogType::LOG_APP, "Failed to get ArrayBuffer info");
+        return nullptr;
+    }
+    OH_LOG_DEBUG(LogType::LOG_APP, "byte length:%{public}zu", byte_length);
+    int width;
+    int height;
+    napi_get_value_int32(env, args[1], &width);
+    napi_get_value_int32(env, args[2], &height);
+    OH_LOG_DEBUG(LogType::LOG_APP, "image size:%{public}d x %{public}d", width, height);
+
+    ncnn::Mat input = ncnn::Mat(width, height, 4, data);
+    OH_LOG_DEBUG(LogType::LOG_APP, "mat size:%{public}d x %{public}d x %{public}d", input.w, input.h, input.c);
+
+    return run_instance(env, get_default_instance(g_nanodet), input, width, height, "", "", "");
+}
+
+// --------------------------------------------[ nanodet end ]--------------------------------------------
+
+// --------------------------------------------[ yolov8 start ]--------------------------------------------
+/**
+ * 初始化YOLOv8
+ */
+static napi_value YOLOv8Init(napi_env env, napi_callback_info info) {
+    size_t argc = 5;
+    napi_value args[5] = {nullptr};
+    napi_get_cb_info(env, info, &argc, args, nullptr, nullptr);
+
+    // 将传入的resource manager对象转换为Native对象
+    NativeResourceManager *mNativeResMgr = OH_ResourceManager_InitNativeResourceManager(env, args[0]);
+    if (mNativeResMgr != nullptr) {
+        OH_LOG_DEBUG(LogType::LOG_APP, "NativeResourceManager success");
+    } else {
+        OH_LOG_DEBUG(LogType::LOG_APP, "NativeResourceManager fail");
+    }
+
+    napi_value str = args[1];
+    std::string sanbox_path = value_to_string(env, str);
+    OH_LOG_DEBUG(LogType::LOG_APP, "sanbox path:%{public}s", sanbox_path.c_str());
+
+    // 获取模型类型（如"yolov8n", "yolov8s"等）
+    napi_value model_type_value = args[2];
+    std::string model_type = value_to_string(env, model_type_value);
+    OH_LOG_DEBUG(LogType::LOG_APP, "model type:%{public}s", model_type.c_str());
 
     // 参数
     ncnn::Option option = get_option_from_napi(env, args[3], args[4]);
+    int powersave = get_powersave_from_napi(env, args[4]);
+    apply_saved_autotune(env, args[4], sanbox_path, model_type, option, powersave);
 
-    int loop;
-    napi_get_value_int32(env, args[5], &loop);
+    // 模型文件优先从rawfile映射，沙盒中的文件作为后备
+    std::unique_ptr<modelloader::ModelData> model_data = load_model_data(mNativeResMgr, sanbox_path, model_type);
+    std::shared_ptr<detector::Instance> instance = detector::create(model_type, option, std::move(model_data), powersave);
+    if (mNativeResMgr != nullptr) {
+        OH_ResourceManager_ReleaseNativeResourceManager(mNativeResMgr);
+    }
+    // 初始化失败时保留原有实例
+    if (instance) {
+        set_default_instance(g_yolov8, instance);
+    }
+
+    const char *r_str = instance ? "success" : "fail";
+    napi_value nr_str;
+    napi_create_string_utf8(env, r_str, strlen(r_str), &nr_str);
+    return nr_str;
+}
+
+/**
+ * YOLOv8识别（增强版，支持透传数据和SNHA标签映射）
+ */
+static napi_value YOLOv8Run(napi_env env, napi_callback_info info) {
+    size_t argc = 7;  // 增加参数数量
+    napi_value args[7] = {nullptr};
+    napi_get_cb_info(env, info, &argc, args, nullptr, nullptr);
+
+    void *data = nullptr;
+    size_t byte_length = 0;
+    napi_status status = napi_get_arraybuffer_info(env, args[0], &data, &byte_length);
+    if (status != napi_ok) {
+        OH_LOG_DEBUG(LogType::LOG_APP, "Failed to get ArrayBuffer info");
+        return nullptr;
+    }
+    OH_LOG_DEBUG(LogType::LOG_APP, "byte length:%{public}zu", byte_length);
     
-    double time_min = 0;
-    double time_max = 0;
-    double time_avg = 0;
-    int input_width = 0, input_height = 0;
-    benchmark::BenchmarkNet net;
-    benchmark::DataReaderFromEmpty dr;
-    net.opt = option;
-    std::string model_path = sanbox_path + "/" + param_name;
-    OH_LOG_DEBUG(LogType::LOG_APP, "model path:%{public}s", model_path.c_str());
-    int rp = net.load_param(model_path.c_str());
-    int rm = net.load_model(dr);
-    OH_LOG_DEBUG(LogType::LOG_APP, "benchmark load:%{public}d %{public}d", rp, rm);
-    benchmark::BenchmarkResult benchmarkResult =
-        net.run(loop, time_min, time_max, time_avg, input_width, input_height, g_models_size.at(model_name));
-    net.clear();
+    int width;
+    int height;
+    napi_get_value_int32(env, args[1], &width);
+    napi_get_value_int32(env, args[2], &height);
+    OH_LOG_DEBUG(LogType::LOG_APP, "image size:%{public}d x %{public}d", width, height);
 
-    OH_LOG_DEBUG(LogType::LOG_APP, "benchmark min:%{public}f max:%{public}f avg:%{public}f", time_min, time_max,
-                 time_avg);
+    // 获取模型类型（可选，默认yolov8n）与透传数据（可选）
+    std::string model_type = optional_string_arg(env, args, argc, 3, "yolov8n");
+    std::string user_id = optional_string_arg(env, args, argc, 4, "");
+    std::string uuid = optional_string_arg(env, args, argc, 5, "");
+    std::string time_sent = optional_string_arg(env, args, argc, 6, "");
+    
+    OH_LOG_DEBUG(LogType::LOG_APP, "model:%{public}s, userId:%{public}s", 
+                 model_type.c_str(), user_id.c_str());
 
-    napi_value js_result = convert_benchmark_to_js(env, benchmarkResult);
+    ncnn::Mat input = ncnn::Mat(width, height, 4, data);
+    OH_LOG_DEBUG(LogType::LOG_APP, "mat size:%{public}d x %{public}d x %{public}d", input.w, input.h, input.c);
 
-    return js_result;
+    // 执行推理，传入透传数据
+    return run_instance(env, get_default_instance(g_yolov8), input, width, height, user_id, uuid, time_sent);
 }
 
-// --------------------------------------------[ benchmark end ]--------------------------------------------
+/**
+ * YOLOv8识别（相机NV21原始帧，旋转/颜色转换/缩放在native完成）
+ * 参数: nv21数据, 宽, 高, 行跨度, 顺时针旋转角度, [模型类型, 用户ID, uuid, 时间戳]
+ */
+static napi_value YOLOv8RunNV21(napi_env env, napi_callback_info info) {
+    size_t argc = 9;
+    napi_value args[9] = {nullptr};
+    napi_get_cb_info(env, info, &argc, args, nullptr, nullptr);
+
+    void *data = nullptr;
+    size_t byte_length = 0;
+    napi_status status = napi_get_arraybuffer_info(env, args[0], &data, &byte_length);
+    if (status != napi_ok) {
+        OH_LOG_DEBUG(LogType::LOG_APP, "Failed to get ArrayBuffer info");
+        return nullptr;
+    }
+
+    int width;
+    int height;
+    int stride;
+    int rotation;
+    napi_get_value_int32(env, args[1], &width);
+    napi_get_value_int32(env, args[2], &height);
+    napi_get_value_int32(env, args[3], &stride);
+    napi_get_value_int32(env, args[4], &rotation);
+    if (stride < width) {
+        stride = width;
+    }
+    OH_LOG_DEBUG(LogType::LOG_APP, "nv21 size:%{public}d x %{public}d, stride:%{public}d, rotation:%{public}d",
+                 width, height, stride, rotation);
+    if (!yolo::valid_nv21(width, height, rotation)) {
+        OH_LOG_DEBUG(LogType::LOG_APP, "invalid nv21 frame");
+        return nullptr;
+    }
+
+    // NV21: Y平面 stride*height + VU平面 stride*height/2
+    if (byte_length < (size_t)stride * height * 3 / 2) {
+        OH_LOG_DEBUG(LogType::LOG_APP, "nv21 buffer too small:%{public}zu", byte_length);
+        return nullptr;
+    }
+    std::shared_ptr<detector::Instance> instance = get_default_instance(g_yolov8);
+    if (!instance) {
+        OH_LOG_DEBUG(LogType::LOG_APP, "yolov8 not initialized");
+        return nullptr;
+    }
+
+    std::string user_id = optional_string_arg(env, args, argc, 6, "");
+    std::string uuid = optional_string_arg(env, args, argc, 7, "");
+    std::string time_sent = optional_string_arg(env, args, argc, 8, "");
+
+    return run_instance_nv21(env, instance, static_cast<const unsigned char *>(data), width, height, stride, rotation,
+                             user_id, uuid, time_sent);
+}
+
+/**
+ * 设置YOLOv8阈值
+ * 参数: 置信度阈值, NMS阈值, [每个类别的置信度阈值数组]
+ */
+static napi_value YOLOv8SetThresholds(napi_env env, napi_callback_info info) {
+    size_t argc = 3;
+    napi_value args[3] = {nullptr};
+    napi_get_cb_info(env, info, &argc, args, nullptr, nullptr);
+    return set_instance_thresholds(env, get_default_instance(g_yolov8), args, argc);
+}
+
+// --------------------------------------------[ yolov8 end ]--------------------------------------------
+
+// --------------------------------------------[ benchmark start ]--------------------------------------------
+
+static const std::map<std::string, int> g_models_size = {
+    // {"YOLOv4-tiny", 416},  // YOLOv4已移除
+    {"nanodet-m", 320},
+    {"yolov8n", 640},
+    {"yolov8s", 640},
+    {"yolov8m", 640},
+    {"yolov8l", 640},
+    {"yolov8x", 640},
+};
+
+// 模型输入尺寸，未登记的模型按640（工作线程中调用，不能抛出异常）
+static int model_input_size(const std::string &model_name) {
+    std::map<std::string, int>::const_iterator size_it = g_models_size.find(model_name);
+    return size_it != g_models_size.end() ? size_it->second : 640;
+}
+
+static void set_double_property(napi_env env, napi_value object, const char *key, double value) {
+    napi_value js_value;
+    napi_create_double(env, value, &js_value);
+    napi_set_named_property(env, object, key, js_value);
+}
+
+// 逐层耗时表 [{name, type, count, total, avg, max, percent}]，percent为占所有层累计耗时的百分比
+static napi_value convert_layer_stats_to_js(napi_env env, const std::vector<profiler::LayerStat> &stats,
+                                           double layers_total) {
+    napi_value js_array;
+    napi_create_array_with_length(env, stats.size(), &js_array);
+    for (size_t i = 0; i < stats.size(); i++) {
+        const profiler::LayerStat &stat = stats[i];
+        napi_value js_stat, name, type;
+        napi_create_object(env, &js_stat);
+        napi_create_string_utf8(env, stat.name.c_str(), NAPI_AUTO_LENGTH, &name);
+        napi_create_string_utf8(env, stat.type.c_str(), NAPI_AUTO_LENGTH, &type);
+        napi_set_named_property(env, js_stat, "name", name);
+        napi_set_named_property(env, js_stat, "type", type);
+        set_double_property(env, js_stat, "count", stat.count);
+        set_double_property(env, js_stat, "total", stat.total);
+        set_double_property(env, js_stat, "avg", stat.count > 0 ? stat.total / stat.count : 0);
+        set_double_property(env, js_stat, "max", stat.max);
+        set_double_property(env, js_stat, "percent", layers_total > 0 ? stat.total * 100 / layers_total : 0);
+        napi_set_element(env, js_array, i, js_stat);
+    }
+    return js_array;
+}
+
+/**
+ * 基准测试结果转换为JS对象，耗时均为毫秒（double）
+ * {loop, min, max, avg, p50, p90, p99, stddev, cold, drift, warmupLoops, warmupMs,
+ *  histogram: {min, width, counts: number[]}, samples: number[], width, height,
+ *  [layers: {total, byName, byType, trace}]}
+ */
+napi_value convert_benchmark_to_js(napi_env env, const benchmark::BenchmarkResult &result) {
+    napi_value js_object;
+    napi_create_object(env, &js_object);
+
+    set_double_property(env, js_object, "loop", result.loop);
+    set_double_property(env, js_object, "min", result.min);
+    set_double_property(env, js_object, "max", result.max);
+    set_double_property(env, js_object, "avg", result.avg);
+    set_double_property(env, js_object, "p50", result.p50);
+    set_double_property(env, js_object, "p90", result.p90);
+    set_double_property(env, js_object, "p99", result.p99);
+    set_double_property(env, js_object, "stddev", result.stddev);
+    set_double_property(env, js_object, "cold", result.cold);
+    set_double_property(env, js_object, "drift", result.drift);
+    set_double_property(env, js_object, "warmupLoops", result.warmup_loops);
+    set_double_property(env, js_object, "warmupMs", result.warmup_ms);
+    set_double_property(env, js_object, "width", result.width);
+    set_double_property(env, js_object, "height", result.height);
+
+    napi_value histogram, counts;
+    napi_create_object(env, &histogram);
+    set_double_property(env, histogram, "min", result.min);
+    set_double_property(env, histogram, "width", result.histogram_width);
+    napi_create_array_with_length(env, result.histogram.size(), &counts);
+    for (size_t i = 0; i < result.histogram.size(); i++) {
+        napi_value count;
+        napi_create_int32(env, result.histogram[i], &count);
+        napi_set_element(env, counts, i, count);
+    }
+    napi_set_named_property(env, histogram, "counts", counts);
+    napi_set_named_property(env, js_object, "histogram", histogram);
+
+    napi_value samples;
+    napi_create_array_with_length(env, result.samples.size(), &samples);
+    for (size_t i = 0; i < result.samples.size(); i++) {
+        napi_value sample;
+        napi_create_double(env, result.samples[i], &sample);
+        napi_set_element(env, samples, i, sample);
+    }
+    napi_set_named_property(env, js_object, "samples", samples);
+
+    if (!result.layers_by_type.empty()) {
+        napi_value layers, trace;
+        napi_create_object(env, &layers);
+        set_double_property(env, layers, "total", result.layers_total);
+        napi_set_named_property(env, layers, "byName",
+                                convert_layer_stats_to_js(env, result.layers_by_name, result.layers_total));
+        napi_set_named_property(env, layers, "byType",
+                                convert_layer_stats_to_js(env, result.layers_by_type, result.layers_total));
+        napi_create_string_utf8(env, result.trace.c_str(), result.trace.size(), &trace);
+        napi_set_named_property(env, layers, "trace", trace);
+        napi_set_named_property(env, js_object, "layers", layers);
+    }
+
+    return js_object;
+}
+
+// 基准测试参数，param内容在JS线程读取，测试本身可以在工作线程执行
+typedef struct BenchmarkJob {
+    napi_async_work work;
+    napi_deferred deferred;
+    std::string sanbox_path;
+    std::string model_name;
+    std::string param_name;
+    std::string param_text;       // rawfile中的param内容，为空时从沙盒加载
+    ncnn::Option option;
+    int powersave;                // 测试期间绑定的核心（config.core）
+    int loop;
+    benchmark::RunSettings settings;
+    benchmark::BenchmarkResult result;
+} BenchmarkJob;
+
+/**
+ * 解析运行设置 {warmupLoops?, warmupMs?, cooldownMs?, profile?, topN?}，未提供的字段保持默认值
+ */
+static void parse_run_settings(napi_env env, napi_value value, benchmark::RunSettings &settings) {
+    napi_valuetype type = napi_undefined;
+    napi_typeof(env, value, &type);
+    if (type != napi_object) {
+        return;
+    }
+    bool has = false;
+    napi_value field;
+    if (napi_has_named_property(env, value, "warmupLoops", &has) == napi_ok && has) {
+        napi_get_named_property(env, value, "warmupLoops", &field);
+        napi_get_value_int32(env, field, &settings.warmup_loops);
+    }
+    if (napi_has_named_property(env, value, "warmupMs", &has) == napi_ok && has) {
+        napi_get_named_property(env, value, "warmupMs", &field);
+        napi_get_value_double(env, field, &settings.warmup_ms);
+    }
+    if (napi_has_named_property(env, value, "cooldownMs", &has) == napi_ok && has) {
+        napi_get_named_property(env, value, "cooldownMs", &field);
+        napi_get_value_double(env, field, &settings.cooldown_ms);
+    }
+    if (napi_has_named_property(env, value, "profile", &has) == napi_ok && has) {
+        napi_get_named_property(env, value, "profile", &field);
+        napi_get_value_bool(env, field, &settings.profile);
+    }
+    if (napi_has_named_property(env, value, "topN", &has) == napi_ok && has) {
+        napi_get_named_property(env, value, "topN", &field);
+        napi_get_value_int32(env, field, &settings.top_n);
+    }
+    settings.warmup_loops = std::max(settings.warmup_loops, 0);
+}
+
+/**
+ * 解析benchmark_ncnn的参数
+ * 参数: 沙盒路径, 模型名, param文件名, option, config, 循环次数, [resMgr], [预热与冷却设置]
+ */
+static void parse_benchmark_args(napi_env env, napi_value *args, size_t argc, BenchmarkJob &job) {
+    job.sanbox_path = value_to_string(env, args[0]);
+    job.model_name = value_to_string(env, args[1]);
+    job.param_name = value_to_string(env, args[2]);
+    OH_LOG_DEBUG(LogType::LOG_APP, "sanbox path:%{public}s, model name:%{public}s, param name:%{public}s",
+                 job.sanbox_path.c_str(), job.model_name.c_str(), job.param_name.c_str());
+
+    // 参数
+    job.option = get_option_from_napi(env, args[3], args[4]);
+    job.powersave = get_powersave_from_napi(env, args[4]);
+    job.loop = 0;
+    napi_get_value_int32(env, args[5], &job.loop);
+
+    // 可选的resource manager：直接读取rawfile中的param
+    NativeResourceManager *native_res_mgr = nullptr;
+    napi_valuetype res_mgr_type = napi_undefined;
+    if (argc >= 7) {
+        napi_typeof(env, args[6], &res_mgr_type);
+    }
+    if (res_mgr_type == napi_object) {
+        native_res_mgr = OH_ResourceManager_InitNativeResourceManager(env, args[6]);
+    }
+    job.param_text.clear();
+    if (native_res_mgr != nullptr) {
+        modelloader::read_rawfile_text(native_res_mgr, ("models/" + job.param_name).c_str(), job.param_text);
+        OH_ResourceManager_ReleaseNativeResourceManager(native_res_mgr);
+    }
+
+    job.settings = benchmark::RunSettings();
+    if (argc >= 8) {
+        parse_run_settings(env, args[7], job.settings);
+    }
+}
+
+/**
+ * 执行基准测试（不访问napi，可在工作线程调用）
+ */
+static benchmark::BenchmarkResult run_benchmark_job(const BenchmarkJob &job) {
+    corebinding::ScopedBinding binding(job.powersave);
+    benchmark::BenchmarkNet net;
+    benchmark::DataReaderFromEmpty dr;
+    net.opt = job.option;
+    // 计时层只支持CPU，GPU推理时替换后的层与GPU上的blob不兼容；逐层计时时必须在加载前改用CPU推理
+    if (job.settings.profile && net.opt.use_vulkan_compute) {
+        OH_LOG_DEBUG(LogType::LOG_APP, "benchmark profile requires cpu, vulkan disabled");
+        net.opt.use_vulkan_compute = false;
+    }
+    int rp = -1;
+    if (!job.param_text.empty()) {
+        rp = net.load_param_mem(job.param_text.c_str());
+    } else {
+        std::string model_path = job.sanbox_path + "/" + job.param_name;
+        OH_LOG_DEBUG(LogType::LOG_APP, "model path:%{public}s", model_path.c_str());
+        rp = net.load_param(model_path.c_str());
+    }
+    int rm = net.load_model(dr);
+    OH_LOG_DEBUG(LogType::LOG_APP, "benchmark load:%{public}d %{public}d", rp, rm);
+    benchmark::BenchmarkResult benchmarkResult = net.run(job.loop, model_input_size(job.model_name), job.settings);
+    net.clear();
+
+    OH_LOG_DEBUG(LogType::LOG_APP,
+                 "benchmark cold:%{public}.3f min:%{public}.3f p50:%{public}.3f p99:%{public}.3f avg:%{public}.3f "
+                 "stddev:%{public}.3f",
+                 benchmarkResult.cold, benchmarkResult.min, benchmarkResult.p50, benchmarkResult.p99,
+                 benchmarkResult.avg, benchmarkResult.stddev);
+    return benchmarkResult;
+}
+
+static napi_value BenchmarkNCNN(napi_env env, napi_callback_info info) {
+    size_t argc = 8;
+    napi_value args[8] = {nullptr};
+    // 获取参数信息
+    napi_get_cb_info(env, info, &argc, args, nullptr, nullptr);
+
+    BenchmarkJob job;
+    parse_benchmark_args(env, args, argc, job);
+    benchmark::BenchmarkResult benchmarkResult = run_benchmark_job(job);
+
+    napi_value js_result = convert_benchmark_to_js(env, benchmarkResult);
+
+    return js_result;
+}
+
+/**
+ * NMS微基准，分别对100/1000/10000个候选框执行按类别NMS
+ * 参数: 循环次数
+ * 返回: [{boxes, kept, min, avg}]
+ */
+static napi_value BenchmarkNMS(napi_env env, napi_callback_info info) {
+    size_t argc = 1;
+    napi_value args[1] = {nullptr};
+    napi_get_cb_info(env, info, &argc, args, nullptr, nullptr);
+
+    int loop = 100;
+    if (argc >= 1) {
+        napi_get_value_int32(env, args[0], &loop);
+    }
+
+    const int box_counts[3] = {100, 1000, 10000};
+    napi_value js_array;
+    napi_create_array_with_length(env, 3, &js_array);
+    for (int i = 0; i < 3; i++) {
+        benchmark::NmsBenchmarkResult result = benchmark::run_nms(box_counts[i], loop);
+        OH_LOG_DEBUG(LogType::LOG_APP, "benchmark nms boxes:%{public}d kept:%{public}d min:%{public}f avg:%{public}f",
+                     result.boxes, result.kept, result.min, result.avg);
+
+        napi_value js_object;
+        napi_create_object(env, &js_object);
+        napi_value boxes, kept, min, avg;
+        napi_create_int32(env, result.boxes, &boxes);
+        napi_create_int32(env, result.kept, &kept);
+        napi_create_double(env, result.min, &min);
+        napi_create_double(env, result.avg, &avg);
+        napi_set_named_property(env, js_object, "boxes", boxes);
+        napi_set_named_property(env, js_object, "kept", kept);
+        napi_set_named_property(env, js_object, "min", min);
+        napi_set_named_property(env, js_object, "avg", avg);
+        napi_set_element(env, js_array, i, js_object);
+    }
+
+    return js_array;
+}
+
+/**
+ * 结果转换基准，对比对象数组与打包结果
+ * 参数: 循环次数
+ * 返回: [{boxes, objects, packed}]，分别为10/100/300个框时两种方式的平均耗时（ms）
+ */
+static napi_value BenchmarkMarshal(napi_env env, napi_callback_info info) {
+    size_t argc = 1;
+    napi_value args[1] = {nullptr};
+    napi_get_cb_info(env, info, &argc, args, nullptr, nullptr);
+
+    int loop = 100;
+    if (argc >= 1) {
+        napi_get_value_int32(env, args[0], &loop);
+    }
+    if (loop < 1) {
+        loop = 1;
+    }
+
+    const std::string uuid = "00000000-0000-0000-0000-000000000000";
+    const std::string time_sent = "2024-01-01T00:00:00.000Z";
+    const int box_counts[3] = {10, 100, 300};
+    napi_value js_array;
+    napi_create_array_with_length(env, 3, &js_array);
+    for (int i = 0; i < 3; i++) {
+        std::vector<yolo::BoxInfo> boxes(box_counts[i]);
+        for (int k = 0; k < box_counts[i]; k++) {
+            yolo::BoxInfo &box = boxes[k];
+            box.x1 = (float)(k % 20) * 30.f;
+            box.y1 = (float)(k / 20) * 30.f;
+            box.x2 = box.x1 + 25.f;
+            box.y2 = box.y1 + 25.f;
+            box.score = 0.5f;
+            box.label = k % 80;
+        }
+
+        // 每次转换在独立的handle scope中进行，避免累积的句柄影响计时
+        double time_objects = 0;
+        double time_packed = 0;
+        for (int l = 0; l < loop; l++) {
+            napi_handle_scope scope;
+            napi_open_handle_scope(env, &scope);
+            double start = ncnn::get_current_time();
+            convert_boxes_to_js_yolo(env, boxes, "", uuid, time_sent);
+            time_objects += ncnn::get_current_time() - start;
+            napi_close_handle_scope(env, scope);
+
+            napi_open_handle_scope(env, &scope);
+            start = ncnn::get_current_time();
+            convert_boxes_to_js_packed(env, boxes, uuid, time_sent);
+            time_packed += ncnn::get_current_time() - start;
+            napi_close_handle_scope(env, scope);
+        }
+        OH_LOG_DEBUG(LogType::LOG_APP, "benchmark marshal boxes:%{public}d objects:%{public}f packed:%{public}f",
+                     box_counts[i], time_objects / loop, time_packed / loop);
+
+        napi_value js_object, js_boxes, js_objects, js_packed;
+        napi_create_object(env, &js_object);
+        napi_create_int32(env, box_counts[i], &js_boxes);
+        napi_create_double(env, time_objects / loop, &js_objects);
+        napi_create_double(env, time_packed / loop, &js_packed);
+        napi_set_named_property(env, js_object, "boxes", js_boxes);
+        napi_set_named_property(env, js_object, "objects", js_objects);
+        napi_set_named_property(env, js_object, "packed", js_packed);
+        napi_set_element(env, js_array, i, js_object);
+    }
+
+    return js_array;
+}
+
+// --------------------------------------------[ benchmark end ]--------------------------------------------
+
+// --------------------------------------------[ async start ]--------------------------------------------
+// 异步识别任务：预处理、推理与后处理在napi工作线程执行，完成后在JS线程转换结果并兑现Promise
+// 同一实例上新排队的任务会使之前排队、尚未开始的任务过期，过期任务不推理，Promise以SUPERSEDED拒绝
+typedef struct DetectJob {
+    napi_async_work work;
+    napi_deferred deferred;
+    napi_ref buffer_ref;                           // 固定输入ArrayBuffer，任务完成前不被回收，无需拷贝
+    std::shared_ptr<detector::Instance> instance;  // 推理期间保持实例存活
+    const unsigned char *data;
+    int width;
+    int height;
+    int stride;                                    // 仅NV21
+    int rotation;                                  // 仅NV21
+    bool nv21;
+    std::string user_id;
+    std::string uuid;
+    std::string time_sent;
+    unsigned int seq;
+    detector::Status status;
+    detector::Result result;
+} DetectJob;
+
+/**
+ * 以 {code, message} 错误拒绝Promise
+ */
+static void reject_deferred(napi_env env, napi_deferred deferred, const char *code, const char *message) {
+    napi_value js_code, js_message, error;
+    napi_create_string_utf8(env, code, NAPI_AUTO_LENGTH, &js_code);
+    napi_create_string_utf8(env, message, NAPI_AUTO_LENGTH, &js_message);
+    napi_create_error(env, js_code, js_message, &error);
+    napi_reject_deferred(env, deferred, error);
+}
+
+static void detect_job_execute(napi_env env, void *data) {
+    DetectJob *job = static_cast<DetectJob *>(data);
+    if (job->nv21) {
+        job->status = detector::run_nv21(*job->instance, job->data, job->width, job->height, job->stride,
+                                         job->rotation, job->result, job->seq);
+    } else {
+        job->status =
+            detector::run(*job->instance, job->data, job->width, job->height, job->result, job->seq);
+    }
+}
+
+static void detect_job_complete(napi_env env, napi_status status, void *data) {
+    DetectJob *job = static_cast<DetectJob *>(data);
+    if (status == napi_ok && job->status == detector::STATUS_OK) {
+        napi_value js_result =
+            convert_result_to_js(env, *job->instance, job->result, job->user_id, job->uuid, job->time_sent);
+        napi_resolve_deferred(env, job->deferred, js_result);
+    } else if (status == napi_cancelled || job->status == detector::STATUS_SUPERSEDED) {
+        reject_deferred(env, job->deferred, "SUPERSEDED", "superseded by a newer frame");
+    } else {
+        reject_deferred(env, job->deferred, "NOT_READY", "detector not initialized or input not supported");
+    }
+
+    napi_delete_reference(env, job->buffer_ref);
+    napi_delete_async_work(env, job->work);
+    delete job;
+}
+
+/**
+ * 排队异步识别任务
+ * @param buffer 输入ArrayBuffer（引用到任务完成）
+ * @return Promise，job的所有权转移给任务
+ */
+static napi_value queue_detect_job(napi_env env, napi_value buffer, DetectJob *job) {
+    napi_value promise;
+    napi_create_promise(env, &job->deferred, &promise);
+    if (!job->instance) {
+        reject_deferred(env, job->deferred, "NOT_READY", "detector not initialized");
+        delete job;
+        return promise;
+    }
+
+    napi_create_reference(env, buffer, 1, &job->buffer_ref);
+    job->seq = detector::next_seq(*job->instance);
+
+    napi_value resource_name;
+    napi_create_string_utf8(env, "tncnnDetect", NAPI_AUTO_LENGTH, &resource_name);
+    napi_create_async_work(env, nullptr, resource_name, detect_job_execute, detect_job_complete, job, &job->work);
+    napi_queue_async_work(env, job->work);
+    return promise;
+}
+
+/**
+ * 创建异步识别任务并读取图像参数
+ * 参数从args[first]开始: 图像数据, 宽, 高；nv21时还有行跨度, 顺时针旋转角度
+ * @return 参数无效时返回nullptr
+ */
+static DetectJob *create_detect_job(napi_env env, napi_value *args, size_t argc, size_t first, bool nv21) {
+    void *data = nullptr;
+    size_t byte_length = 0;
+    if (argc < first + (nv21 ? 5 : 3) || napi_get_arraybuffer_info(env, args[first], &data, &byte_length) != napi_ok) {
+        OH_LOG_DEBUG(LogType::LOG_APP, "Failed to get ArrayBuffer info");
+        return nullptr;
+    }
+
+    DetectJob *job = new DetectJob();
+    job->data = static_cast<const unsigned char *>(data);
+    job->nv21 = nv21;
+    job->width = 0;
+    job->height = 0;
+    job->stride = 0;
+    job->rotation = 0;
+    job->status = detector::STATUS_NOT_READY;
+    napi_get_value_int32(env, args[first + 1], &job->width);
+    napi_get_value_int32(env, args[first + 2], &job->height);
+    size_t required = (size_t)job->width * job->height * 4;
+    if (nv21) {
+        napi_get_value_int32(env, args[first + 3], &job->stride);
+        napi_get_value_int32(env, args[first + 4], &job->rotation);
+        if (job->stride < job->width) {
+            job->stride = job->width;
+        }
+        // NV21: Y平面 stride*height + VU平面 stride*height/2
+        required = (size_t)job->stride * job->height * 3 / 2;
+    }
+    if (job->width <= 0 || job->height <= 0 || byte_length < required) {
+        OH_LOG_DEBUG(LogType::LOG_APP, "image buffer too small:%{public}zu", byte_length);
+        delete job;
+        return nullptr;
+    }
+    if (nv21 && !yolo::valid_nv21(job->width, job->height, job->rotation)) {
+        OH_LOG_DEBUG(LogType::LOG_APP, "invalid nv21 frame %{public}dx%{public}d rotation:%{public}d", job->width,
+                     job->height, job->rotation);
+        delete job;
+        return nullptr;
+    }
+    return job;
+}
+
+/**
+ * 参数无效时返回已拒绝的Promise
+ */
+static napi_value rejected_promise(napi_env env, const char *code, const char *message) {
+    napi_deferred deferred;
+    napi_value promise;
+    napi_create_promise(env, &deferred, &promise);
+    reject_deferred(env, deferred, code, message);
+    return promise;
+}
+
+/**
+ * 异步识别RGBA图像
+ * 参数: 句柄或id, 图像数据, 宽, 高, [用户ID, uuid, 时间戳]
+ */
+static napi_value DetectorRunAsync(napi_env env, napi_callback_info info) {
+    size_t argc = 7;
+    napi_value args[7] = {nullptr};
+    napi_get_cb_info(env, info, &argc, args, nullptr, nullptr);
+
+    DetectJob *job = create_detect_job(env, args, argc, 1, false);
+    if (job == nullptr) {
+        return rejected_promise(env, "INVALID_ARGUMENT", "invalid image buffer");
+    }
+    job->instance = instance_from_arg(env, args[0]);
+    job->user_id = optional_string_arg(env, args, argc, 4, "");
+    job->uuid = optional_string_arg(env, args, argc, 5, "");
+    job->time_sent = optional_string_arg(env, args, argc, 6, "");
+    return queue_detect_job(env, args[1], job);
+}
+
+/**
+ * 异步识别NV21相机帧（仅YOLOv8）
+ * 参数: 句柄或id, nv21数据, 宽, 高, 行跨度, 顺时针旋转角度, [用户ID, uuid, 时间戳]
+ */
+static napi_value DetectorRunNV21Async(napi_env env, napi_callback_info info) {
+    size_t argc = 9;
+    napi_value args[9] = {nullptr};
+    napi_get_cb_info(env, info, &argc, args, nullptr, nullptr);
+
+    DetectJob *job = create_detect_job(env, args, argc, 1, true);
+    if (job == nullptr) {
+        return rejected_promise(env, "INVALID_ARGUMENT",
+                                "invalid nv21 frame: width and height must be even and at least 4, rotation "
+                                "0/90/180/270, buffer at least stride * height * 3 / 2");
+    }
+    job->instance = instance_from_arg(env, args[0]);
+    job->user_id = optional_string_arg(env, args, argc, 6, "");
+    job->uuid = optional_string_arg(env, args, argc, 7, "");
+    job->time_sent = optional_string_arg(env, args, argc, 8, "");
+    return queue_detect_job(env, args[1], job);
+}
+
+/**
+ * 取消实例上所有排队中的异步识别（正在执行的不受影响）
+ * 参数: 句柄或id
+ */
+static napi_value DetectorCancel(napi_env env, napi_callback_info info) {
+    size_t argc = 1;
+    napi_value args[1] = {nullptr};
+    napi_get_cb_info(env, info, &argc, args, nullptr, nullptr);
+
+    std::shared_ptr<detector::Instance> instance = instance_from_arg(env, args[0]);
+    if (instance) {
+        detector::next_seq(*instance);
+    }
+    napi_value result;
+    napi_get_boolean(env, instance != nullptr, &result);
+    return result;
+}
+
+/**
+ * 异步YOLOv8识别（默认实例）
+ * 参数同yolov8_run
+ */
+static napi_value YOLOv8RunAsync(napi_env env, napi_callback_info info) {
+    size_t argc = 7;
+    napi_value args[7] = {nullptr};
+    napi_get_cb_info(env, info, &argc, args, nullptr, nullptr);
+
+    DetectJob *job = create_detect_job(env, args, argc, 0, false);
+    if (job == nullptr) {
+        return rejected_promise(env, "INVALID_ARGUMENT", "invalid image buffer");
+    }
+    job->instance = get_default_instance(g_yolov8);
+    job->user_id = optional_string_arg(env, args, argc, 4, "");
+    job->uuid = optional_string_arg(env, args, argc, 5, "");
+    job->time_sent = optional_string_arg(env, args, argc, 6, "");
+    return queue_detect_job(env, args[0], job);
+}
+
+/**
+ * 异步NanoDet识别（默认实例）
+ * 参数同nanodet_run
+ */
+static napi_value NanoDetRunAsync(napi_env env, napi_callback_info info) {
+    size_t argc = 3;
+    napi_value args[3] = {nullptr};
+    napi_get_cb_info(env, info, &argc, args, nullptr, nullptr);
+
+    DetectJob *job = create_detect_job(env, args, argc, 0, false);
+    if (job == nullptr) {
+        return rejected_promise(env, "INVALID_ARGUMENT", "invalid image buffer");
+    }
+    job->instance = get_default_instance(g_nanodet);
+    return queue_detect_job(env, args[0], job);
+}
+
+static void benchmark_job_execute(napi_env env, void *data) {
+    BenchmarkJob *job = static_cast<BenchmarkJob *>(data);
+    job->result = run_benchmark_job(*job);
+}
+
+static void benchmark_job_complete(napi_env env, napi_status status, void *data) {
+    BenchmarkJob *job = static_cast<BenchmarkJob *>(data);
+    if (status == napi_ok) {
+        napi_resolve_deferred(env, job->deferred, convert_benchmark_to_js(env, job->result));
+    } else {
+        reject_deferred(env, job->deferred, "CANCELLED", "benchmark cancelled");
+    }
+    napi_delete_async_work(env, job->work);
+    delete job;
+}
+
+/**
+ * 异步基准测试，不阻塞UI线程
+ * 参数同benchmark_ncnn
+ */
+static napi_value BenchmarkNCNNAsync(napi_env env, napi_callback_info info) {
+    size_t argc = 8;
+    napi_value args[8] = {nullptr};
+    napi_get_cb_info(env, info, &argc, args, nullptr, nullptr);
+
+    BenchmarkJob *job = new BenchmarkJob();
+    parse_benchmark_args(env, args, argc, *job);
+
+    napi_value promise;
+    napi_create_promise(env, &job->deferred, &promise);
+    napi_value resource_name;
+    napi_create_string_utf8(env, "tncnnBenchmark", NAPI_AUTO_LENGTH, &resource_name);
+    napi_create_async_work(env, nullptr, resource_name, benchmark_job_execute, benchmark_job_complete, job,
+                           &job->work);
+    napi_queue_async_work(env, job->work);
+    return promise;
+}
+
+// 选项组合测试
+typedef struct SweepJob {
+    napi_async_work work;
+    napi_deferred deferred;
+    BenchmarkJob args;          // 只使用其中的参数
+    std::string report;         // JSON结果
+} SweepJob;
+
+static void sweep_job_execute(napi_env env, void *data) {
+    SweepJob *job = static_cast<SweepJob *>(data);
+    const BenchmarkJob &args = job->args;
+    corebinding::ScopedBinding binding(args.powersave);
+    std::vector<benchmark::SweepEntry> entries =
+        benchmark::run_sweep(args.param_text, args.sanbox_path + "/" + args.param_name, args.option,
+                             model_input_size(args.model_name), args.loop, args.settings);
+    job->report = benchmark::sweep_to_json(args.model_name, entries);
+
+    // 同时保存到沙盒，可用hdc file recv取出比较
+    std::string path = args.sanbox_path + "/benchmark_sweep_" + args.model_name + ".json";
+    std::ofstream file(path, std::ios::trunc);
+    file << job->report;
+    OH_LOG_DEBUG(LogType::LOG_APP, "sweep report:%{public}s saved:%{public}d", path.c_str(), file.good());
+}
+
+static void sweep_job_complete(napi_env env, napi_status status, void *data) {
+    SweepJob *job = static_cast<SweepJob *>(data);
+    if (status == napi_ok) {
+        napi_value report;
+        napi_create_string_utf8(env, job->report.c_str(), job->report.size(), &report);
+        napi_resolve_deferred(env, job->deferred, report);
+    } else {
+        reject_deferred(env, job->deferred, "CANCELLED", "benchmark sweep cancelled");
+    }
+    napi_delete_async_work(env, job->work);
+    delete job;
+}
+
+/**
+ * 选项组合测试：在option基础上遍历winograd/sgemm/packing/lightMode与精度（fp32/bf16/fp16）的组合，
+ * 不支持的精度按CPU特性跳过，每个组合循环loop次
+ * 参数同benchmark_ncnn（option中的上述开关被覆盖）
+ * @return Promise<JSON字符串>，results按p50升序，包含各组合的耗时百分位与内存峰值
+ */
+static napi_value BenchmarkSweep(napi_env env, napi_callback_info info) {
+    size_t argc = 8;
+    napi_value args[8] = {nullptr};
+    napi_get_cb_info(env, info, &argc, args, nullptr, nullptr);
+
+    SweepJob *job = new SweepJob();
+    parse_benchmark_args(env, args, argc, job->args);
+    job->args.loop = std::max(job->args.loop, 1);
+
+    napi_value promise;
+    napi_create_promise(env, &job->deferred, &promise);
+    napi_value resource_name;
+    napi_create_string_utf8(env, "tncnnBenchmarkSweep", NAPI_AUTO_LENGTH, &resource_name);
+    napi_create_async_work(env, nullptr, resource_name, sweep_job_execute, sweep_job_complete, job, &job->work);
+    napi_queue_async_work(env, job->work);
+    return promise;
+}
+
+// 端到端基准测试的一张图像（RGBA，在JS线程拷贝）
+typedef struct PipelineImage {
+    std::vector<unsigned char> rgba;
+    int width;
+    int height;
+} PipelineImage;
+
+// 读取可选的整数属性，缺省时保持原值
+static void get_int_option(napi_env env, napi_value options, const char *key, int &value) {
+    bool has = false;
+    napi_value field;
+    if (napi_has_named_property(env, options, key, &has) == napi_ok && has) {
+        napi_get_named_property(env, options, key, &field);
+        napi_get_value_int32(env, field, &value);
+    }
+}
+
+// 读取可选的数值属性，缺省时保持原值
+static void get_double_option(napi_env env, napi_value options, const char *key, double &value) {
+    bool has = false;
+    napi_value field;
+    if (napi_has_named_property(env, options, key, &has) == napi_ok && has) {
+        napi_get_named_property(env, options, key, &field);
+        napi_get_value_double(env, field, &value);
+    }
+}
+
+/**
+ * 在JS线程拷贝测试图像 [{data: ArrayBuffer(RGBA), width, height}]，测试期间不再访问JS对象
+ * @return 数组为空或有无效图像时返回false
+ */
+static bool copy_pipeline_images(napi_env env, napi_value value, std::vector<PipelineImage> &images) {
+    uint32_t image_count = 0;
+    napi_get_array_length(env, value, &image_count);
+    for (uint32_t i = 0; i < image_count; i++) {
+        napi_value js_image, js_data, js_width, js_height;
+        napi_get_element(env, value, i, &js_image);
+        napi_get_named_property(env, js_image, "data", &js_data);
+        napi_get_named_property(env, js_image, "width", &js_width);
+        napi_get_named_property(env, js_image, "height", &js_height);
+
+        PipelineImage image;
+        void *pixels = nullptr;
+        size_t byte_length = 0;
+        napi_get_value_int32(env, js_width, &image.width);
+        napi_get_value_int32(env, js_height, &image.height);
+        if (napi_get_arraybuffer_info(env, js_data, &pixels, &byte_length) != napi_ok || image.width <= 0 ||
+            image.height <= 0 || byte_length < (size_t)image.width * image.height * 4) {
+            return false;
+        }
+        image.rgba.assign((unsigned char *)pixels, (unsigned char *)pixels + (size_t)image.width * image.height * 4);
+        images.push_back(std::move(image));
+    }
+    return !images.empty();
+}
+
+// 端到端基准测试：模型在工作线程创建（真实权重），结果转换在JS线程计时
+typedef struct PipelineJob {
+    napi_async_work work;
+    napi_deferred deferred;
+    std::string model_type;
+    ncnn::Option option;
+    int powersave;                  // 实例推理绑定的核心（见detector::Instance::powersave）
+    std::unique_ptr<modelloader::ModelData> model;
+    std::shared_ptr<detector::Instance> instance;
+    std::vector<PipelineImage> images;
+    int loop;
+    benchmark::RunSettings settings;
+    std::vector<detector::Result> results;   // 每轮每张图的结果
+    std::vector<double> totals;              // 每次识别的总耗时
+    arena::Stats warm_memory;                // 预热后与测试结束时的blob内存统计
+    arena::Stats end_memory;
+} PipelineJob;
+
+static void pipeline_job_execute(napi_env env, void *data) {
+    PipelineJob *job = static_cast<PipelineJob *>(data);
+    job->instance = detector::create(job->model_type, job->option, std::move(job->model), job->powersave);
+    if (!job->instance) {
+        return;
+    }
+
+    detector::Result result;
+    for (int i = 0; i < job->settings.warmup_loops; i++) {
+        for (const PipelineImage &image : job->images) {
+            detector::run(*job->instance, image.rgba.data(), image.width, image.height, result);
+        }
+    }
+    detector::memory_stats(*job->instance, job->warm_memory);
+
+    job->results.reserve((size_t)job->loop * job->images.size());
+    job->totals.reserve(job->results.capacity());
+    for (int i = 0; i < job->loop; i++) {
+        for (const PipelineImage &image : job->images) {
+            double start = ncnn::get_current_time();
+            detector::run(*job->instance, image.rgba.data(), image.width, image.height, result);
+            job->totals.push_back(ncnn::get_current_time() - start);
+            job->results.push_back(result);
+        }
+    }
+    detector::memory_stats(*job->instance, job->end_memory);
+}
+
+static void pipeline_job_complete(napi_env env, napi_status status, void *data) {
+    PipelineJob *job = static_cast<PipelineJob *>(data);
+    if (status != napi_ok) {
+        reject_deferred(env, job->deferred, "CANCELLED", "pipeline benchmark cancelled");
+    } else if (!job->instance) {
+        reject_deferred(env, job->deferred, "NOT_READY", "detector init failed");
+    } else {
+        const char *names[] = {"convert", "resize", "normalize", "forward", "decode", "nms", "marshal", "total"};
+        const int stage_count = sizeof(names) / sizeof(names[0]);
+        std::vector<benchmark::BenchmarkResult> stages(stage_count, benchmark::BenchmarkResult());
+        double detections = 0;
+        for (size_t i = 0; i < job->results.size(); i++) {
+            const detector::Result &result = job->results[i];
+            // 结果转换在JS线程执行，每次使用独立的handle scope，避免对象累积影响计时
+            napi_handle_scope scope;
+            napi_open_handle_scope(env, &scope);
+            double start = ncnn::get_current_time();
+            convert_result_to_js(env, *job->instance, result, "", "", "");
+            double marshal = ncnn::get_current_time() - start;
+            napi_close_handle_scope(env, scope);
+
+            const double times[] = {result.stages.convert, result.stages.resize, result.stages.normalize,
+                                    result.stages.forward, result.stages.decode, result.stages.nms,
+                                    marshal, job->totals[i] + marshal};
+            for (int j = 0; j < stage_count; j++) {
+                stages[j].samples.push_back(times[j]);
+            }
+            detections += job->instance->nanodet ? result.nanodet_boxes.size() : result.yolo_boxes.size();
+        }
+
+        napi_value js_result, js_stages, model_type;
+        napi_create_object(env, &js_result);
+        napi_create_object(env, &js_stages);
+        for (int j = 0; j < stage_count; j++) {
+            benchmark::compute_stats(stages[j]);
+            napi_set_named_property(env, js_stages, names[j], convert_benchmark_to_js(env, stages[j]));
+        }
+        napi_create_string_utf8(env, job->model_type.c_str(), NAPI_AUTO_LENGTH, &model_type);
+        napi_set_named_property(env, js_result, "modelType", model_type);
+        set_double_property(env, js_result, "images", job->images.size());
+        set_double_property(env, js_result, "loop", job->loop);
+        set_double_property(env, js_result, "detections",
+                            job->results.empty() ? 0 : detections / job->results.size());
+        napi_set_named_property(env, js_result, "stages", js_stages);
+
+        // 稳定状态检查：预热之后推理blob应全部来自arena（仅arena开启时，即mempool开启且option未指定分配器）
+        bool arena_used = job->end_memory.frames > 0;
+        size_t allocations = job->end_memory.allocations - job->warm_memory.allocations;
+        size_t fallbacks = job->end_memory.fallback_allocations - job->warm_memory.fallback_allocations;
+        if (arena_used && fallbacks != 0) {
+            OH_LOG_DEBUG(LogType::LOG_APP, "steady state check failed: %{public}zu blob fallbacks after warmup",
+                         fallbacks);
+        }
+        napi_value js_memory, js_steady;
+        napi_create_object(env, &js_memory);
+        set_double_property(env, js_memory, "allocations", allocations);
+        set_double_property(env, js_memory, "fallbackAllocations", fallbacks);
+        set_double_property(env, js_memory, "arenaCapacity", job->end_memory.capacity);
+        napi_get_boolean(env, arena_used && fallbacks == 0, &js_steady);
+        napi_set_named_property(env, js_memory, "steadyState", js_steady);
+        napi_set_named_property(env, js_result, "memory", js_memory);
+        napi_resolve_deferred(env, job->deferred, js_result);
+    }
+    napi_delete_async_work(env, job->work);
+    delete job;
+}
+
+/**
+ * 端到端基准测试：使用真实权重的检测器识别真实图像，分别统计各阶段耗时
+ * 参数: resMgr, 沙盒路径, 模型类型, option, config, 图像数组[{data: ArrayBuffer(RGBA), width, height}], 循环次数,
+ *       [运行设置，仅使用warmupLoops]
+ * @return Promise<{modelType, images, loop, detections, stages: {convert, resize, normalize, forward, decode, nms,
+ *         marshal, total}, memory}>，每个阶段为完整的耗时统计（同benchmark_ncnn）；detections为平均检测框数
+ *         memory为预热后计时期间的推理blob分配 {allocations, fallbackAllocations, arenaCapacity, steadyState}，
+ *         steadyState表示使用了arena且预热后blob全部来自arena（需warmupLoops >= 1；arena达到上限时溢出部分由内存池复用）
+ */
+static napi_value BenchmarkPipeline(napi_env env, napi_callback_info info) {
+    size_t argc = 8;
+    napi_value args[8] = {nullptr};
+    napi_get_cb_info(env, info, &argc, args, nullptr, nullptr);
+
+    std::unique_ptr<PipelineJob> job(new PipelineJob());
+    std::string sanbox_path = value_to_string(env, args[1]);
+    job->model_type = value_to_string(env, args[2]);
+    job->option = get_option_from_napi(env, args[3], args[4]);
+    job->powersave = get_powersave_from_napi(env, args[4]);
+    apply_saved_autotune(env, args[4], sanbox_path, job->model_type, job->option, job->powersave);
+    job->loop = 0;
+    napi_get_value_int32(env, args[6], &job->loop);
+    job->loop = std::max(job->loop, 1);
+    if (argc >= 8) {
+        parse_run_settings(env, args[7], job->settings);
+    }
+
+    if (!copy_pipeline_images(env, args[5], job->images)) {
+        return rejected_promise(env, "INVALID_ARGUMENT", "images must be RGBA data of width x height");
+    }
+
+    NativeResourceManager *native_res_mgr = OH_ResourceManager_InitNativeResourceManager(env, args[0]);
+    job->model = load_model_data(native_res_mgr, sanbox_path, job->model_type);
+    if (native_res_mgr != nullptr) {
+        OH_ResourceManager_ReleaseNativeResourceManager(native_res_mgr);
+    }
+    if (!job->model) {
+        return rejected_promise(env, "NOT_READY", "model not found");
+    }
+
+    napi_value promise;
+    napi_create_promise(env, &job->deferred, &promise);
+    napi_value resource_name;
+    napi_create_string_utf8(env, "tncnnBenchmarkPipeline", NAPI_AUTO_LENGTH, &resource_name);
+    napi_create_async_work(env, nullptr, resource_name, pipeline_job_execute, pipeline_job_complete, job.get(),
+                           &job->work);
+    napi_queue_async_work(env, job->work);
+    job.release();
+    return promise;
+}
+
+// 串行与流水线执行的对比测试（仅YOLOv8），两种方式使用同一实例依次运行
+typedef struct ExecutorJob {
+    napi_async_work work;
+    napi_deferred deferred;
+    std::string model_type;
+    ncnn::Option option;
+    int powersave;                  // 实例推理绑定的核心（见detector::Instance::powersave）
+    std::unique_ptr<modelloader::ModelData> model;
+    std::shared_ptr<detector::Instance> instance;
+    std::vector<PipelineImage> images;
+    int loop;
+    benchmark::RunSettings settings;
+    pipeline::Config config;
+    int infer_threads;                      // 流水线实际使用的推理线程数
+    double serial_wall;                     // 全部帧的总耗时
+    double pipelined_wall;
+    double serial_detections;               // 检测框总数，两种方式应一致
+    double pipelined_detections;
+    benchmark::BenchmarkResult serial;      // 每帧延迟
+    benchmark::BenchmarkResult pipelined;
+} ExecutorJob;
+
+static void executor_job_execute(napi_env env, void *data) {
+    ExecutorJob *job = static_cast<ExecutorJob *>(data);
+    job->instance = detector::create(job->model_type, job->option, std::move(job->model), job->powersave);
+    if (!job->instance || !job->instance->yolov8) {
+        return;
+    }
+    yolo::YOLOv8 &model = *job->instance->yolov8;
+    std::lock_guard<std::mutex> lock(job->instance->mutex);
+    // 串行部分直接在工作线程推理，流水线部分由推理线程按config.powersave绑定
+    corebinding::ScopedBinding binding(job->powersave);
+
+    // 串行：预处理、推理、后处理依次执行，延迟即单帧耗时
+    for (int i = 0; i < job->settings.warmup_loops; i++) {
+        for (PipelineImage &image : job->images) {
+            ncnn::Mat input(image.width, image.height, 4, image.rgba.data());
+            model.run(input, image.width, image.height, job->model_type.c_str());
+        }
+    }
+    double start = ncnn::get_current_time();
+    for (int i = 0; i < job->loop; i++) {
+        for (PipelineImage &image : job->images) {
+            double frame_start = ncnn::get_current_time();
+            ncnn::Mat input(image.width, image.height, 4, image.rgba.data());
+            job->serial_detections += model.run(input, image.width, image.height, job->model_type.c_str()).size();
+            job->serial.samples.push_back(ncnn::get_current_time() - frame_start);
+        }
+    }
+    job->serial_wall = ncnn::get_current_time() - start;
+
+    // 流水线：连续提交，在途帧达到上限时submit阻塞，延迟为提交到后处理完成
+    pipeline::Executor executor(model, job->config, [job](const pipeline::Output &output) {
+        job->pipelined.samples.push_back(output.latency);
+        job->pipelined_detections += output.boxes->size();
+    });
+    job->infer_threads = executor.infer_threads();
+    for (int i = 0; i < job->settings.warmup_loops; i++) {
+        for (const PipelineImage &image : job->images) {
+            executor.submit({image.rgba.data(), image.width, image.height, false, 0, 0});
+        }
+    }
+    executor.drain();
+    job->pipelined.samples.clear();
+    job->pipelined_detections = 0;
+
+    start = ncnn::get_current_time();
+    for (int i = 0; i < job->loop; i++) {
+        for (const PipelineImage &image : job->images) {
+            executor.submit({image.rgba.data(), image.width, image.height, false, 0, 0});
+        }
+    }
+    executor.drain();
+    job->pipelined_wall = ncnn::get_current_time() - start;
+}
+
+static napi_value convert_execution_to_js(napi_env env, benchmark::BenchmarkResult &latency, double wall,
+                                          double detections, size_t frames) {
+    benchmark::compute_stats(latency);
+    napi_value js_result;
+    napi_create_object(env, &js_result);
+    set_double_property(env, js_result, "fps", wall > 0 ? frames * 1000.0 / wall : 0);
+    set_double_property(env, js_result, "wall", wall);
+    set_double_property(env, js_result, "detections", detections);
+    napi_set_named_property(env, js_result, "latency", convert_benchmark_to_js(env, latency));
+    return js_result;
+}
+
+static void executor_job_complete(napi_env env, napi_status status, void *data) {
+    ExecutorJob *job = static_cast<ExecutorJob *>(data);
+    if (status != napi_ok) {
+        reject_deferred(env, job->deferred, "CANCELLED", "pipeline benchmark cancelled");
+    } else if (!job->instance || !job->instance->yolov8) {
+        reject_deferred(env, job->deferred, "NOT_READY", "yolov8 detector init failed");
+    } else {
+        size_t frames = (size_t)job->loop * job->images.size();
+        napi_value js_result, model_type;
+        napi_create_object(env, &js_result);
+        napi_create_string_utf8(env, job->model_type.c_str(), NAPI_AUTO_LENGTH, &model_type);
+        napi_set_named_property(env, js_result, "modelType", model_type);
+        set_double_property(env, js_result, "frames", frames);
+        set_double_property(env, js_result, "serialThreads", job->option.num_threads);
+        set_double_property(env, js_result, "inferThreads", job->infer_threads);
+        set_double_property(env, js_result, "maxInFlight", std::max(job->config.max_in_flight, 3));
+        napi_set_named_property(
+            env, js_result, "serial",
+            convert_execution_to_js(env, job->serial, job->serial_wall, job->serial_detections, frames));
+        napi_set_named_property(
+            env, js_result, "pipelined",
+            convert_execution_to_js(env, job->pipelined, job->pipelined_wall, job->pipelined_detections, frames));
+        set_double_property(env, js_result, "speedup",
+                            job->pipelined_wall > 0 ? job->serial_wall / job->pipelined_wall : 0);
+        napi_resolve_deferred(env, job->deferred, js_result);
+    }
+    napi_delete_async_work(env, job->work);
+    delete job;
+}
+
+/**
+ * 串行与三段流水线执行的吞吐与延迟对比（仅YOLOv8）
+ * 参数: resMgr, 沙盒路径, 模型类型, option, config, 图像数组[{data: ArrayBuffer(RGBA), width, height}], 循环次数,
+ *       [设置 {warmupLoops?, maxInFlight?, inferThreads?}]
+ * maxInFlight默认3；inferThreads默认为CPU核心数减2（预处理与后处理各占一个核心），串行使用option的线程数
+ * @return Promise<{modelType, frames, serialThreads, inferThreads, maxInFlight, serial, pipelined, speedup}>
+ *         serial/pipelined为 {fps, wall, detections, latency}，latency为每帧延迟的统计（同benchmark_ncnn）
+ */
+static napi_value BenchmarkPipelined(napi_env env, napi_callback_info info) {
+    size_t argc = 8;
+    napi_value args[8] = {nullptr};
+    napi_get_cb_info(env, info, &argc, args, nullptr, nullptr);
+
+    std::unique_ptr<ExecutorJob> job(new ExecutorJob());
+    std::string sanbox_path = value_to_string(env, args[1]);
+    job->model_type = value_to_string(env, args[2]);
+    if (detector::is_nanodet(job->model_type)) {
+        return rejected_promise(env, "INVALID_ARGUMENT", "pipelined execution requires a yolov8 model");
+    }
+    job->option = get_option_from_napi(env, args[3], args[4]);
+    job->powersave = get_powersave_from_napi(env, args[4]);
+    apply_saved_autotune(env, args[4], sanbox_path, job->model_type, job->option, job->powersave);
+    job->loop = 0;
+    napi_get_value_int32(env, args[6], &job->loop);
+    job->loop = std::max(job->loop, 1);
+    job->config.max_in_flight = 3;
+    job->config.infer_threads = 0;
+    job->config.powersave = job->powersave;
+    job->infer_threads = 0;
+    job->serial_wall = 0;
+    job->pipelined_wall = 0;
+    job->serial_detections = 0;
+    job->pipelined_detections = 0;
+    napi_valuetype type = napi_undefined;
+    if (argc >= 8 && napi_typeof(env, args[7], &type) == napi_ok && type == napi_object) {
+        parse_run_settings(env, args[7], job->settings);
+        get_int_option(env, args[7], "maxInFlight", job->config.max_in_flight);
+        get_int_option(env, args[7], "inferThreads", job->config.infer_threads);
+    }
+    if (!copy_pipeline_images(env, args[5], job->images)) {
+        return rejected_promise(env, "INVALID_ARGUMENT", "images must be RGBA data of width x height");
+    }
+
+    NativeResourceManager *native_res_mgr = OH_ResourceManager_InitNativeResourceManager(env, args[0]);
+    job->model = load_model_data(native_res_mgr, sanbox_path, job->model_type);
+    if (native_res_mgr != nullptr) {
+        OH_ResourceManager_ReleaseNativeResourceManager(native_res_mgr);
+    }
+    if (!job->model) {
+        return rejected_promise(env, "NOT_READY", "model not found");
+    }
+
+    napi_value promise;
+    napi_create_promise(env, &job->deferred, &promise);
+    napi_value resource_name;
+    napi_create_string_utf8(env, "tncnnBenchmarkPipelined", NAPI_AUTO_LENGTH, &resource_name);
+    napi_create_async_work(env, nullptr, resource_name, executor_job_execute, executor_job_complete, job.get(),
+                           &job->work);
+    napi_queue_async_work(env, job->work);
+    job.release();
+    return promise;
+}
+
+// 批量识别（默认YOLOv8实例）：多个extractor共用一个已加载的net，在工作窃取线程池上并行识别多张图片
+typedef struct BatchJob {
+    napi_async_work work;
+    napi_deferred deferred;
+    std::shared_ptr<detector::Instance> instance;   // 识别期间保持实例存活
+    std::vector<napi_ref> buffer_refs;              // 固定各图片的ArrayBuffer，任务完成前不被回收，无需拷贝
+    std::vector<batch::Image> images;
+    batch::Options options;
+    std::string user_id;
+    bool ready;
+    std::vector<std::vector<yolo::BoxInfo>> results;
+    batch::Stats stats;
+} BatchJob;
+
+static void batch_job_execute(napi_env env, void *data) {
+    BatchJob *job = static_cast<BatchJob *>(data);
+    std::lock_guard<std::mutex> lock(job->instance->mutex);
+    job->ready = job->instance->yolov8 != nullptr;
+    if (job->ready) {
+        batch::run(*job->instance->yolov8, job->images, job->options, job->results, job->stats);
+    }
+}
+
+static void batch_job_complete(napi_env env, napi_status status, void *data) {
+    BatchJob *job = static_cast<BatchJob *>(data);
+    if (status != napi_ok) {
+        reject_deferred(env, job->deferred, "CANCELLED", "batch cancelled");
+    } else if (!job->ready) {
+        reject_deferred(env, job->deferred, "NOT_READY", "yolov8 detector not initialized");
+    } else {
+        napi_value js_results;
+        napi_create_array_with_length(env, job->results.size(), &js_results);
+        detector::Result result;
+        for (size_t i = 0; i < job->results.size(); i++) {
+            result.yolo_boxes.swap(job->results[i]);
+            napi_set_element(env, js_results, i,
+                             convert_result_to_js(env, *job->instance, result, job->user_id, "", ""));
+        }
+        napi_resolve_deferred(env, job->deferred, js_results);
+    }
+
+    for (napi_ref ref : job->buffer_refs) {
+        napi_delete_reference(env, ref);
+    }
+    napi_delete_async_work(env, job->work);
+    delete job;
+}
+
+/**
+ * 批量识别多张RGBA图片（默认YOLOv8实例，需先yolov8_init）
+ * 参数: 图像数组[{data: ArrayBuffer(RGBA), width, height}], [选项 {workers?, threadsPerWorker?, userId?}]
+ * workers默认按核心数（有大小核时为大核数，并绑定到大核），不超过图片数；threadsPerWorker默认1
+ * 识别期间默认实例上的其他识别排队等待
+ * @return Promise，按图片顺序的结果数组，每项同yolov8_run
+ */
+static napi_value YOLOv8RunBatch(napi_env env, napi_callback_info info) {
+    size_t argc = 2;
+    napi_value args[2] = {nullptr};
+    napi_get_cb_info(env, info, &argc, args, nullptr, nullptr);
+
+    bool is_array = false;
+    if (argc < 1 || napi_is_array(env, args[0], &is_array) != napi_ok || !is_array) {
+        return rejected_promise(env, "INVALID_ARGUMENT", "images must be an array");
+    }
+    std::shared_ptr<detector::Instance> instance = get_default_instance(g_yolov8);
+    if (!instance) {
+        return rejected_promise(env, "NOT_READY", "yolov8 detector not initialized");
+    }
+
+    std::unique_ptr<BatchJob> job(new BatchJob());
+    job->instance = instance;
+    job->options.workers = 0;
+    job->options.threads_per_worker = 0;
+    job->ready = false;
+    napi_valuetype type = napi_undefined;
+    if (argc >= 2 && napi_typeof(env, args[1], &type) == napi_ok && type == napi_object) {
+        get_int_option(env, args[1], "workers", job->options.workers);
+        get_int_option(env, args[1], "threadsPerWorker", job->options.threads_per_worker);
+        bool has = false;
+        napi_value js_user_id;
+        if (napi_has_named_property(env, args[1], "userId", &has) == napi_ok && has) {
+            napi_get_named_property(env, args[1], "userId", &js_user_id);
+            job->user_id = value_to_string(env, js_user_id);
+        }
+    }
+
+    uint32_t image_count = 0;
+    napi_get_array_length(env, args[0], &image_count);
+    for (uint32_t i = 0; i < image_count; i++) {
+        napi_value js_image, js_data, js_width, js_height;
+        napi_get_element(env, args[0], i, &js_image);
+        napi_get_named_property(env, js_image, "data", &js_data);
+        napi_get_named_property(env, js_image, "width", &js_width);
+        napi_get_named_property(env, js_image, "height", &js_height);
+
+        batch::Image image;
+        void *pixels = nullptr;
+        size_t byte_length = 0;
+        image.width = 0;
+        image.height = 0;
+        napi_get_value_int32(env, js_width, &image.width);
+        napi_get_value_int32(env, js_height, &image.height);
+        if (napi_get_arraybuffer_info(env, js_data, &pixels, &byte_length) != napi_ok || image.width <= 0 ||
+            image.height <= 0 || byte_length < (size_t)image.width * image.height * 4) {
+            for (napi_ref ref : job->buffer_refs) {
+                napi_delete_reference(env, ref);
+            }
+            return rejected_promise(env, "INVALID_ARGUMENT", "images must be RGBA data of width x height");
+        }
+        image.rgba = (const unsigned char *)pixels;
+        napi_ref ref;
+        napi_create_reference(env, js_data, 1, &ref);
+        job->buffer_refs.push_back(ref);
+        job->images.push_back(image);
+    }
+
+    napi_value promise;
+    napi_create_promise(env, &job->deferred, &promise);
+    napi_value resource_name;
+    napi_create_string_utf8(env, "tncnnBatch", NAPI_AUTO_LENGTH, &resource_name);
+    napi_create_async_work(env, nullptr, resource_name, batch_job_execute, batch_job_complete, job.get(), &job->work);
+    napi_queue_async_work(env, job->work);
+    job.release();
+    return promise;
+}
+
+// --------------------------------------------[ async end ]--------------------------------------------
+
+// --------------------------------------------[ stream start ]--------------------------------------------
+// 推流识别：相机回调把原始帧写入原生帧环（满时覆盖最旧的帧），专用推理线程总是取最新的一帧识别，
+// 结果经napi_threadsafe_function回调到JS线程。JS端无需节流标记，也无需逐帧经taskpool调度。
+typedef struct StreamResult {
+    framequeue::FrameInfo frame;
+    detector::Result result;
+    double inference;                              // 识别耗时（毫秒）
+    bool cached;                                   // 画面未变化，沿用上次识别的结果
+    bool predicted;                                // 本帧未识别，框为跟踪预测
+} StreamResult;
+
+typedef struct FrameStream {
+    std::shared_ptr<detector::Instance> instance;  // 推流期间保持实例存活
+    std::unique_ptr<framequeue::FrameRing> ring;
+    std::thread worker;
+    napi_threadsafe_function callback;
+    framequeue::FrameInfo frame;                   // 每帧的格式与尺寸，启动时确定
+    std::string user_id;
+    std::unique_ptr<scenegate::SceneGate> gate;    // 静止画面门限，未开启时为空
+    detector::Result cached;                       // 最近一次识别器实际运行的结果（不含只预测的帧），仅推理线程访问
+    bool has_cached;
+    unsigned int threshold_generation;             // cached对应的实例阈值版本，仅推理线程访问
+    std::unique_ptr<tracker::Tracker> tracker;     // 多目标跟踪，未开启时为空
+    std::vector<tracker::Track> tracks;            // 跟踪器当前的输出，以下三项仅推理线程访问
+    int detect_every;                              // 开启跟踪时每N帧识别一次，其余帧只预测
+    int since_detect;                              // 距上次识别的帧数
+    unsigned int track_seq;                        // 跟踪器最近一次更新的帧序号，0表示尚未识别
+    std::atomic<uint64_t> frames_predicted;        // 只预测、未识别的帧数
+    std::atomic<uint64_t> results_dropped;         // 回调队列满时丢弃的结果
+    bool running;                                  // 以下字段只在JS线程访问
+    uint64_t delivered;
+    double latency_total;                          // 入队到回调的总延迟
+    double latency_max;
+} FrameStream;
+
+// 回调队列上限，JS线程处理不过来时丢弃新结果（推理线程不阻塞）
+static const size_t STREAM_CALLBACK_QUEUE = 2;
+
+static void stream_worker(FrameStream *stream) {
+    framequeue::Frame frame;
+    while (!stream->ring->stopped()) {
+        if (!stream->ring->acquire(frame, 100)) {
+            continue;
+        }
+
+        StreamResult *out = new StreamResult();
+        out->frame = frame.info;
+        out->cached = false;
+        out->predicted = false;
+        double start = ncnn::get_current_time();
+        bool nv21 = frame.info.format == framequeue::FORMAT_NV21;
+        // 跟踪的非识别帧只预测，不经过门限：门限的参考帧与缓存的结果只来自识别器实际运行的帧
+        bool predict = stream->tracker && stream->track_seq != 0 && stream->since_detect + 1 < stream->detect_every;
+        // 阈值已修改：缓存的结果按旧阈值识别，丢弃并重置门限，下一个识别帧必定运行识别器
+        unsigned int generation = stream->instance->threshold_generation.load();
+        if (generation != stream->threshold_generation) {
+            stream->threshold_generation = generation;
+            stream->has_cached = false;
+            if (stream->gate) {
+                stream->gate->reset();
+            }
+        }
+        bool changed = true;
+        if (stream->gate && !predict) {
+            // NV21的Y平面在前，签名在旋转前的原始帧上计算（推流期间旋转角度不变）
+            changed = nv21 ? stream->gate->check_luma(frame.data, frame.info.width, frame.info.height,
+                                                      frame.info.stride, start)
+                           : stream->gate->check_rgba(frame.data, frame.info.width, frame.info.height, start);
+        }
+
+        detector::Status status = detector::STATUS_OK;
+        if (predict) {
+            stream->since_detect++;
+            out->predicted = true;
+        } else if (!changed && stream->has_cached) {
+            out->result = stream->cached;
+            out->cached = true;
+        } else if (nv21) {
+            status = detector::run_nv21(*stream->instance, frame.data, frame.info.width, frame.info.height,
+                                        frame.info.stride, frame.info.rotation, out->result);
+        } else {
+            status = detector::run(*stream->instance, frame.data, frame.info.width, frame.info.height, out->result);
+        }
+        if (!out->cached && !out->predicted) {
+            stream->since_detect = 0;
+        }
+        out->inference = out->cached || out->predicted ? 0 : ncnn::get_current_time() - start;
+        stream->ring->release(frame);
+
+        if (stream->tracker && status == detector::STATUS_OK) {
+            // 按帧序号计算经过的帧数，帧环丢弃的帧也计入；画面静止的帧不计（目标没有移动）
+            unsigned int seq = out->frame.seq;
+            int steps = stream->track_seq == 0 ? 1 : (int)(seq - stream->track_seq);
+            if (out->cached) {
+                stream->track_seq = seq;
+            } else {
+                if (out->predicted) {
+                    stream->tracker->predict(steps, stream->tracks);
+                    stream->frames_predicted++;
+                } else {
+                    stream->tracker->update(out->result.yolo_boxes, steps, stream->tracks);
+                }
+                stream->track_seq = seq;
+                std::vector<yolo::BoxInfo> &boxes = out->result.yolo_boxes;
+                boxes.resize(stream->tracks.size());
+                out->result.track_ids.resize(stream->tracks.size());
+                for (size_t i = 0; i < stream->tracks.size(); i++) {
+                    const tracker::Track &track = stream->tracks[i];
+                    boxes[i] = {track.x1, track.y1, track.x2, track.y2, track.score, track.label};
+                    out->result.track_ids[i] = track.id;
+                }
+            }
+        }
+
+        if (stream->gate && !out->cached && !out->predicted) {
+            if (status == detector::STATUS_OK) {
+                stream->cached = out->result;
+                stream->has_cached = true;
+            } else {
+                // 识别失败的帧不能作为参考帧
+                stream->gate->reset();
+            }
+        }
+
+        if (status != detector::STATUS_OK) {
+            delete out;
+        } else if (napi_call_threadsafe_function(stream->callback, out, napi_tsfn_nonblocking) != napi_ok) {
+            // 队列满（napi_queue_full）或正在关闭
+            stream->results_dropped++;
+            delete out;
+        }
+    }
+}
+
+/**
+ * 在JS线程调用回调 callback(boxes, {seq, width, height, latency, inference, cached, predicted})
+ * 关闭时env为空，只释放数据
+ */
+static void stream_call_js(napi_env env, napi_value js_callback, void *context, void *data) {
+    StreamResult *out = static_cast<StreamResult *>(data);
+    FrameStream *stream = static_cast<FrameStream *>(context);
+    if (env != nullptr && js_callback != nullptr && stream->running) {
+        napi_value argv[2];
+        argv[0] = convert_result_to_js(env, *stream->instance, out->result, stream->user_id, "", "");
+
+        double latency = ncnn::get_current_time() - out->frame.time;
+        stream->delivered++;
+        stream->latency_total += latency;
+        stream->latency_max = std::max(stream->latency_max, latency);
+
+        napi_create_object(env, &argv[1]);
+        set_double_property(env, argv[1], "seq", out->frame.seq);
+        set_double_property(env, argv[1], "width", out->frame.width);
+        set_double_property(env, argv[1], "height", out->frame.height);
+        set_double_property(env, argv[1], "latency", latency);
+        set_double_property(env, argv[1], "inference", out->inference);
+        napi_value cached;
+        napi_get_boolean(env, out->cached, &cached);
+        napi_set_named_property(env, argv[1], "cached", cached);
+        napi_value predicted;
+        napi_get_boolean(env, out->predicted, &predicted);
+        napi_set_named_property(env, argv[1], "predicted", predicted);
+
+        napi_value undefined;
+        napi_get_undefined(env, &undefined);
+        napi_call_function(env, undefined, js_callback, 2, argv, nullptr);
+    }
+    delete out;
+}
+
+static void stream_callback_finalize(napi_env env, void *data, void *hint) {
+    delete static_cast<std::shared_ptr<FrameStream> *>(data);
+}
+
+/**
+ * 停止推流：唤醒并等待推理线程退出，释放回调（已排队的结果不再回调）
+ */
+static void stop_stream(FrameStream &stream) {
+    if (!stream.running) {
+        return;
+    }
+    stream.running = false;
+    stream.ring->stop();
+    if (stream.worker.joinable()) {
+        stream.worker.join();
+    }
+    napi_release_threadsafe_function(stream.callback, napi_tsfn_release);
+}
+
+static void stream_handle_finalize(napi_env env, void *data, void *hint) {
+    std::shared_ptr<FrameStream> *ref = static_cast<std::shared_ptr<FrameStream> *>(data);
+    stop_stream(**ref);
+    delete ref;
+}
+
+static std::shared_ptr<FrameStream> stream_from_arg(napi_env env, napi_value value) {
+    void *data = nullptr;
+    if (napi_unwrap(env, value, &data) == napi_ok && data != nullptr) {
+        return *static_cast<std::shared_ptr<FrameStream> *>(data);
+    }
+    return nullptr;
+}
+
+/**
+ * 开始推流识别
+ * 参数: 句柄或id, 回调 (boxes, info) => void, 选项 {format: 'nv21' | 'rgba', width, height, stride?, rotation?, slots?,
+ *       userId?, gate?}
+ * 帧尺寸在推流期间固定，nv21仅支持YOLOv8；slots为帧环的槽数（默认3）
+ * gate: true或 {cellThreshold?, changedRatio?, maxAgeMs?} 开启静止画面门限，画面相对上次识别的帧没有明显变化时
+ *       不识别，直接回调上次的结果（info.cached为true）；参数见scenegate::Config
+ * track: true或 {detectEvery?, highThreshold?, lowThreshold?, matchIou?, lowMatchIou?, minHits?, maxLost?} 开启多目标跟踪
+ *        （仅YOLOv8），每个框增加稳定的trackId；detectEvery（默认1）大于1时每N帧识别一次，其余帧输出跟踪预测的框
+ *        （info.predicted为true）；其余参数见tracker::Config，打包结果不含trackId
+ *        同时开启gate时，只预测的帧不经过门限，门限只在需要识别的帧上决定是否沿用上次的结果
+ * @return 推流句柄，失败返回undefined；句柄被回收或detector_stream_stop后停止
+ */
+static napi_value DetectorStreamStart(napi_env env, napi_callback_info info) {
+    size_t argc = 3;
+    napi_value args[3] = {nullptr};
+    napi_get_cb_info(env, info, &argc, args, nullptr, nullptr);
+
+    std::shared_ptr<FrameStream> stream(new FrameStream());
+    stream->instance = instance_from_arg(env, args[0]);
+    napi_valuetype type = napi_undefined;
+    napi_typeof(env, args[2], &type);
+    if (!stream->instance || argc < 3 || type != napi_object) {
+        OH_LOG_DEBUG(LogType::LOG_APP, "stream requires a detector and options");
+        return nullptr;
+    }
+
+    framequeue::FrameInfo &frame = stream->frame;
+    frame = framequeue::FrameInfo();
+    int slots = 3;
+    bool has = false;
+    napi_value field;
+    if (napi_has_named_property(env, args[2], "format", &has) == napi_ok && has) {
+        napi_get_named_property(env, args[2], "format", &field);
+        frame.format = value_to_string(env, field) == "nv21" ? framequeue::FORMAT_NV21 : framequeue::FORMAT_RGBA;
+    }
+    if (napi_has_named_property(env, args[2], "userId", &has) == napi_ok && has) {
+        napi_get_named_property(env, args[2], "userId", &field);
+        stream->user_id = value_to_string(env, field);
+    }
+    get_int_option(env, args[2], "width", frame.width);
+    get_int_option(env, args[2], "height", frame.height);
+    get_int_option(env, args[2], "stride", frame.stride);
+    get_int_option(env, args[2], "rotation", frame.rotation);
+    get_int_option(env, args[2], "slots", slots);
+    napi_valuetype gate_type = napi_undefined;
+    if (napi_has_named_property(env, args[2], "gate", &has) == napi_ok && has) {
+        napi_get_named_property(env, args[2], "gate", &field);
+        napi_typeof(env, field, &gate_type);
+        bool enabled = gate_type == napi_object;
+        if (gate_type == napi_boolean) {
+            napi_get_value_bool(env, field, &enabled);
+        }
+        if (enabled) {
+            scenegate::Config gate_config = scenegate::default_config();
+            if (gate_type == napi_object) {
+                double changed_ratio = gate_config.changed_ratio;
+                get_int_option(env, field, "cellThreshold", gate_config.cell_threshold);
+                get_double_option(env, field, "changedRatio", changed_ratio);
+                get_double_option(env, field, "maxAgeMs", gate_config.max_age);
+                gate_config.changed_ratio = (float)changed_ratio;
+            }
+            stream->gate.reset(new scenegate::SceneGate(gate_config));
+        }
+    }
+    stream->detect_every = 1;
+    if (napi_has_named_property(env, args[2], "track", &has) == napi_ok && has) {
+        napi_valuetype track_type = napi_undefined;
+        napi_get_named_property(env, args[2], "track", &field);
+        napi_typeof(env, field, &track_type);
+        bool enabled = track_type == napi_object;
+        if (track_type == napi_boolean) {
+            napi_get_value_bool(env, field, &enabled);
+        }
+        if (enabled && !stream->instance->yolov8) {
+            OH_LOG_DEBUG(LogType::LOG_APP, "tracking requires a yolov8 detector");
+            return nullptr;
+        }
+        if (enabled) {
+            tracker::Config track_config = tracker::default_config();
+            if (track_type == napi_object) {
+                double high_threshold = track_config.high_threshold;
+                double low_threshold = track_config.low_threshold;
+                double match_iou = track_config.match_iou;
+                double low_match_iou = track_config.low_match_iou;
+                get_int_option(env, field, "detectEvery", stream->detect_every);
+                get_double_option(env, field, "highThreshold", high_threshold);
+                get_double_option(env, field, "lowThreshold", low_threshold);
+                get_double_option(env, field, "matchIou", match_iou);
+                get_double_option(env, field, "lowMatchIou", low_match_iou);
+                get_int_option(env, field, "minHits", track_config.min_hits);
+                get_int_option(env, field, "maxLost", track_config.max_lost);
+                track_config.high_threshold = (float)high_threshold;
+                track_config.low_threshold = (float)low_threshold;
+                track_config.match_iou = (float)match_iou;
+                track_config.low_match_iou = (float)low_match_iou;
+            }
+            stream->detect_every = std::max(stream->detect_every, 1);
+            stream->tracker.reset(new tracker::Tracker(track_config));
+        }
+    }
+    if (frame.width <= 0 || frame.height <= 0) {
+        OH_LOG_DEBUG(LogType::LOG_APP, "invalid stream size %{public}dx%{public}d", frame.width, frame.height);
+        return nullptr;
+    }
+    if (frame.format == framequeue::FORMAT_NV21) {
+        if (!stream->instance->yolov8) {
+            OH_LOG_DEBUG(LogType::LOG_APP, "nv21 input requires a yolov8 detector");
+            return nullptr;
+        }
+        if (!yolo::valid_nv21(frame.width, frame.height, frame.rotation)) {
+            OH_LOG_DEBUG(LogType::LOG_APP, "invalid nv21 stream %{public}dx%{public}d rotation:%{public}d", frame.width,
+                         frame.height, frame.rotation);
+            return nullptr;
+        }
+        frame.stride = std::max(frame.stride, frame.width);
+        // NV21: Y平面 stride*height + VU平面 stride*height/2
+        frame.size = (size_t)frame.stride * frame.height * 3 / 2;
+    } else {
+        frame.size = (size_t)frame.width * frame.height * 4;
+    }
+
+    napi_value resource_name;
+    napi_create_string_utf8(env, "tncnnStream", NAPI_AUTO_LENGTH, &resource_name);
+    std::shared_ptr<FrameStream> *callback_ref = new std::shared_ptr<FrameStream>(stream);
+    if (napi_create_threadsafe_function(env, args[1], nullptr, resource_name, STREAM_CALLBACK_QUEUE, 1, callback_ref,
+                                        stream_callback_finalize, stream.get(), stream_call_js,
+                                        &stream->callback) != napi_ok) {
+        delete callback_ref;
+        OH_LOG_DEBUG(LogType::LOG_APP, "stream callback must be a function");
+        return nullptr;
+    }
+
+    napi_value handle;
+    napi_create_object(env, &handle);
+    std::shared_ptr<FrameStream> *ref = new std::shared_ptr<FrameStream>(stream);
+    if (napi_wrap(env, handle, ref, stream_handle_finalize, nullptr, nullptr) != napi_ok) {
+        delete ref;
+        napi_release_threadsafe_function(stream->callback, napi_tsfn_abort);
+        return nullptr;
+    }
+
+    stream->ring.reset(new framequeue::FrameRing(slots, frame.size));
+    stream->has_cached = false;
+    stream->threshold_generation = stream->instance->threshold_generation.load();
+    stream->since_detect = 0;
+    stream->track_seq = 0;
+    stream->frames_predicted.store(0);
+    stream->delivered = 0;
+    stream->results_dropped.store(0);
+    stream->latency_total = 0;
+    stream->latency_max = 0;
+    stream->running = true;
+    stream->worker = std::thread(stream_worker, stream.get());
+    OH_LOG_DEBUG(LogType::LOG_APP,
+                 "stream start %{public}dx%{public}d format:%{public}d slots:%{public}d gate:%{public}d "
+                 "track:%{public}d detect every:%{public}d",
+                 frame.width, frame.height, frame.format, slots, stream->gate != nullptr, stream->tracker != nullptr,
+                 stream->detect_every);
+    return handle;
+}
+
+/**
+ * 推入一帧（拷贝到帧环后立即返回，不等待识别）
+ * 参数: 推流句柄, 帧数据ArrayBuffer（格式与尺寸同启动选项）
+ * @return 是否入队；帧环满时覆盖最旧的未处理帧，仍返回true
+ */
+static napi_value DetectorStreamPush(napi_env env, napi_callback_info info) {
+    size_t argc = 2;
+    napi_value args[2] = {nullptr};
+    napi_get_cb_info(env, info, &argc, args, nullptr, nullptr);
+
+    std::shared_ptr<FrameStream> stream = stream_from_arg(env, args[0]);
+    void *data = nullptr;
+    size_t byte_length = 0;
+    bool queued = false;
+    if (stream && stream->running && napi_get_arraybuffer_info(env, args[1], &data, &byte_length) == napi_ok) {
+        if (byte_length >= stream->frame.size) {
+            queued = stream->ring->push(static_cast<const unsigned char *>(data), stream->frame);
+        } else {
+            OH_LOG_DEBUG(LogType::LOG_APP, "stream frame too small:%{public}zu", byte_length);
+        }
+    }
+
+    napi_value result;
+    napi_get_boolean(env, queued, &result);
+    return result;
+}
+
+/**
+ * 停止推流，等待进行中的识别结束
+ * 参数: 推流句柄
+ */
+static napi_value DetectorStreamStop(napi_env env, napi_callback_info info) {
+    size_t argc = 1;
+    napi_value args[1] = {nullptr};
+    napi_get_cb_info(env, info, &argc, args, nullptr, nullptr);
+
+    std::shared_ptr<FrameStream> stream = stream_from_arg(env, args[0]);
+    bool running = stream && stream->running;
+    if (stream) {
+        stop_stream(*stream);
+    }
+    napi_value result;
+    napi_get_boolean(env, running, &result);
+    return result;
+}
+
+/**
+ * 推流统计
+ * 参数: 推流句柄
+ * @return {pushed, dropped, rejected, processed, predicted, delivered, resultsDropped, avgLatency, maxLatency, gate?}
+ *         predicted为开启跟踪时只预测、未识别的帧数（已计入processed）
+ *         dropped为未处理即被覆盖的帧数，resultsDropped为JS线程积压时丢弃的结果数，延迟为入队到回调（毫秒）
+ *         开启门限时gate为 {frames, inferred, skipped, forced, skipRatio, lastChanged}，skipped为沿用上次结果的帧数
+ */
+static napi_value DetectorStreamStats(napi_env env, napi_callback_info info) {
+    size_t argc = 1;
+    napi_value args[1] = {nullptr};
+    napi_get_cb_info(env, info, &argc, args, nullptr, nullptr);
+
+    std::shared_ptr<FrameStream> stream = stream_from_arg(env, args[0]);
+    if (!stream || !stream->ring) {
+        return nullptr;
+    }
+    framequeue::Stats stats;
+    stream->ring->stats(stats);
+
+    napi_value result;
+    napi_create_object(env, &result);
+    set_double_property(env, result, "pushed", stats.pushed);
+    set_double_property(env, result, "dropped", stats.dropped);
+    set_double_property(env, result, "rejected", stats.rejected);
+    set_double_property(env, result, "processed", stats.taken);
+    set_double_property(env, result, "predicted", stream->frames_predicted.load());
+    set_double_property(env, result, "delivered", stream->delivered);
+    set_double_property(env, result, "resultsDropped", stream->results_dropped.load());
+    set_double_property(env, result, "avgLatency",
+                        stream->delivered == 0 ? 0 : stream->latency_total / stream->delivered);
+    set_double_property(env, result, "maxLatency", stream->latency_max);
+    if (stream->gate) {
+        scenegate::Stats gate_stats;
+        stream->gate->stats(gate_stats);
+        napi_value gate;
+        napi_create_object(env, &gate);
+        set_double_property(env, gate, "frames", gate_stats.frames);
+        set_double_property(env, gate, "inferred", gate_stats.inferred);
+        set_double_property(env, gate, "skipped", gate_stats.skipped);
+        set_double_property(env, gate, "forced", gate_stats.forced);
+        set_double_property(env, gate, "skipRatio",
+                            gate_stats.frames == 0 ? 0 : (double)gate_stats.skipped / gate_stats.frames);
+        set_double_property(env, gate, "lastChanged", gate_stats.last_changed);
+        napi_set_named_property(env, result, "gate", gate);
+    }
+    return result;
+}
+// --------------------------------------------[ stream end ]--------------------------------------------
+
+
+// --------------------------------------------[ autotune start ]--------------------------------------------
+
+// 自动调优参数，模型在JS线程加载，测速在工作线程执行
+typedef struct AutotuneJob {
+    napi_async_work work;
+    napi_deferred deferred;
+    std::string sanbox_path;
+    std::string model_type;
+    std::unique_ptr<modelloader::ModelData> model;
+    ncnn::Option option;
+    int loop;
+    bool ok;
+    autotune::Config config;
+} AutotuneJob;
+
+/**
+ * 调优结果转换为JS对象
+ * {modelType, device, numThreads, powersave, avg, candidates: [{numThreads, powersave, min, avg}]}
+ */
+static napi_value convert_autotune_to_js(napi_env env, const autotune::Config &config) {
+    napi_value js_object, model_type, device, num_threads, powersave, avg, candidates;
+    napi_create_object(env, &js_object);
+    napi_create_string_utf8(env, config.model_type.c_str(), NAPI_AUTO_LENGTH, &model_type);
+    napi_create_string_utf8(env, config.device.c_str(), NAPI_AUTO_LENGTH, &device);
+    napi_create_int32(env, config.num_threads, &num_threads);
+    napi_create_int32(env, config.powersave, &powersave);
+    napi_create_double(env, config.avg, &avg);
+    napi_set_named_property(env, js_object, "modelType", model_type);
+    napi_set_named_property(env, js_object, "device", device);
+    napi_set_named_property(env, js_object, "numThreads", num_threads);
+    napi_set_named_property(env, js_object, "powersave", powersave);
+    napi_set_named_property(env, js_object, "avg", avg);
+
+    napi_create_array_with_length(env, config.candidates.size(), &candidates);
+    for (size_t i = 0; i < config.candidates.size(); i++) {
+        const autotune::Candidate &candidate = config.candidates[i];
+        napi_value js_candidate, c_threads, c_powersave, c_min, c_avg;
+        napi_create_object(env, &js_candidate);
+        napi_create_int32(env, candidate.num_threads, &c_threads);
+        napi_create_int32(env, candidate.powersave, &c_powersave);
+        napi_create_double(env, candidate.min, &c_min);
+        napi_create_double(env, candidate.avg, &c_avg);
+        napi_set_named_property(env, js_candidate, "numThreads", c_threads);
+        napi_set_named_property(env, js_candidate, "powersave", c_powersave);
+        napi_set_named_property(env, js_candidate, "min", c_min);
+        napi_set_named_property(env, js_candidate, "avg", c_avg);
+        napi_set_element(env, candidates, i, js_candidate);
+    }
+    napi_set_named_property(env, js_object, "candidates", candidates);
+    return js_object;
+}
+
+static void autotune_job_execute(napi_env env, void *data) {
+    AutotuneJob *job = static_cast<AutotuneJob *>(data);
+    job->ok = autotune::tune(*job->model, job->model_type, job->option, model_input_size(job->model_type), job->loop,
+                             job->config) &&
+              autotune::save(autotune::config_path(job->sanbox_path, job->model_type), job->config);
+    // 测速结束即可释放模型
+    job->model.reset();
+}
+
+static void autotune_job_complete(napi_env env, napi_status status, void *data) {
+    AutotuneJob *job = static_cast<AutotuneJob *>(data);
+    if (status != napi_ok) {
+        reject_deferred(env, job->deferred, "CANCELLED", "autotune cancelled");
+    } else if (!job->ok) {
+        reject_deferred(env, job->deferred, "FAILED", "autotune failed");
+    } else {
+        napi_resolve_deferred(env, job->deferred, convert_autotune_to_js(env, job->config));
+    }
+    napi_delete_async_work(env, job->work);
+    delete job;
+}
+
+/**
+ * 自动调优：对线程数 × 核心（全部/小核/大核）的组合测速，结果保存到沙盒
+ * 之后以自动线程数（config.thread为0）初始化该模型时自动应用
+ * 参数: resMgr, 沙盒路径, 模型类型, option, config, [每个组合的循环次数，默认8]
+ * @return Promise<调优结果>
+ */
+static napi_value AutotuneRun(napi_env env, napi_callback_info info) {
+    size_t argc = 6;
+    napi_value args[6] = {nullptr};
+    napi_get_cb_info(env, info, &argc, args, nullptr, nullptr);
+
+    std::unique_ptr<AutotuneJob> job(new AutotuneJob());
+    job->sanbox_path = value_to_string(env, args[1]);
+    job->model_type = value_to_string(env, args[2]);
+    job->option = get_option_from_napi(env, args[3], args[4]);
+    job->loop = 8;
+    if (argc >= 6) {
+        napi_get_value_int32(env, args[5], &job->loop);
+    }
+    job->loop = std::max(job->loop, 1);
+    job->ok = false;
+
+    NativeResourceManager *native_res_mgr = OH_ResourceManager_InitNativeResourceManager(env, args[0]);
+    job->model = load_model_data(native_res_mgr, job->sanbox_path, job->model_type);
+    if (native_res_mgr != nullptr) {
+        OH_ResourceManager_ReleaseNativeResourceManager(native_res_mgr);
+    }
+    if (!job->model) {
+        return rejected_promise(env, "NOT_READY", "model not found");
+    }
+
+    napi_value promise;
+    napi_create_promise(env, &job->deferred, &promise);
+    napi_value resource_name;
+    napi_create_string_utf8(env, "tncnnAutotune", NAPI_AUTO_LENGTH, &resource_name);
+    napi_create_async_work(env, nullptr, resource_name, autotune_job_execute, autotune_job_complete, job.get(),
+                           &job->work);
+    napi_queue_async_work(env, job->work);
+    job.release();
+    return promise;
+}
+
+/**
+ * 读取保存的调优结果
+ * 参数: 沙盒路径, 模型类型
+ * @return 调优结果，未调优或不属于当前设备时返回undefined
+ */
+static napi_value AutotuneGet(napi_env env, napi_callback_info info) {
+    size_t argc = 2;
+    napi_value args[2] = {nullptr};
+    napi_get_cb_info(env, info, &argc, args, nullptr, nullptr);
+
+    autotune::Config config;
+    if (!autotune::load(autotune::config_path(value_to_string(env, args[0]), value_to_string(env, args[1])),
+                        config)) {
+        return nullptr;
+    }
+    return convert_autotune_to_js(env, config);
+}
+
+/**
+ * 删除保存的调优结果，之后自动线程数恢复为ncnn默认值
+ * 参数: 沙盒路径, 模型类型
+ */
+static napi_value AutotuneClear(napi_env env, napi_callback_info info) {
+    size_t argc = 2;
+    napi_value args[2] = {nullptr};
+    napi_get_cb_info(env, info, &argc, args, nullptr, nullptr);
+
+    std::string path = autotune::config_path(value_to_string(env, args[0]), value_to_string(env, args[1]));
+    napi_value result;
+    napi_get_boolean(env, std::remove(path.c_str()) == 0, &result);
+    return result;
+}
+
+// --------------------------------------------[ autotune end ]--------------------------------------------
 
 
 // ==========================================================================================================
@@ -591,11 +2973,40 @@ static napi_value Init(napi_env env, napi_value exports) {
         // YOLOv4已移除
         // {"yolov4_tiny_init", nullptr, YOLOv4TinyInit, nullptr, nullptr, nullptr, napi_default, nullptr},
         // {"yolov4_tiny_run", nullptr, YOLOv4TinyRun, nullptr, nullptr, nullptr, napi_default, nullptr},
+        {"detector_create", nullptr, DetectorCreate, nullptr, nullptr, nullptr, napi_default, nullptr},
+        {"detector_run", nullptr, DetectorRun, nullptr, nullptr, nullptr, napi_default, nullptr},
+        {"detector_run_nv21", nullptr, DetectorRunNV21, nullptr, nullptr, nullptr, napi_default, nullptr},
+        {"detector_set_thresholds", nullptr, DetectorSetThresholds, nullptr, nullptr, nullptr, napi_default, nullptr},
+        {"detector_release", nullptr, DetectorRelease, nullptr, nullptr, nullptr, napi_default, nullptr},
+        {"detector_set_packed", nullptr, DetectorSetPacked, nullptr, nullptr, nullptr, napi_default, nullptr},
+        {"detector_labels", nullptr, DetectorLabels, nullptr, nullptr, nullptr, napi_default, nullptr},
+        {"detector_memory_stats", nullptr, DetectorMemoryStats, nullptr, nullptr, nullptr, napi_default, nullptr},
         {"nanodet_init", nullptr, NanoDetInit, nullptr, nullptr, nullptr, napi_default, nullptr},
         {"nanodet_run", nullptr, NanoDetRun, nullptr, nullptr, nullptr, napi_default, nullptr},
         {"yolov8_init", nullptr, YOLOv8Init, nullptr, nullptr, nullptr, napi_default, nullptr},
         {"yolov8_run", nullptr, YOLOv8Run, nullptr, nullptr, nullptr, napi_default, nullptr},
+        {"yolov8_run_nv21", nullptr, YOLOv8RunNV21, nullptr, nullptr, nullptr, napi_default, nullptr},
+        {"yolov8_set_thresholds", nullptr, YOLOv8SetThresholds, nullptr, nullptr, nullptr, napi_default, nullptr},
         {"benchmark_ncnn", nullptr, BenchmarkNCNN, nullptr, nullptr, nullptr, napi_default, nullptr},
+        {"benchmark_nms", nullptr, BenchmarkNMS, nullptr, nullptr, nullptr, napi_default, nullptr},
+        {"benchmark_marshal", nullptr, BenchmarkMarshal, nullptr, nullptr, nullptr, napi_default, nullptr},
+        {"detector_run_async", nullptr, DetectorRunAsync, nullptr, nullptr, nullptr, napi_default, nullptr},
+        {"detector_run_nv21_async", nullptr, DetectorRunNV21Async, nullptr, nullptr, nullptr, napi_default, nullptr},
+        {"detector_cancel", nullptr, DetectorCancel, nullptr, nullptr, nullptr, napi_default, nullptr},
+        {"yolov8_run_async", nullptr, YOLOv8RunAsync, nullptr, nullptr, nullptr, napi_default, nullptr},
+        {"nanodet_run_async", nullptr, NanoDetRunAsync, nullptr, nullptr, nullptr, napi_default, nullptr},
+        {"benchmark_ncnn_async", nullptr, BenchmarkNCNNAsync, nullptr, nullptr, nullptr, napi_default, nullptr},
+        {"benchmark_sweep", nullptr, BenchmarkSweep, nullptr, nullptr, nullptr, napi_default, nullptr},
+        {"benchmark_pipeline", nullptr, BenchmarkPipeline, nullptr, nullptr, nullptr, napi_default, nullptr},
+        {"benchmark_pipelined", nullptr, BenchmarkPipelined, nullptr, nullptr, nullptr, napi_default, nullptr},
+        {"yolov8_run_batch", nullptr, YOLOv8RunBatch, nullptr, nullptr, nullptr, napi_default, nullptr},
+        {"detector_stream_start", nullptr, DetectorStreamStart, nullptr, nullptr, nullptr, napi_default, nullptr},
+        {"detector_stream_push", nullptr, DetectorStreamPush, nullptr, nullptr, nullptr, napi_default, nullptr},
+        {"detector_stream_stop", nullptr, DetectorStreamStop, nullptr, nullptr, nullptr, napi_default, nullptr},
+        {"detector_stream_stats", nullptr, DetectorStreamStats, nullptr, nullptr, nullptr, napi_default, nullptr},
+        {"autotune_run", nullptr, AutotuneRun, nullptr, nullptr, nullptr, napi_default, nullptr},
+        {"autotune_get", nullptr, AutotuneGet, nullptr, nullptr, nullptr, napi_default, nullptr},
+        {"autotune_clear", nullptr, AutotuneClear, nullptr, nullptr, nullptr, napi_default, nullptr},
     };
     napi_define_properties(env, exports, sizeof(desc) / sizeof(desc[0]), desc);
     return exports;
@@ -0,0 +1,27 @@
+#include "net_utils.h"
+#include <cstring>
+
+namespace netutils {
+
+int find_blob_index(const ncnn::Net &net, const char *name) {
+    const std::vector<ncnn::Blob> &blobs = net.blobs();
+    for (int i = 0; i < (int)blobs.size(); i++) {
+        if (strcmp(blobs[i].name.c_str(), name) == 0) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+int resolve_blob_index(const ncnn::Net &net, const char *const *candidates, int count,
+                       const std::vector<int> &fallback) {
+    for (int i = 0; i < count; i++) {
+        int index = find_blob_index(net, candidates[i]);
+        if (index >= 0) {
+            return index;
+        }
+    }
+    return fallback.empty() ? -1 : fallback[0];
+}
+
+} // namespace netutils
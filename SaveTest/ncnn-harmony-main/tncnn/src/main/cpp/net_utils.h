@@ -0,0 +1,30 @@
+#ifndef NET_UTILS_H
+#define NET_UTILS_H
+
+#include "net.h"
+#include <vector>
+
+namespace netutils {
+
+// 按名称查找blob下标，不存在返回-1
+int find_blob_index(const ncnn::Net &net, const char *name);
+
+// 按候选名称依次查找，返回第一个存在的blob下标
+// 都不存在时返回fallback中的第一个（如net.input_indexes()），fallback为空返回-1
+int resolve_blob_index(const ncnn::Net &net, const char *const *candidates, int count,
+                       const std::vector<int> &fallback);
+
+// 一帧各阶段的耗时（毫秒）
+// RGBA输入的通道转换、缩放与归一化在一次遍历中完成，全部计入resize；NV21输入的convert为旋转与YUV转RGB
+typedef struct StageTimes {
+    double convert;
+    double resize;       // 缩放（含letterbox填充）
+    double normalize;
+    double forward;      // 网络推理
+    double decode;
+    double nms;
+} StageTimes;
+
+} // namespace netutils
+
+#endif // NET_UTILS_H
@@ -0,0 +1,211 @@
+#include "nms.h"
+#include <algorithm>
+#include <cfloat>
+
+#if __ARM_NEON
+#include <arm_neon.h>
+#elif __SSE2__
+#include <emmintrin.h>
+#endif
+
+namespace nms {
+
+// 计算候选i与[j, j + 4)的重叠，返回 IoU > threshold 的4位掩码
+// 使用 inter > threshold * union 代替除法
+static inline unsigned int overlap_mask4(const float *x1, const float *y1, const float *x2, const float *y2,
+                                         const float *area, int i, int j, float threshold, float offset) {
+#if __ARM_NEON
+    float32x4_t _x1 = vmaxq_f32(vdupq_n_f32(x1[i]), vld1q_f32(x1 + j));
+    float32x4_t _y1 = vmaxq_f32(vdupq_n_f32(y1[i]), vld1q_f32(y1 + j));
+    float32x4_t _x2 = vminq_f32(vdupq_n_f32(x2[i]), vld1q_f32(x2 + j));
+    float32x4_t _y2 = vminq_f32(vdupq_n_f32(y2[i]), vld1q_f32(y2 + j));
+    float32x4_t _zero = vdupq_n_f32(0.f);
+    float32x4_t _offset = vdupq_n_f32(offset);
+    float32x4_t _w = vmaxq_f32(_zero, vaddq_f32(vsubq_f32(_x2, _x1), _offset));
+    float32x4_t _h = vmaxq_f32(_zero, vaddq_f32(vsubq_f32(_y2, _y1), _offset));
+    float32x4_t _inter = vmulq_f32(_w, _h);
+    float32x4_t _union = vsubq_f32(vaddq_f32(vdupq_n_f32(area[i]), vld1q_f32(area + j)), _inter);
+    uint32x4_t _gt = vcgtq_f32(_inter, vmulq_f32(_union, vdupq_n_f32(threshold)));
+
+    const uint32_t lane_bits[4] = {1, 2, 4, 8};
+    uint32x4_t _bits = vandq_u32(_gt, vld1q_u32(lane_bits));
+#if __aarch64__
+    return vaddvq_u32(_bits);
+#else
+    uint32x2_t _sum = vadd_u32(vget_low_u32(_bits), vget_high_u32(_bits));
+    _sum = vpadd_u32(_sum, _sum);
+    return vget_lane_u32(_sum, 0);
+#endif
+#elif __SSE2__
+    __m128 _x1 = _mm_max_ps(_mm_set1_ps(x1[i]), _mm_loadu_ps(x1 + j));
+    __m128 _y1 = _mm_max_ps(_mm_set1_ps(y1[i]), _mm_loadu_ps(y1 + j));
+    __m128 _x2 = _mm_min_ps(_mm_set1_ps(x2[i]), _mm_loadu_ps(x2 + j));
+    __m128 _y2 = _mm_min_ps(_mm_set1_ps(y2[i]), _mm_loadu_ps(y2 + j));
+    __m128 _zero = _mm_setzero_ps();
+    __m128 _offset = _mm_set1_ps(offset);
+    __m128 _w = _mm_max_ps(_zero, _mm_add_ps(_mm_sub_ps(_x2, _x1), _offset));
+    __m128 _h = _mm_max_ps(_zero, _mm_add_ps(_mm_sub_ps(_y2, _y1), _offset));
+    __m128 _inter = _mm_mul_ps(_w, _h);
+    __m128 _union = _mm_sub_ps(_mm_add_ps(_mm_set1_ps(area[i]), _mm_loadu_ps(area + j)), _inter);
+    return (unsigned int)_mm_movemask_ps(_mm_cmpgt_ps(_inter, _mm_mul_ps(_union, _mm_set1_ps(threshold))));
+#else
+    unsigned int bits = 0;
+    for (int k = 0; k < 4; k++) {
+        float w = std::max(0.f, std::min(x2[i], x2[j + k]) - std::max(x1[i], x1[j + k]) + offset);
+        float h = std::max(0.f, std::min(y2[i], y2[j + k]) - std::max(y1[i], y1[j + k]) + offset);
+        float inter = w * h;
+        if (inter > (area[i] + area[j + k] - inter) * threshold) {
+            bits |= 1u << k;
+        }
+    }
+    return bits;
+#endif
+}
+
+void NmsSolver::clear() {
+    x1s.clear();
+    y1s.clear();
+    x2s.clear();
+    y2s.clear();
+    scores.clear();
+    labels.clear();
+}
+
+void NmsSolver::reserve(int n) {
+    x1s.reserve(n);
+    y1s.reserve(n);
+    x2s.reserve(n);
+    y2s.reserve(n);
+    scores.reserve(n);
+    labels.reserve(n);
+}
+
+void NmsSolver::add(float x1, float y1, float x2, float y2, float score, int label) {
+    x1s.push_back(x1);
+    y1s.push_back(y1);
+    x2s.push_back(x2);
+    y2s.push_back(y2);
+    scores.push_back(score);
+    labels.push_back(label);
+}
+
+void NmsSolver::gather(const int *indices, int n, float offset_unit, float coord_offset) {
+    int n4 = (n + 3) & ~3;
+    sx1.resize(n4);
+    sy1.resize(n4);
+    sx2.resize(n4);
+    sy2.resize(n4);
+    sarea.resize(n4);
+    for (int k = 0; k < n; k++) {
+        int idx = indices[k];
+        float offset = labels[idx] * offset_unit;
+        sx1[k] = x1s[idx] + offset;
+        sy1[k] = y1s[idx] + offset;
+        sx2[k] = x2s[idx] + offset;
+        sy2[k] = y2s[idx] + offset;
+    }
+
+    // 补齐的候选为空框，不会与任何框重叠
+    for (int k = n; k < n4; k++) {
+        sx1[k] = sy1[k] = FLT_MAX;
+        sx2[k] = sy2[k] = -FLT_MAX;
+    }
+    for (int k = 0; k < n4; k++) {
+        sarea[k] = k < n ? (sx2[k] - sx1[k] + coord_offset) * (sy2[k] - sy1[k] + coord_offset) : 0.f;
+    }
+}
+
+void NmsSolver::suppress(int begin, int end, const Params &params) {
+    const float *x1 = sx1.data();
+    const float *y1 = sy1.data();
+    const float *x2 = sx2.data();
+    const float *y2 = sy2.data();
+    const float *area = sarea.data();
+
+    for (int i = begin; i < end; i++) {
+        if ((removed[i >> 6] >> (i & 63)) & 1) {
+            continue;
+        }
+        keep.push_back(order[i]);
+
+        // 按4对齐分块，块内的位不会跨越64位字
+        for (int j = (i + 1) & ~3; j < end; j += 4) {
+            uint64_t &word = removed[j >> 6];
+            if (((word >> (j & 63)) & 0xF) == 0xF) {
+                continue;
+            }
+
+            unsigned int bits = overlap_mask4(x1, y1, x2, y2, area, i, j, params.iou_threshold, params.coord_offset);
+            if (j < i + 1) {
+                bits &= ~0u << (i + 1 - j);
+            }
+            if (j + 4 > end) {
+                bits &= (1u << (end - j)) - 1;
+            }
+            word |= (uint64_t)bits << (j & 63);
+        }
+    }
+}
+
+const std::vector<int> &NmsSolver::run(const Params &params) {
+    keep.clear();
+    int n = size();
+    if (n == 0) {
+        return keep;
+    }
+
+    order.resize(n);
+    for (int k = 0; k < n; k++) {
+        order[k] = k;
+    }
+
+    const float *s = scores.data();
+    const int *l = labels.data();
+    if (params.mode == MODE_CLASS_AWARE) {
+        // 同类别连续，类别内按分数降序
+        std::sort(order.begin(), order.end(), [s, l](int a, int b) {
+            if (l[a] != l[b]) {
+                return l[a] < l[b];
+            }
+            return s[a] != s[b] ? s[a] > s[b] : a < b;
+        });
+    } else {
+        std::sort(order.begin(), order.end(), [s](int a, int b) { return s[a] != s[b] ? s[a] > s[b] : a < b; });
+    }
+
+    // 类别平移量大于所有坐标的跨度，保证不同类别的框互不重叠
+    float offset_unit = 0.f;
+    if (params.mode == MODE_CLASS_OFFSET) {
+        float min_coord = FLT_MAX;
+        float max_coord = -FLT_MAX;
+        for (int k = 0; k < n; k++) {
+            min_coord = std::min(min_coord, std::min(x1s[k], y1s[k]));
+            max_coord = std::max(max_coord, std::max(x2s[k], y2s[k]));
+        }
+        offset_unit = max_coord - min_coord + params.coord_offset + 1.f;
+    }
+
+    gather(order.data(), n, offset_unit, params.coord_offset);
+    removed.assign(((n + 3) >> 6) + 1, 0);
+
+    if (params.mode == MODE_CLASS_AWARE) {
+        int begin = 0;
+        while (begin < n) {
+            int end = begin + 1;
+            while (end < n && labels[order[end]] == labels[order[begin]]) {
+                end++;
+            }
+            suppress(begin, end, params);
+            begin = end;
+        }
+
+        // 各类别的结果合并后按分数降序
+        std::sort(keep.begin(), keep.end(), [s](int a, int b) { return s[a] != s[b] ? s[a] > s[b] : a < b; });
+    } else {
+        suppress(0, n, params);
+    }
+
+    return keep;
+}
+
+} // namespace nms
@@ -0,0 +1,70 @@
+#ifndef NMS_H
+#define NMS_H
+
+#include <cstdint>
+#include <vector>
+
+namespace nms {
+
+// NMS模式
+enum Mode {
+    MODE_CLASS_AWARE = 0,   // 按类别分段，只在同类别内抑制
+    MODE_CLASS_OFFSET = 1,  // 按类别平移坐标后一次性抑制（不同类别的框互不重叠）
+    MODE_AGNOSTIC = 2       // 不区分类别
+};
+
+typedef struct Params {
+    float iou_threshold;    // IoU大于该值时抑制
+    Mode mode;
+    float coord_offset;     // 宽高计算的偏移（像素包含式坐标为1，否则为0）
+} Params;
+
+// 贪心NMS
+// 候选框以SoA形式保存，按分数排序后逐个保留，每个保留框一次向量化地计算与后续候选的IoU，
+// 抑制结果写入位图，已抑制的候选不再参与计算。对象可复用，稳定状态下不分配内存。
+class NmsSolver {
+public:
+    // 清空候选框
+    void clear();
+
+    // 预留候选框容量
+    void reserve(int n);
+
+    // 添加候选框
+    void add(float x1, float y1, float x2, float y2, float score, int label);
+
+    int size() const { return (int)scores.size(); }
+
+    // 执行NMS，返回保留的候选下标（添加顺序），按分数降序排列
+    const std::vector<int> &run(const Params &params);
+
+private:
+    // 按排序后的顺序整理SoA坐标与面积，末尾补齐到4的倍数
+    void gather(const int *indices, int n, float offset_unit, float coord_offset);
+
+    // 对排序后[begin, end)范围内的候选执行贪心抑制，保留的候选写入keep
+    void suppress(int begin, int end, const Params &params);
+
+    // 添加顺序的候选
+    std::vector<float> x1s;
+    std::vector<float> y1s;
+    std::vector<float> x2s;
+    std::vector<float> y2s;
+    std::vector<float> scores;
+    std::vector<int> labels;
+
+    // 排序后的候选
+    std::vector<int> order;
+    std::vector<float> sx1;
+    std::vector<float> sy1;
+    std::vector<float> sx2;
+    std::vector<float> sy2;
+    std::vector<float> sarea;
+    std::vector<uint64_t> removed;  // 抑制位图
+
+    std::vector<int> keep;
+};
+
+} // namespace nms
+
+#endif // NMS_H
@@ -0,0 +1,84 @@
+#include "param_graph.h"
+#include <cstdlib>
+#include <sstream>
+
+namespace paramgraph {
+
+bool parse(const std::string &text, std::vector<LayerInfo> &layers) {
+    std::istringstream in(text);
+
+    // 7767517
+    int magic = 0;
+    in >> magic;
+    if (magic != 7767517) {
+        return false;
+    }
+
+    int layer_count = 0;
+    int blob_count = 0;
+    in >> layer_count >> blob_count;
+    if (!in || layer_count <= 0) {
+        return false;
+    }
+
+    layers.clear();
+    layers.reserve(layer_count);
+    std::string line;
+    std::getline(in, line);
+    while ((int)layers.size() < layer_count && std::getline(in, line)) {
+        std::istringstream ls(line);
+        LayerInfo layer;
+        int bottom_count = 0;
+        int top_count = 0;
+        if (!(ls >> layer.type >> layer.name >> bottom_count >> top_count)) {
+            continue;
+        }
+
+        layer.bottoms.resize(bottom_count);
+        for (int i = 0; i < bottom_count; i++) {
+            ls >> layer.bottoms[i];
+        }
+        layer.tops.resize(top_count);
+        for (int i = 0; i < top_count; i++) {
+            ls >> layer.tops[i];
+        }
+
+        // k=v，数组参数的k为 -23300-id
+        std::string kv;
+        while (ls >> kv) {
+            size_t eq = kv.find('=');
+            if (eq == std::string::npos) {
+                continue;
+            }
+            int id = atoi(kv.substr(0, eq).c_str());
+            if (id <= -23300) {
+                id = -id - 23300;
+            }
+            layer.params[id] = kv.substr(eq + 1);
+        }
+
+        layers.push_back(layer);
+    }
+
+    return (int)layers.size() == layer_count;
+}
+
+int int_param(const LayerInfo &layer, int id, int default_value) {
+    auto it = layer.params.find(id);
+    if (it == layer.params.end()) {
+        return default_value;
+    }
+    return atoi(it->second.c_str());
+}
+
+std::map<std::string, const LayerInfo *> producers(const std::vector<LayerInfo> &layers) {
+    std::map<std::string, const LayerInfo *> result;
+    for (const LayerInfo &layer : layers) {
+        for (const std::string &top : layer.tops) {
+            result[top] = &layer;
+        }
+    }
+    return result;
+}
+
+} // namespace paramgraph
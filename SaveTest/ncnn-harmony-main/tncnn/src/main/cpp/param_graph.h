@@ -0,0 +1,30 @@
+#ifndef PARAM_GRAPH_H
+#define PARAM_GRAPH_H
+
+#include <map>
+#include <string>
+#include <vector>
+
+namespace paramgraph {
+
+// .param中的一层
+typedef struct LayerInfo {
+    std::string type;
+    std::string name;
+    std::vector<std::string> bottoms;
+    std::vector<std::string> tops;
+    std::map<int, std::string> params;  // 参数原文（数组参数为逗号分隔）
+} LayerInfo;
+
+// 解析ncnn文本格式的.param内容，格式不正确时返回false
+bool parse(const std::string &text, std::vector<LayerInfo> &layers);
+
+// 读取整型参数，不存在时返回default_value
+int int_param(const LayerInfo &layer, int id, int default_value);
+
+// 按blob名称索引产生它的层
+std::map<std::string, const LayerInfo *> producers(const std::vector<LayerInfo> &layers);
+
+} // namespace paramgraph
+
+#endif // PARAM_GRAPH_H
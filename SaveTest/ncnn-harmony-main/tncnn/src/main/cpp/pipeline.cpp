@@ -0,0 +1,145 @@
+#include "pipeline.h"
+#include "benchmark.h"
+#include "core_binding.h"
+#include "cpu.h"
+#include <algorithm>
+
+#include "hilog/log.h"
+
+#undef LOG_TAG
+#define LOG_TAG "Tncnn"
+
+namespace pipeline {
+
+void Executor::StageQueue::push(int slot) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        slots.push_back(slot);
+    }
+    ready.notify_one();
+}
+
+bool Executor::StageQueue::pop(int &slot) {
+    std::unique_lock<std::mutex> lock(mutex);
+    ready.wait(lock, [this] { return closed || !slots.empty(); });
+    if (slots.empty()) {
+        return false;
+    }
+    slot = slots.front();
+    slots.pop_front();
+    return true;
+}
+
+void Executor::StageQueue::close() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        closed = true;
+    }
+    ready.notify_all();
+}
+
+Executor::Executor(yolo::YOLOv8 &model, const Config &config, Callback callback)
+    : model(model), callback(callback), slot_count(std::max(config.max_in_flight, 3)),
+      num_threads(config.infer_threads), powersave(config.powersave), slots(new Slot[slot_count]), submitted(0), completed(0) {
+    // 预处理与后处理各占一个核心，其余留给推理
+    if (num_threads <= 0) {
+        num_threads = std::max(ncnn::get_cpu_count() - 2, 1);
+    }
+    for (int i = 0; i < slot_count; i++) {
+        model.init_frame(slots[i].state);
+        free_slots.push(i);
+    }
+    preprocess_thread = std::thread(&Executor::preprocess_worker, this);
+    infer_thread = std::thread(&Executor::infer_worker, this);
+    postprocess_thread = std::thread(&Executor::postprocess_worker, this);
+    OH_LOG_DEBUG(LogType::LOG_APP, "pipeline start, in flight:%{public}d infer threads:%{public}d", slot_count,
+                 num_threads);
+}
+
+Executor::~Executor() {
+    drain();
+    free_slots.close();
+    preprocess_queue.close();
+    infer_queue.close();
+    postprocess_queue.close();
+    preprocess_thread.join();
+    infer_thread.join();
+    postprocess_thread.join();
+}
+
+uint64_t Executor::submit(const Input &input) {
+    int index = 0;
+    free_slots.pop(index);
+
+    Slot &slot = slots[index];
+    slot.input = input;
+    slot.submit_time = ncnn::get_current_time();
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        slot.seq = ++submitted;
+    }
+    preprocess_queue.push(index);
+    return slot.seq;
+}
+
+void Executor::drain() {
+    std::unique_lock<std::mutex> lock(mutex);
+    drained.wait(lock, [this] { return completed == submitted; });
+}
+
+void Executor::preprocess_worker() {
+    int index;
+    while (preprocess_queue.pop(index)) {
+        Slot &slot = slots[index];
+        const Input &input = slot.input;
+        if (input.nv21) {
+            slot.ok = model.preprocess_nv21(slot.state, input.data, input.width, input.height, input.stride,
+                                            input.rotation);
+        } else {
+            slot.ok = model.preprocess(slot.state, input.data, input.width, input.height);
+        }
+        infer_queue.push(index);
+    }
+}
+
+void Executor::infer_worker() {
+    corebinding::ScopedBinding binding(powersave);
+    int index;
+    while (infer_queue.pop(index)) {
+        Slot &slot = slots[index];
+        if (slot.ok) {
+            model.forward(slot.state, num_threads, true);
+        }
+        postprocess_queue.push(index);
+    }
+}
+
+void Executor::postprocess_worker() {
+    int index;
+    while (postprocess_queue.pop(index)) {
+        Slot &slot = slots[index];
+        Output output;
+        output.seq = slot.seq;
+        output.ok = slot.ok;
+        if (slot.ok) {
+            model.postprocess(slot.state);
+        } else {
+            slot.state.boxes.clear();
+        }
+        output.boxes = &slot.state.boxes;
+        output.stages = slot.state.stages;
+        output.latency = ncnn::get_current_time() - slot.submit_time;
+        if (callback) {
+            callback(output);
+        }
+
+        free_slots.push(index);
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            completed++;
+        }
+        drained.notify_all();
+    }
+}
+
+} // namespace pipeline
@@ -0,0 +1,116 @@
+#ifndef PIPELINE_H
+#define PIPELINE_H
+
+#include "yolov8.h"
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace pipeline {
+
+// 一帧输入，数据在该帧预处理完成前必须保持有效
+typedef struct Input {
+    const unsigned char *data;
+    int width;
+    int height;
+    bool nv21;
+    int stride;       // 仅NV21，行跨度
+    int rotation;     // 仅NV21，顺时针旋转角度
+} Input;
+
+// 在途帧数与CPU预算
+typedef struct Config {
+    int max_in_flight;   // 同时在流水线中的帧数上限（至少3，三个阶段才能完全重叠；更多只会增加排队延迟）
+    int infer_threads;   // 推理线程数，<=0时为CPU核心数减去预处理与后处理各占的一个核心（至少1）
+    int powersave;       // 推理线程绑定的核心（同set_cpu_powersave），-1表示不绑定
+} Config;
+
+// 一帧的结果，在后处理线程回调，boxes在回调返回后失效
+typedef struct Output {
+    uint64_t seq;                              // submit返回的序号
+    bool ok;                                   // 预处理失败（模型未初始化）时为false
+    const std::vector<yolo::BoxInfo> *boxes;
+    netutils::StageTimes stages;
+    double latency;                            // submit到后处理完成（毫秒）
+} Output;
+
+typedef std::function<void(const Output &)> Callback;
+
+// 三段流水线执行器：预处理N+1、推理N、后处理N-1分别在三个线程上同时进行
+// 每个在途帧有独立的yolo::FrameState，帧按提交顺序依次经过各阶段，结果按提交顺序回调。
+// 推理线程独占net，推理输出拷贝出分配器后交给后处理线程（见YOLOv8::forward）。
+// 执行期间模型不能用于串行推理，也不能修改阈值。
+class Executor {
+public:
+    Executor(yolo::YOLOv8 &model, const Config &config, Callback callback);
+
+    // 等待在途帧完成后停止各阶段线程
+    ~Executor();
+
+    // 提交一帧，在途帧达到上限时阻塞，返回序号（从1开始）
+    uint64_t submit(const Input &input);
+
+    // 等待所有已提交的帧完成
+    void drain();
+
+    int infer_threads() const { return num_threads; }
+    int max_in_flight() const { return slot_count; }
+
+private:
+    // 阶段之间的队列，元素为槽下标
+    class StageQueue {
+    public:
+        StageQueue() : closed(false) {}
+        void push(int slot);
+        // 队列关闭且为空时返回false
+        bool pop(int &slot);
+        void close();
+
+    private:
+        std::mutex mutex;
+        std::condition_variable ready;
+        std::deque<int> slots;
+        bool closed;
+    };
+
+    typedef struct Slot {
+        yolo::FrameState state;
+        Input input;
+        uint64_t seq;
+        double submit_time;
+        bool ok;
+    } Slot;
+
+    void preprocess_worker();
+    void infer_worker();
+    void postprocess_worker();
+
+    yolo::YOLOv8 &model;
+    Callback callback;
+    int slot_count;
+    int num_threads;
+    int powersave;
+    std::unique_ptr<Slot[]> slots;
+
+    StageQueue free_slots;
+    StageQueue preprocess_queue;
+    StageQueue infer_queue;
+    StageQueue postprocess_queue;
+
+    std::mutex mutex;                       // 保护以下计数
+    std::condition_variable drained;
+    uint64_t submitted;
+    uint64_t completed;
+
+    std::thread preprocess_thread;
+    std::thread infer_thread;
+    std::thread postprocess_thread;
+};
+
+} // namespace pipeline
+
+#endif // PIPELINE_H
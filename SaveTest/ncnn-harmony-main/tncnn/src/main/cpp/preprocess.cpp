@@ -0,0 +1,213 @@
+#include "preprocess.h"
+#include <algorithm>
+#include <climits>
+#include <cmath>
+
+#if __ARM_NEON
+#include <arm_neon.h>
+#elif __SSE2__
+#include <emmintrin.h>
+#if __AVX__
+#include <immintrin.h>
+#endif
+#endif
+
+namespace preprocess {
+
+// 与 ncnn::resize_bilinear_c* 保持一致的定点参数
+static const int INTER_RESIZE_COEF_BITS = 11;
+static const int INTER_RESIZE_COEF_SCALE = 1 << INTER_RESIZE_COEF_BITS;
+
+static inline short saturate_cast_short(float x) {
+    int v = (int)(x + (x >= 0.f ? 0.5f : -0.5f));
+    return (short)std::min(std::max(v, SHRT_MIN), SHRT_MAX);
+}
+
+// 计算一个方向上的源坐标与插值系数
+static void resolve_coeffs(int srcsize, int dstsize, int step, int *ofs, short *coeffs) {
+    double scale = (double)srcsize / dstsize;
+    for (int d = 0; d < dstsize; d++) {
+        float f = (float)((d + 0.5) * scale - 0.5);
+        int s = static_cast<int>(floor(f));
+        f -= s;
+
+        if (s < 0) {
+            s = 0;
+            f = 0.f;
+        }
+        if (s >= srcsize - 1) {
+            s = srcsize - 2;
+            f = 1.f;
+        }
+
+        ofs[d] = s * step;
+        coeffs[d * 2] = saturate_cast_short((1.f - f) * INTER_RESIZE_COEF_SCALE);
+        coeffs[d * 2 + 1] = saturate_cast_short(f * INTER_RESIZE_COEF_SCALE);
+    }
+}
+
+// 垂直插值一行并归一化写出：out = ((b0*r0 >> 16) + (b1*r1 >> 16) + 2) >> 2，再 out * scale + bias
+static void vresize_normalize(const short *rows0, const short *rows1, short b0, short b1, float *outptr, int w,
+                              float scale, float bias) {
+    int x = 0;
+#if __ARM_NEON
+    int16x4_t _b0 = vdup_n_s16(b0);
+    int16x4_t _b1 = vdup_n_s16(b1);
+    int32x4_t _v2 = vdupq_n_s32(2);
+    float32x4_t _scale = vdupq_n_f32(scale);
+    float32x4_t _bias = vdupq_n_f32(bias);
+    for (; x + 7 < w; x += 8) {
+        int16x8_t _r0 = vld1q_s16(rows0 + x);
+        int16x8_t _r1 = vld1q_s16(rows1 + x);
+
+        int32x4_t _acc0 = vsraq_n_s32(_v2, vmull_s16(vget_low_s16(_r0), _b0), 16);
+        int32x4_t _acc1 = vsraq_n_s32(_v2, vmull_s16(vget_high_s16(_r0), _b0), 16);
+        _acc0 = vsraq_n_s32(_acc0, vmull_s16(vget_low_s16(_r1), _b1), 16);
+        _acc1 = vsraq_n_s32(_acc1, vmull_s16(vget_high_s16(_r1), _b1), 16);
+        _acc0 = vshrq_n_s32(_acc0, 2);
+        _acc1 = vshrq_n_s32(_acc1, 2);
+
+        vst1q_f32(outptr + x, vmlaq_f32(_bias, vcvtq_f32_s32(_acc0), _scale));
+        vst1q_f32(outptr + x + 4, vmlaq_f32(_bias, vcvtq_f32_s32(_acc1), _scale));
+    }
+#elif __SSE2__
+    // 结果都是非负数，_mm_mulhi_epi16 即 (a*b) >> 16
+#if __AVX2__
+    {
+        __m256i _b0 = _mm256_set1_epi16(b0);
+        __m256i _b1 = _mm256_set1_epi16(b1);
+        __m256i _v2 = _mm256_set1_epi16(2);
+        __m256 _scale = _mm256_set1_ps(scale);
+        __m256 _bias = _mm256_set1_ps(bias);
+        for (; x + 15 < w; x += 16) {
+            __m256i _r0 = _mm256_loadu_si256((const __m256i *)(rows0 + x));
+            __m256i _r1 = _mm256_loadu_si256((const __m256i *)(rows1 + x));
+            __m256i _acc = _mm256_add_epi16(_mm256_mulhi_epi16(_r0, _b0), _mm256_mulhi_epi16(_r1, _b1));
+            _acc = _mm256_srai_epi16(_mm256_add_epi16(_acc, _v2), 2);
+
+            __m256i _lo = _mm256_cvtepi16_epi32(_mm256_castsi256_si128(_acc));
+            __m256i _hi = _mm256_cvtepi16_epi32(_mm256_extracti128_si256(_acc, 1));
+            _mm256_storeu_ps(outptr + x, _mm256_add_ps(_mm256_mul_ps(_mm256_cvtepi32_ps(_lo), _scale), _bias));
+            _mm256_storeu_ps(outptr + x + 8, _mm256_add_ps(_mm256_mul_ps(_mm256_cvtepi32_ps(_hi), _scale), _bias));
+        }
+    }
+#endif // __AVX2__
+    __m128i _b0 = _mm_set1_epi16(b0);
+    __m128i _b1 = _mm_set1_epi16(b1);
+    __m128i _v2 = _mm_set1_epi16(2);
+    __m128i _zero = _mm_setzero_si128();
+#if __AVX__
+    __m256 _scale = _mm256_set1_ps(scale);
+    __m256 _bias = _mm256_set1_ps(bias);
+#else
+    __m128 _scale = _mm_set1_ps(scale);
+    __m128 _bias = _mm_set1_ps(bias);
+#endif
+    for (; x + 7 < w; x += 8) {
+        __m128i _r0 = _mm_loadu_si128((const __m128i *)(rows0 + x));
+        __m128i _r1 = _mm_loadu_si128((const __m128i *)(rows1 + x));
+        __m128i _acc = _mm_add_epi16(_mm_mulhi_epi16(_r0, _b0), _mm_mulhi_epi16(_r1, _b1));
+        _acc = _mm_srai_epi16(_mm_add_epi16(_acc, _v2), 2);
+
+        __m128i _lo = _mm_unpacklo_epi16(_acc, _zero);
+        __m128i _hi = _mm_unpackhi_epi16(_acc, _zero);
+#if __AVX__
+        __m256 _p = _mm256_cvtepi32_ps(_mm256_insertf128_si256(_mm256_castsi128_si256(_lo), _hi, 1));
+        _mm256_storeu_ps(outptr + x, _mm256_add_ps(_mm256_mul_ps(_p, _scale), _bias));
+#else
+        _mm_storeu_ps(outptr + x, _mm_add_ps(_mm_mul_ps(_mm_cvtepi32_ps(_lo), _scale), _bias));
+        _mm_storeu_ps(outptr + x + 4, _mm_add_ps(_mm_mul_ps(_mm_cvtepi32_ps(_hi), _scale), _bias));
+#endif
+    }
+#endif // __ARM_NEON
+    for (; x < w; x++) {
+        int v = (((b0 * rows0[x]) >> 16) + ((b1 * rows1[x]) >> 16) + 2) >> 2;
+        outptr[x] = (float)v * scale + bias;
+    }
+}
+
+void ResizeNormalizer::prepare(int srcw, int srch, int src_channels, int w, int h) {
+    if (this->srcw == srcw && this->srch == srch && this->src_channels == src_channels && this->w == w &&
+        this->h == h) {
+        return;
+    }
+    this->srcw = srcw;
+    this->srch = srch;
+    this->src_channels = src_channels;
+    this->w = w;
+    this->h = h;
+
+    xofs.resize(w);
+    yofs.resize(h);
+    ialpha.resize(w * 2);
+    ibeta.resize(h * 2);
+    resolve_coeffs(srcw, w, src_channels, xofs.data(), ialpha.data());
+    resolve_coeffs(srch, h, 1, yofs.data(), ibeta.data());
+
+    rowsbuf0.resize(w * 3);
+    rowsbuf1.resize(w * 3);
+}
+
+void ResizeNormalizer::hresize(const unsigned char *src_row, short *rows) const {
+    const int cn = src_channels;
+    short *rows_r = rows;
+    short *rows_g = rows + w;
+    short *rows_b = rows + w * 2;
+    for (int dx = 0; dx < w; dx++) {
+        const unsigned char *S = src_row + xofs[dx];
+        short a0 = ialpha[dx * 2];
+        short a1 = ialpha[dx * 2 + 1];
+        rows_r[dx] = (S[0] * a0 + S[cn] * a1) >> 4;
+        rows_g[dx] = (S[1] * a0 + S[cn + 1] * a1) >> 4;
+        rows_b[dx] = (S[2] * a0 + S[cn + 2] * a1) >> 4;
+    }
+}
+
+void ResizeNormalizer::run(const unsigned char *pixels, int srcstride, ncnn::Mat &dst, int left, int top,
+                           const float *mean_vals, const float *norm_vals, bool bgr) {
+    // 与 substract_mean_normalize 相同：x * norm + (-mean * norm)
+    float scales[3];
+    float biases[3];
+    for (int q = 0; q < 3; q++) {
+        scales[q] = norm_vals ? norm_vals[q] : 1.f;
+        biases[q] = mean_vals ? (norm_vals ? -mean_vals[q] * norm_vals[q] : -mean_vals[q]) : 0.f;
+    }
+
+    short *rows0 = rowsbuf0.data();
+    short *rows1 = rowsbuf1.data();
+
+    int prev_sy1 = -2;
+    for (int dy = 0; dy < h; dy++) {
+        int sy = yofs[dy];
+
+        if (sy == prev_sy1) {
+            // 两行都可复用
+        } else if (sy == prev_sy1 + 1) {
+            // 只需水平缩放一行
+            std::swap(rows0, rows1);
+            hresize(pixels + (size_t)srcstride * (sy + 1), rows1);
+        } else {
+            hresize(pixels + (size_t)srcstride * sy, rows0);
+            hresize(pixels + (size_t)srcstride * (sy + 1), rows1);
+        }
+        prev_sy1 = sy;
+
+        short b0 = ibeta[dy * 2];
+        short b1 = ibeta[dy * 2 + 1];
+        for (int p = 0; p < 3; p++) {
+            int q = bgr ? 2 - p : p;
+            float *outptr = dst.channel(p).row(top + dy) + left;
+            vresize_normalize(rows0 + q * w, rows1 + q * w, b0, b1, outptr, w, scales[p], biases[p]);
+        }
+    }
+}
+
+void fill_normalized(ncnn::Mat &dst, float value, const float *mean_vals, const float *norm_vals) {
+    for (int q = 0; q < dst.c; q++) {
+        float scale = norm_vals ? norm_vals[q] : 1.f;
+        float bias = mean_vals ? (norm_vals ? -mean_vals[q] * norm_vals[q] : -mean_vals[q]) : 0.f;
+        dst.channel(q).fill(value * scale + bias);
+    }
+}
+
+} // namespace preprocess
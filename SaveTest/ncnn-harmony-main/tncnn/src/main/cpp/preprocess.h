@@ -0,0 +1,54 @@
+#ifndef PREPROCESS_H
+#define PREPROCESS_H
+
+#include "mat.h"
+#include <vector>
+
+namespace preprocess {
+
+// 融合的letterbox预处理内核
+// 一次遍历完成 RGBA/RGB 取通道、双线性缩放和归一化，平面float直接写入网络输入Mat的指定区域。
+// 缩放使用与 ncnn::resize_bilinear_c3/c4 相同的11位定点系数和舍入，
+// 结果与 from_pixels_resize + copy_make_border + substract_mean_normalize 三步流程逐位一致
+// （均值非0时归一化 x*norm-mean*norm 是否融合乘加取决于编译器，可能有1ulp差异）。
+class ResizeNormalizer {
+public:
+    // 设置几何参数，尺寸不变时复用已计算的坐标与系数表
+    // srcw/srch: 源图尺寸（至少2x2）
+    // src_channels: 源像素通道数（3=RGB, 4=RGBA）
+    // w/h: 缩放后的尺寸
+    void prepare(int srcw, int srch, int src_channels, int w, int h);
+
+    // 缩放并归一化，写入dst的 [left, left + w) x [top, top + h) 区域，dst其余部分不会被修改
+    // pixels: 源像素
+    // srcstride: 源像素行跨度（字节）
+    // dst: 3通道float Mat
+    // bgr: 为true时按BGR顺序输出
+    void run(const unsigned char *pixels, int srcstride, ncnn::Mat &dst, int left, int top,
+             const float *mean_vals, const float *norm_vals, bool bgr = false);
+
+private:
+    // 水平缩放一行源像素，按通道平面写入rows（3 x w）
+    void hresize(const unsigned char *src_row, short *rows) const;
+
+    int srcw = 0;
+    int srch = 0;
+    int src_channels = 0;
+    int w = 0;
+    int h = 0;
+
+    std::vector<int> xofs;      // 每个输出列对应的源像素字节偏移
+    std::vector<int> yofs;      // 每个输出行对应的源行号
+    std::vector<short> ialpha;  // 水平插值系数（每列2个）
+    std::vector<short> ibeta;   // 垂直插值系数（每行2个）
+    std::vector<short> rowsbuf0;
+    std::vector<short> rowsbuf1;
+};
+
+// 用原始像素值value经归一化后的结果填满dst的每个通道
+// 对应 copy_make_border 常量填充后再 substract_mean_normalize 的填充区域取值
+void fill_normalized(ncnn::Mat &dst, float value, const float *mean_vals, const float *norm_vals);
+
+} // namespace preprocess
+
+#endif // PREPROCESS_H
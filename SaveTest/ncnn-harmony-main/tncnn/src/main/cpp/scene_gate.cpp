@@ -0,0 +1,106 @@
+#include "scene_gate.h"
+#include <algorithm>
+#include <cstdlib>
+
+namespace scenegate {
+
+// 每个网格每个方向的取样数
+static const int CELL_SAMPLES = 4;
+
+Config default_config() {
+    Config config;
+    config.cols = 32;
+    config.rows = 24;
+    config.cell_threshold = 12;
+    config.changed_ratio = 0.005f;
+    config.max_age = 1000;
+    return config;
+}
+
+SceneGate::SceneGate(const Config &config)
+    : config(config), reference_width(0), reference_height(0), reference_time(0), has_reference(false), frames(0),
+      inferred(0), skipped(0), forced(0), last_changed(0) {
+    this->config.cols = std::max(this->config.cols, 1);
+    this->config.rows = std::max(this->config.rows, 1);
+    current.resize((size_t)this->config.cols * this->config.rows);
+}
+
+void SceneGate::compute_signature(const unsigned char *data, int width, int height, int stride, int pixel_bytes) {
+    int cols = std::min(config.cols, width);
+    int rows = std::min(config.rows, height);
+    current.assign((size_t)config.cols * config.rows, 0);
+    for (int r = 0; r < rows; r++) {
+        int y0 = (int)((long)height * r / rows);
+        int cell_h = (int)((long)height * (r + 1) / rows) - y0;
+        for (int c = 0; c < cols; c++) {
+            int x0 = (int)((long)width * c / cols);
+            int cell_w = (int)((long)width * (c + 1) / cols) - x0;
+            // 在网格内均匀取样，取样点落在各子块中心
+            unsigned int sum = 0;
+            for (int sy = 0; sy < CELL_SAMPLES; sy++) {
+                const unsigned char *row = data + (size_t)(y0 + (2 * sy + 1) * cell_h / (2 * CELL_SAMPLES)) * stride;
+                for (int sx = 0; sx < CELL_SAMPLES; sx++) {
+                    int x = x0 + (2 * sx + 1) * cell_w / (2 * CELL_SAMPLES);
+                    const unsigned char *p = row + (size_t)x * pixel_bytes;
+                    sum += pixel_bytes == 1 ? p[0] : (77 * p[0] + 150 * p[1] + 29 * p[2]) >> 8;
+                }
+            }
+            current[(size_t)r * config.cols + c] = (uint8_t)(sum / (CELL_SAMPLES * CELL_SAMPLES));
+        }
+    }
+}
+
+bool SceneGate::decide(int width, int height, double now) {
+    frames++;
+    bool run = !has_reference || width != reference_width || height != reference_height;
+    float changed = 1.0f;
+    if (!run) {
+        int count = 0;
+        for (size_t i = 0; i < current.size(); i++) {
+            if (std::abs((int)current[i] - (int)reference[i]) > config.cell_threshold) {
+                count++;
+            }
+        }
+        changed = (float)count / current.size();
+        run = changed > config.changed_ratio;
+        if (!run && config.max_age > 0 && now - reference_time >= config.max_age) {
+            run = true;
+            forced++;
+        }
+    }
+    last_changed.store(changed);
+
+    if (!run) {
+        skipped++;
+        return false;
+    }
+    inferred++;
+    reference.swap(current);
+    reference_width = width;
+    reference_height = height;
+    reference_time = now;
+    has_reference = true;
+    return true;
+}
+
+bool SceneGate::check_luma(const unsigned char *y, int width, int height, int stride, double now) {
+    compute_signature(y, width, height, std::max(stride, width), 1);
+    return decide(width, height, now);
+}
+
+bool SceneGate::check_rgba(const unsigned char *rgba, int width, int height, double now) {
+    compute_signature(rgba, width, height, width * 4, 4);
+    return decide(width, height, now);
+}
+
+void SceneGate::reset() { has_reference = false; }
+
+void SceneGate::stats(Stats &out) const {
+    out.frames = frames.load();
+    out.inferred = inferred.load();
+    out.skipped = skipped.load();
+    out.forced = forced.load();
+    out.last_changed = last_changed.load();
+}
+
+} // namespace scenegate
@@ -0,0 +1,74 @@
+#ifndef SCENE_GATE_H
+#define SCENE_GATE_H
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+namespace scenegate {
+
+// 门限参数
+typedef struct Config {
+    int cols;              // 签名网格列数
+    int rows;              // 签名网格行数
+    int cell_threshold;    // 单个网格亮度均值的变化超过该值（0~255）视为该格变化
+    float changed_ratio;   // 变化网格占比超过该值时重新识别
+    double max_age;        // 距上次识别超过该时间（毫秒）时强制识别，<=0不限制
+} Config;
+
+// 默认参数：32x24网格，超过4个网格（约一个小目标的大小）明显变化即重新识别，静止画面每秒至少识别一次
+Config default_config();
+
+// 计数
+typedef struct Stats {
+    uint64_t frames;        // 经过门限的帧数
+    uint64_t inferred;      // 需要识别的帧数
+    uint64_t skipped;       // 画面未变化、沿用上次结果的帧数
+    uint64_t forced;        // 画面未变化但超过max_age而识别的帧数（已计入inferred）
+    float last_changed;     // 最近一帧相对参考帧的变化网格占比
+} Stats;
+
+// 静止画面门限
+// 每帧在亮度平面上按网格取样得到签名（各网格的亮度均值，每格固定取样4x4个像素），
+// 与最近一次识别的帧（参考帧）比较，变化网格的占比超过阈值或参考帧过旧时才需要识别。
+// 与参考帧而非上一帧比较，缓慢的累计变化（平移、光照）也会触发识别。
+// check只在一个线程调用；stats可以在其他线程读取。
+class SceneGate {
+public:
+    explicit SceneGate(const Config &config);
+
+    // NV21/灰度帧：y为亮度平面，stride为行跨度；now为当前时间（毫秒）
+    // @return 需要识别时返回true，并以该帧作为新的参考帧
+    bool check_luma(const unsigned char *y, int width, int height, int stride, double now);
+
+    // RGBA帧，亮度按 (77R + 150G + 29B) / 256 近似
+    bool check_rgba(const unsigned char *rgba, int width, int height, double now);
+
+    // 清除参考帧，下一帧必定识别（如识别失败、阈值或模型改变后）
+    void reset();
+
+    void stats(Stats &out) const;
+
+private:
+    // 计算签名到current，pixel_bytes为1（亮度）或4（RGBA）
+    void compute_signature(const unsigned char *data, int width, int height, int stride, int pixel_bytes);
+    bool decide(int width, int height, double now);
+
+    Config config;
+    std::vector<uint8_t> current;
+    std::vector<uint8_t> reference;
+    int reference_width;
+    int reference_height;
+    double reference_time;
+    bool has_reference;
+
+    std::atomic<uint64_t> frames;
+    std::atomic<uint64_t> inferred;
+    std::atomic<uint64_t> skipped;
+    std::atomic<uint64_t> forced;
+    std::atomic<float> last_changed;
+};
+
+} // namespace scenegate
+
+#endif // SCENE_GATE_H
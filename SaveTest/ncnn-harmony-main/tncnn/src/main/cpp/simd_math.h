@@ -0,0 +1,200 @@
+#ifndef SIMD_MATH_H
+#define SIMD_MATH_H
+
+#include <cfloat>
+#include <cmath>
+
+#if __ARM_NEON
+#include <arm_neon.h>
+#elif __SSE2__
+#include <emmintrin.h>
+#endif
+
+namespace simd {
+
+// 多项式近似的向量化expf（cephes系数，与ncnn的neon_mathfun/sse_mathfun一致）
+#if __ARM_NEON
+static inline float32x4_t exp_ps(float32x4_t x) {
+    const float32x4_t one = vdupq_n_f32(1.f);
+    x = vminq_f32(x, vdupq_n_f32(88.3762626647949f));
+    x = vmaxq_f32(x, vdupq_n_f32(-88.3762626647949f));
+
+    // exp(x) = 2^n * exp(g)
+    float32x4_t fx = vmlaq_f32(vdupq_n_f32(0.5f), x, vdupq_n_f32(1.44269504088896341f));
+    float32x4_t tmp = vcvtq_f32_s32(vcvtq_s32_f32(fx));
+    uint32x4_t mask = vcgtq_f32(tmp, fx);
+    fx = vsubq_f32(tmp, vreinterpretq_f32_u32(vandq_u32(mask, vreinterpretq_u32_f32(one))));
+
+    x = vmlsq_f32(x, fx, vdupq_n_f32(0.693359375f));
+    x = vmlsq_f32(x, fx, vdupq_n_f32(-2.12194440e-4f));
+    float32x4_t z = vmulq_f32(x, x);
+
+    float32x4_t y = vdupq_n_f32(1.9875691500E-4f);
+    y = vmlaq_f32(vdupq_n_f32(1.3981999507E-3f), y, x);
+    y = vmlaq_f32(vdupq_n_f32(8.3334519073E-3f), y, x);
+    y = vmlaq_f32(vdupq_n_f32(4.1665795894E-2f), y, x);
+    y = vmlaq_f32(vdupq_n_f32(1.6666665459E-1f), y, x);
+    y = vmlaq_f32(vdupq_n_f32(5.0000001201E-1f), y, x);
+    y = vmlaq_f32(x, y, z);
+    y = vaddq_f32(y, one);
+
+    int32x4_t mm = vshlq_n_s32(vaddq_s32(vcvtq_s32_f32(fx), vdupq_n_s32(0x7f)), 23);
+    return vmulq_f32(y, vreinterpretq_f32_s32(mm));
+}
+#elif __SSE2__
+static inline __m128 exp_ps(__m128 x) {
+    const __m128 one = _mm_set1_ps(1.f);
+    x = _mm_min_ps(x, _mm_set1_ps(88.3762626647949f));
+    x = _mm_max_ps(x, _mm_set1_ps(-88.3762626647949f));
+
+    // exp(x) = 2^n * exp(g)
+    __m128 fx = _mm_add_ps(_mm_mul_ps(x, _mm_set1_ps(1.44269504088896341f)), _mm_set1_ps(0.5f));
+    __m128 tmp = _mm_cvtepi32_ps(_mm_cvttps_epi32(fx));
+    __m128 mask = _mm_and_ps(_mm_cmpgt_ps(tmp, fx), one);
+    fx = _mm_sub_ps(tmp, mask);
+
+    x = _mm_sub_ps(x, _mm_mul_ps(fx, _mm_set1_ps(0.693359375f)));
+    x = _mm_sub_ps(x, _mm_mul_ps(fx, _mm_set1_ps(-2.12194440e-4f)));
+    __m128 z = _mm_mul_ps(x, x);
+
+    __m128 y = _mm_set1_ps(1.9875691500E-4f);
+    y = _mm_add_ps(_mm_mul_ps(y, x), _mm_set1_ps(1.3981999507E-3f));
+    y = _mm_add_ps(_mm_mul_ps(y, x), _mm_set1_ps(8.3334519073E-3f));
+    y = _mm_add_ps(_mm_mul_ps(y, x), _mm_set1_ps(4.1665795894E-2f));
+    y = _mm_add_ps(_mm_mul_ps(y, x), _mm_set1_ps(1.6666665459E-1f));
+    y = _mm_add_ps(_mm_mul_ps(y, x), _mm_set1_ps(5.0000001201E-1f));
+    y = _mm_add_ps(_mm_mul_ps(y, z), x);
+    y = _mm_add_ps(y, one);
+
+    __m128i mm = _mm_slli_epi32(_mm_add_epi32(_mm_cvttps_epi32(fx), _mm_set1_epi32(0x7f)), 23);
+    return _mm_mul_ps(y, _mm_castsi128_ps(mm));
+}
+#endif
+
+// 向量化求最大值，n >= 1
+static inline float max_reduce(const float *x, int n) {
+    float max_val = x[0];
+    int i = 0;
+#if __ARM_NEON
+    if (n >= 4) {
+        float32x4_t _max = vld1q_f32(x);
+        for (i = 4; i + 3 < n; i += 4) {
+            _max = vmaxq_f32(_max, vld1q_f32(x + i));
+        }
+#if __aarch64__
+        max_val = vmaxvq_f32(_max);
+#else
+        float32x2_t _max2 = vpmax_f32(vget_low_f32(_max), vget_high_f32(_max));
+        _max2 = vpmax_f32(_max2, _max2);
+        max_val = vget_lane_f32(_max2, 0);
+#endif
+    }
+#elif __SSE2__
+    if (n >= 4) {
+        __m128 _max = _mm_loadu_ps(x);
+        for (i = 4; i + 3 < n; i += 4) {
+            _max = _mm_max_ps(_max, _mm_loadu_ps(x + i));
+        }
+        _max = _mm_max_ps(_max, _mm_shuffle_ps(_max, _max, _MM_SHUFFLE(1, 0, 3, 2)));
+        _max = _mm_max_ps(_max, _mm_shuffle_ps(_max, _max, _MM_SHUFFLE(2, 3, 0, 1)));
+        max_val = _mm_cvtss_f32(_max);
+    }
+#endif
+    for (; i < n; i++) {
+        max_val = x[i] > max_val ? x[i] : max_val;
+    }
+    return max_val;
+}
+
+// 逐元素更新最大值与其索引：x[i] > max_vals[i] 时 max_vals[i] = x[i], max_idx[i] = index
+// 相等时保留已有索引，与按索引递增顺序的标量argmax一致
+static inline void argmax_update(const float *x, float *max_vals, int *max_idx, int n, int index) {
+    int i = 0;
+#if __ARM_NEON
+    int32x4_t _index = vdupq_n_s32(index);
+    for (; i + 3 < n; i += 4) {
+        float32x4_t _x = vld1q_f32(x + i);
+        float32x4_t _max = vld1q_f32(max_vals + i);
+        uint32x4_t _gt = vcgtq_f32(_x, _max);
+        vst1q_f32(max_vals + i, vbslq_f32(_gt, _x, _max));
+        vst1q_s32(max_idx + i, vbslq_s32(_gt, _index, vld1q_s32(max_idx + i)));
+    }
+#elif __SSE2__
+    __m128i _index = _mm_set1_epi32(index);
+    for (; i + 3 < n; i += 4) {
+        __m128 _x = _mm_loadu_ps(x + i);
+        __m128 _max = _mm_loadu_ps(max_vals + i);
+        __m128 _gt = _mm_cmpgt_ps(_x, _max);
+        __m128i _gti = _mm_castps_si128(_gt);
+        __m128i _idx = _mm_loadu_si128((const __m128i *)(max_idx + i));
+        _mm_storeu_ps(max_vals + i, _mm_or_ps(_mm_and_ps(_gt, _x), _mm_andnot_ps(_gt, _max)));
+        _mm_storeu_si128((__m128i *)(max_idx + i), _mm_or_si128(_mm_and_si128(_gti, _index),
+                                                                _mm_andnot_si128(_gti, _idx)));
+    }
+#endif
+    for (; i < n; i++) {
+        if (x[i] > max_vals[i]) {
+            max_vals[i] = x[i];
+            max_idx[i] = index;
+        }
+    }
+}
+
+// DFL分布的softmax期望：sum(i * softmax(x)[i])，n为分布长度（reg_max）
+static inline float softmax_expectation(const float *x, int n) {
+    float max_val = -FLT_MAX;
+    for (int i = 0; i < n; i++) {
+        max_val = x[i] > max_val ? x[i] : max_val;
+    }
+
+    float exp_sum = 0.f;
+    float weighted_sum = 0.f;
+    int i = 0;
+#if __ARM_NEON
+    float32x4_t _max = vdupq_n_f32(max_val);
+    float32x4_t _sum = vdupq_n_f32(0.f);
+    float32x4_t _wsum = vdupq_n_f32(0.f);
+    float32x4_t _index = {0.f, 1.f, 2.f, 3.f};
+    const float32x4_t _four = vdupq_n_f32(4.f);
+    for (; i + 3 < n; i += 4) {
+        float32x4_t _e = exp_ps(vsubq_f32(vld1q_f32(x + i), _max));
+        _sum = vaddq_f32(_sum, _e);
+        _wsum = vmlaq_f32(_wsum, _e, _index);
+        _index = vaddq_f32(_index, _four);
+    }
+    float sum_buf[4];
+    float wsum_buf[4];
+    vst1q_f32(sum_buf, _sum);
+    vst1q_f32(wsum_buf, _wsum);
+    exp_sum = sum_buf[0] + sum_buf[1] + sum_buf[2] + sum_buf[3];
+    weighted_sum = wsum_buf[0] + wsum_buf[1] + wsum_buf[2] + wsum_buf[3];
+#elif __SSE2__
+    __m128 _max = _mm_set1_ps(max_val);
+    __m128 _sum = _mm_setzero_ps();
+    __m128 _wsum = _mm_setzero_ps();
+    __m128 _index = _mm_setr_ps(0.f, 1.f, 2.f, 3.f);
+    const __m128 _four = _mm_set1_ps(4.f);
+    for (; i + 3 < n; i += 4) {
+        __m128 _e = exp_ps(_mm_sub_ps(_mm_loadu_ps(x + i), _max));
+        _sum = _mm_add_ps(_sum, _e);
+        _wsum = _mm_add_ps(_wsum, _mm_mul_ps(_e, _index));
+        _index = _mm_add_ps(_index, _four);
+    }
+    float sum_buf[4];
+    float wsum_buf[4];
+    _mm_storeu_ps(sum_buf, _sum);
+    _mm_storeu_ps(wsum_buf, _wsum);
+    exp_sum = sum_buf[0] + sum_buf[1] + sum_buf[2] + sum_buf[3];
+    weighted_sum = wsum_buf[0] + wsum_buf[1] + wsum_buf[2] + wsum_buf[3];
+#endif
+    for (; i < n; i++) {
+        float e = expf(x[i] - max_val);
+        exp_sum += e;
+        weighted_sum += i * e;
+    }
+    return weighted_sum / exp_sum;
+}
+
+} // namespace simd
+
+#endif // SIMD_MATH_H
@@ -0,0 +1,310 @@
+#include "tracker.h"
+#include <algorithm>
+
+namespace tracker {
+
+// 过程与观测噪声的标准差按框的宽高缩放（同ByteTrack/BoT-SORT）
+static const float STD_WEIGHT_POSITION = 1.0f / 20;
+static const float STD_WEIGHT_VELOCITY = 1.0f / 160;
+
+Config default_config() {
+    Config config;
+    config.high_threshold = 0.0f;
+    config.low_threshold = 0.0f;
+    config.match_iou = 0.3f;
+    config.low_match_iou = 0.5f;
+    config.min_hits = 2;
+    config.max_lost = 30;
+    return config;
+}
+
+static inline float square(float x) { return x * x; }
+
+static inline float box_iou(float ax1, float ay1, float ax2, float ay2, const yolo::BoxInfo &b) {
+    float w = std::min(ax2, b.x2) - std::max(ax1, b.x1);
+    float h = std::min(ay2, b.y2) - std::max(ay1, b.y1);
+    if (w <= 0 || h <= 0) {
+        return 0.0f;
+    }
+    float inter = w * h;
+    float area = (ax2 - ax1) * (ay2 - ay1) + (b.x2 - b.x1) * (b.y2 - b.y1) - inter;
+    return area > 0 ? inter / area : 0.0f;
+}
+
+Tracker::Tracker(const Config &config) : config(config), next_id(1), first_frame(true) {}
+
+void Tracker::reset() {
+    tracks.clear();
+    next_id = 1;
+    first_frame = true;
+}
+
+void Tracker::init_track(TrackInfo &track, const yolo::BoxInfo &box) {
+    float z[4] = {(box.x1 + box.x2) * 0.5f, (box.y1 + box.y2) * 0.5f, box.x2 - box.x1, box.y2 - box.y1};
+    for (int i = 0; i < 4; i++) {
+        // x与宽按宽缩放，y与高按高缩放
+        float size = std::max(z[2 + (i & 1)], 1.0f);
+        KalmanAxis &axis = track.axis[i];
+        axis.p = z[i];
+        axis.v = 0;
+        axis.a = square(2 * STD_WEIGHT_POSITION * size);
+        axis.b = 0;
+        axis.c = square(10 * STD_WEIGHT_VELOCITY * size);
+    }
+    track.label = box.label;
+    track.score = box.score;
+    track.hits = 1;
+    track.lost = 0;
+}
+
+void Tracker::predict_track(TrackInfo &track, int steps) {
+    for (int step = 0; step < steps; step++) {
+        float w = std::max(track.axis[2].p, 1.0f);
+        float h = std::max(track.axis[3].p, 1.0f);
+        for (int i = 0; i < 4; i++) {
+            float size = (i & 1) ? h : w;
+            KalmanAxis &axis = track.axis[i];
+            // F = [[1, 1], [0, 1]]，P = F P F^T + Q
+            axis.p += axis.v;
+            axis.a += 2 * axis.b + axis.c + square(STD_WEIGHT_POSITION * size);
+            axis.b += axis.c;
+            axis.c += square(STD_WEIGHT_VELOCITY * size);
+        }
+        track.axis[2].p = std::max(track.axis[2].p, 1.0f);
+        track.axis[3].p = std::max(track.axis[3].p, 1.0f);
+    }
+    track.lost += steps;
+}
+
+void Tracker::update_track(TrackInfo &track, const yolo::BoxInfo &box) {
+    float z[4] = {(box.x1 + box.x2) * 0.5f, (box.y1 + box.y2) * 0.5f, box.x2 - box.x1, box.y2 - box.y1};
+    float w = std::max(track.axis[2].p, 1.0f);
+    float h = std::max(track.axis[3].p, 1.0f);
+    for (int i = 0; i < 4; i++) {
+        KalmanAxis &axis = track.axis[i];
+        // H = [1, 0]，K = P H^T / (a + r)，P = (I - K H) P
+        float r = square(STD_WEIGHT_POSITION * ((i & 1) ? h : w));
+        float s = axis.a + r;
+        float k0 = axis.a / s;
+        float k1 = axis.b / s;
+        float residual = z[i] - axis.p;
+        axis.p += k0 * residual;
+        axis.v += k1 * residual;
+        axis.c -= k1 * axis.b;
+        axis.b -= k0 * axis.b;
+        axis.a -= k0 * axis.a;
+    }
+    track.axis[2].p = std::max(track.axis[2].p, 1.0f);
+    track.axis[3].p = std::max(track.axis[3].p, 1.0f);
+    track.score = box.score;
+    track.hits++;
+    track.lost = 0;
+}
+
+void Tracker::track_box(const TrackInfo &track, float &x1, float &y1, float &x2, float &y2) const {
+    float half_w = track.axis[2].p * 0.5f;
+    float half_h = track.axis[3].p * 0.5f;
+    x1 = track.axis[0].p - half_w;
+    y1 = track.axis[1].p - half_h;
+    x2 = track.axis[0].p + half_w;
+    y2 = track.axis[1].p + half_h;
+}
+
+void Tracker::associate(std::vector<int> &track_ids, std::vector<int> &detection_ids,
+                        const std::vector<yolo::BoxInfo> &detections, float min_iou) {
+    int track_count = (int)track_ids.size();
+    int detection_count = (int)detection_ids.size();
+    if (track_count == 0 || detection_count == 0) {
+        return;
+    }
+
+    boxes.resize((size_t)track_count * 4);
+    for (int i = 0; i < track_count; i++) {
+        float *box = &boxes[(size_t)i * 4];
+        track_box(tracks[track_ids[i]], box[0], box[1], box[2], box[3]);
+    }
+
+    // 轨迹（0 ~ track_count-1）与检测框（track_count起）按左边界排序后扫描，
+    // 活动列表中只保留右边界不小于当前左边界的框，x区间不相交的对不计算IoU
+    order.resize(track_count + detection_count);
+    for (int i = 0; i < (int)order.size(); i++) {
+        order[i] = i;
+    }
+    auto left = [&](int entry) {
+        return entry < track_count ? boxes[(size_t)entry * 4] : detections[detection_ids[entry - track_count]].x1;
+    };
+    std::sort(order.begin(), order.end(), [&](int lhs, int rhs) { return left(lhs) < left(rhs); });
+
+    active_tracks.clear();
+    active_detections.clear();
+    pairs.clear();
+    for (int entry : order) {
+        float x1 = left(entry);
+        if (entry < track_count) {
+            const float *box = &boxes[(size_t)entry * 4];
+            size_t kept = 0;
+            for (int d : active_detections) {
+                const yolo::BoxInfo &detection = detections[detection_ids[d]];
+                if (detection.x2 < x1) {
+                    continue;
+                }
+                active_detections[kept++] = d;
+                if (detection.label == tracks[track_ids[entry]].label) {
+                    float iou = box_iou(box[0], box[1], box[2], box[3], detection);
+                    if (iou >= min_iou) {
+                        pairs.push_back({iou, entry, d});
+                    }
+                }
+            }
+            active_detections.resize(kept);
+            active_tracks.push_back(entry);
+        } else {
+            int d = entry - track_count;
+            const yolo::BoxInfo &detection = detections[detection_ids[d]];
+            size_t kept = 0;
+            for (int t : active_tracks) {
+                const float *box = &boxes[(size_t)t * 4];
+                if (box[2] < x1) {
+                    continue;
+                }
+                active_tracks[kept++] = t;
+                if (detection.label == tracks[track_ids[t]].label) {
+                    float iou = box_iou(box[0], box[1], box[2], box[3], detection);
+                    if (iou >= min_iou) {
+                        pairs.push_back({iou, t, d});
+                    }
+                }
+            }
+            active_tracks.resize(kept);
+            active_detections.push_back(d);
+        }
+    }
+
+    // IoU从大到小贪心分配，相等时按下标，结果与扫描顺序无关
+    std::sort(pairs.begin(), pairs.end(), [](const Pair &lhs, const Pair &rhs) {
+        if (lhs.iou != rhs.iou) {
+            return lhs.iou > rhs.iou;
+        }
+        return lhs.track != rhs.track ? lhs.track < rhs.track : lhs.detection < rhs.detection;
+    });
+    std::vector<char> track_used(track_count, 0);
+    std::vector<char> detection_used(detection_count, 0);
+    for (const Pair &pair : pairs) {
+        if (track_used[pair.track] || detection_used[pair.detection]) {
+            continue;
+        }
+        track_used[pair.track] = 1;
+        detection_used[pair.detection] = 1;
+        update_track(tracks[track_ids[pair.track]], detections[detection_ids[pair.detection]]);
+    }
+
+    size_t kept = 0;
+    for (int i = 0; i < track_count; i++) {
+        if (!track_used[i]) {
+            track_ids[kept++] = track_ids[i];
+        }
+    }
+    track_ids.resize(kept);
+    kept = 0;
+    for (int i = 0; i < detection_count; i++) {
+        if (!detection_used[i]) {
+            detection_ids[kept++] = detection_ids[i];
+        }
+    }
+    detection_ids.resize(kept);
+}
+
+void Tracker::update(const std::vector<yolo::BoxInfo> &detections, int steps, std::vector<Track> &out) {
+    steps = std::max(steps, 1);
+    for (TrackInfo &track : tracks) {
+        predict_track(track, steps);
+    }
+
+    std::vector<int> high;
+    std::vector<int> low;
+    for (int i = 0; i < (int)detections.size(); i++) {
+        if (detections[i].score >= config.high_threshold) {
+            high.push_back(i);
+        } else if (detections[i].score >= config.low_threshold) {
+            low.push_back(i);
+        }
+    }
+
+    // 第一轮：高分框与已确认的轨迹（含丢失中的轨迹，重新出现时沿用原ID）
+    std::vector<int> confirmed;
+    std::vector<int> tentative;
+    for (int i = 0; i < (int)tracks.size(); i++) {
+        (tracks[i].state == STATE_TENTATIVE ? tentative : confirmed).push_back(i);
+    }
+    associate(confirmed, high, detections, config.match_iou);
+
+    // 第二轮：低分框只延续上一识别帧仍在跟踪的轨迹（遮挡、运动模糊时置信度下降）
+    std::vector<int> tracked;
+    for (int i : confirmed) {
+        if (tracks[i].state == STATE_TRACKED) {
+            tracked.push_back(i);
+        }
+    }
+    associate(tracked, low, detections, config.low_match_iou);
+
+    // 第三轮：剩余高分框与未确认的轨迹
+    associate(tentative, high, detections, config.match_iou);
+
+    // 匹配到的轨迹lost已归零
+    for (TrackInfo &track : tracks) {
+        if (track.lost == 0) {
+            if (track.state == STATE_LOST || track.hits >= config.min_hits) {
+                track.state = STATE_TRACKED;
+            }
+        } else if (track.state == STATE_TRACKED) {
+            track.state = STATE_LOST;
+        }
+    }
+    // 删除未匹配的新轨迹与丢失过久的轨迹
+    tracks.erase(std::remove_if(tracks.begin(), tracks.end(),
+                                [this](const TrackInfo &track) {
+                                    return (track.state == STATE_TENTATIVE && track.lost > 0) ||
+                                           (track.state == STATE_LOST && track.lost > config.max_lost);
+                                }),
+                 tracks.end());
+
+    // 剩余高分框新建轨迹
+    for (int i : high) {
+        TrackInfo track;
+        init_track(track, detections[i]);
+        track.id = next_id++;
+        track.state = first_frame || config.min_hits <= 1 ? STATE_TRACKED : STATE_TENTATIVE;
+        tracks.push_back(track);
+    }
+    first_frame = false;
+    collect(out);
+}
+
+void Tracker::predict(int steps, std::vector<Track> &out) {
+    steps = std::max(steps, 1);
+    for (TrackInfo &track : tracks) {
+        predict_track(track, steps);
+    }
+    tracks.erase(std::remove_if(tracks.begin(), tracks.end(),
+                                [this](const TrackInfo &track) { return track.lost > config.max_lost; }),
+                 tracks.end());
+    collect(out);
+}
+
+void Tracker::collect(std::vector<Track> &out) const {
+    out.clear();
+    for (const TrackInfo &info : tracks) {
+        if (info.state != STATE_TRACKED) {
+            continue;
+        }
+        Track track;
+        track.id = info.id;
+        track.label = info.label;
+        track_box(info, track.x1, track.y1, track.x2, track.y2);
+        track.score = info.score;
+        track.predicted = info.lost > 0;
+        out.push_back(track);
+    }
+}
+
+} // namespace tracker
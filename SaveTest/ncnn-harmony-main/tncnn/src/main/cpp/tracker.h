@@ -0,0 +1,116 @@
+#ifndef TRACKER_H
+#define TRACKER_H
+
+#include "yolov8.h"
+#include <cstddef>
+#include <vector>
+
+namespace tracker {
+
+// 跟踪参数
+typedef struct Config {
+    float high_threshold;  // 不低于该置信度的检测框参与首轮匹配并可以新建轨迹；0表示识别器输出的框都是高分框
+    float low_threshold;   // 低于high_threshold、不低于该值的框只用于延续已有轨迹（ByteTrack第二轮匹配）
+    float match_iou;       // 高分框与轨迹匹配的最低IoU
+    float low_match_iou;   // 低分框与轨迹匹配的最低IoU
+    int min_hits;          // 新轨迹匹配到该次数后才输出（第一帧的轨迹直接输出）
+    int max_lost;          // 轨迹丢失超过该帧数后删除，期间重新匹配到时沿用原ID
+} Config;
+
+// 默认参数：识别器的阈值已过滤低分框，默认不区分高低分；新轨迹连续两次检测到才输出，丢失1秒（30帧）后删除
+Config default_config();
+
+// 输出的一条轨迹
+typedef struct Track {
+    int id;               // 轨迹ID，从1开始，同一Tracker内不重复
+    int label;
+    float x1;
+    float y1;
+    float x2;
+    float y2;
+    float score;          // 最近一次匹配到的检测框置信度
+    bool predicted;       // 本帧没有匹配到检测框，坐标为卡尔曼滤波的预测值
+} Track;
+
+// 多目标跟踪（ByteTrack/SORT）
+// 每条轨迹用匀速模型的卡尔曼滤波跟踪框中心与宽高；识别帧上先预测，再按IoU与检测框匹配（只在同类别间匹配），
+// 未识别的帧只预测，输出平滑的框，识别器可以每N帧运行一次。
+// 匹配先按x区间扫描（sort and sweep）找出相交的轨迹与检测框对，再按IoU从大到小贪心分配，
+// 复杂度O((n + k) log(n + k))，n为轨迹与检测框数，k为相交的对数，数百条轨迹也不需要n²的IoU矩阵。
+// 非线程安全，由一个线程使用。
+class Tracker {
+public:
+    explicit Tracker(const Config &config);
+
+    // 识别帧：预测steps帧后与检测框匹配并更新，out为当前输出的轨迹
+    // steps为距上一次update/predict的帧数（跳帧时大于1），至少为1
+    void update(const std::vector<yolo::BoxInfo> &detections, int steps, std::vector<Track> &out);
+
+    // 未识别的帧：只预测steps帧
+    void predict(int steps, std::vector<Track> &out);
+
+    void reset();
+
+    // 跟踪中与丢失中的轨迹总数
+    size_t size() const { return tracks.size(); }
+
+private:
+    // 一维匀速卡尔曼滤波，状态为位置p与速度v，协方差为[[a, b], [b, c]]
+    // 中心x、中心y、宽、高四个维度的过程与观测噪声相互独立，8维滤波等价于4个2维滤波
+    typedef struct KalmanAxis {
+        float p;
+        float v;
+        float a;
+        float b;
+        float c;
+    } KalmanAxis;
+
+    enum TrackState {
+        STATE_TENTATIVE = 0,   // 新建，尚未确认
+        STATE_TRACKED = 1,     // 最近一次识别帧匹配到
+        STATE_LOST = 2         // 确认过，最近一次识别帧没有匹配到
+    };
+
+    typedef struct TrackInfo {
+        int id;
+        int label;
+        int state;
+        int hits;              // 匹配次数
+        int lost;              // 距最近一次匹配的帧数
+        float score;
+        KalmanAxis axis[4];    // cx, cy, w, h
+    } TrackInfo;
+
+    // 相交的轨迹-检测框对
+    typedef struct Pair {
+        float iou;
+        int track;
+        int detection;
+    } Pair;
+
+    void init_track(TrackInfo &track, const yolo::BoxInfo &box);
+    void predict_track(TrackInfo &track, int steps);
+    void update_track(TrackInfo &track, const yolo::BoxInfo &box);
+    void track_box(const TrackInfo &track, float &x1, float &y1, float &x2, float &y2) const;
+
+    // 在track_ids与detection_ids之间匹配，匹配成功的轨迹直接更新，并从两个列表中移除
+    void associate(std::vector<int> &track_ids, std::vector<int> &detection_ids,
+                   const std::vector<yolo::BoxInfo> &detections, float min_iou);
+    void collect(std::vector<Track> &out) const;
+
+    Config config;
+    std::vector<TrackInfo> tracks;
+    int next_id;
+    bool first_frame;
+
+    // 匹配过程复用的缓冲区
+    std::vector<float> boxes;       // 参与匹配的轨迹的预测框，每条4个值
+    std::vector<int> order;
+    std::vector<int> active_tracks;
+    std::vector<int> active_detections;
+    std::vector<Pair> pairs;
+};
+
+} // namespace tracker
+
+#endif // TRACKER_H
@@ -11,6 +11,104 @@ export const ncnn_version: () => string;
 
 // --------------------------------------------[ yolo end ]--------------------------------------------
 
+// --------------------------------------------[ detector start ]--------------------------------------------
+// 检测器句柄：每个句柄持有一个独立的模型实例，可同时存在多个模型或同一模型的多个实例
+// 句柄被回收或调用detector_release后实例销毁，进行中的推理会保持实例直到结束
+// 传给taskpool时句柄只保留id属性，各接口同样接受句柄或id
+export interface DetectorHandle {
+  readonly id: number;
+  readonly modelType: string;
+}
+
+// 创建检测器，失败返回undefined
+export const detector_create: (
+  resMgr: resourceManager.ResourceManager,
+  sanboxPath: string,
+  modelType: string,     // "nanodet-m", "yolov8n"等
+  option: any,
+  config: any
+) => DetectorHandle | undefined;
+
+export const detector_run: (
+  detector: DetectorHandle | number,
+  imgData: ArrayBuffer,
+  imgWidth: number,
+  imgHeight: number,
+  userId?: string,
+  uuid?: string,
+  timeSent?: string
+) => any[];
+
+// 仅YOLOv8，帧参数要求同yolov8_run_nv21
+export const detector_run_nv21: (
+  detector: DetectorHandle | number,
+  nv21Data: ArrayBuffer,
+  imgWidth: number,
+  imgHeight: number,
+  rowStride: number,
+  rotation: number,
+  userId?: string,
+  uuid?: string,
+  timeSent?: string
+) => any[];
+
+// 仅YOLOv8，返回false表示句柄无效或模型不支持；该实例上的推流随后重新识别，不再沿用按旧阈值得到的结果
+export const detector_set_thresholds: (
+  detector: DetectorHandle | number,
+  confThreshold: number,
+  nmsThreshold: number,
+  classThresholds?: number[]
+) => boolean;
+
+export const detector_release: (
+  detector: DetectorHandle | number
+) => boolean;
+
+// 打包结果：所有框写入一个ArrayBuffer，每个框stride(8)个4字节字段
+// new Float32Array(boxes) 读取 [0]x1 [1]y1 [2]x2 [3]y2 [4]x_center [5]y_center [6]score
+// new Int32Array(boxes) 读取 [7]label，类别名称通过detector_labels取得的表按label查找
+export interface PackedDetections {
+  count: number;
+  stride: number;
+  boxes: ArrayBuffer;
+  uuid: string;
+  timeSent: string;
+}
+
+// 设置结果模式，packed为true时detector_run*返回PackedDetections（以any[]声明的返回值需按此转换）
+export const detector_set_packed: (
+  detector: DetectorHandle | number,
+  packed: boolean
+) => boolean;
+
+// 类别表，下标为label；userId为"SNHA"时names为物料编码
+export const detector_labels: (
+  detector: DetectorHandle | number,
+  userId?: string
+) => { names: string[], imglabels: string[] } | undefined;
+
+// 推理blob的内存统计（开启mempool时有效）：按帧重置的arena容量、单帧分配量、未释放量及其峰值（字节），
+// 分配次数与其中超出arena的次数
+// 内存占用约为 capacity + 溢出部分的存活峰值（不超过peakLiveBytes）：arena只扩大到单帧分配总量（peakFrameBytes）与
+// 32MB中的较小者，YOLOv8 640输入的单帧分配总量为数十到上百MB，超出部分由内存池分配并跨帧复用
+export interface DetectorMemoryStats {
+  capacity: number;
+  frameBytes: number;
+  peakFrameBytes: number;
+  liveBytes: number;
+  peakLiveBytes: number;
+  allocations: number;
+  fallbackAllocations: number;
+  liveAllocations: number;
+  frames: number;
+}
+
+export const detector_memory_stats: (
+  detector: DetectorHandle | number
+) => DetectorMemoryStats | undefined;
+
+// --------------------------------------------[ detector end ]--------------------------------------------
+
 // --------------------------------------------[ nanodet start ]--------------------------------------------
 // ---------------------------------- 早期版本的 nanodet，新版本的模型有变化
 export const nanodet_init: (
@@ -48,17 +146,412 @@ export const yolov8_run: (
   timeSent?: string     // 时间戳（透传）
 ) => any[];
 
+// 相机NV21原始帧识别，YUV转RGB、旋转与letterbox缩放在native一次完成
+// 返回的坐标位于旋转后的图像坐标系；宽高须为不小于4的偶数，rotation只能是0/90/180/270，否则返回undefined
+export const yolov8_run_nv21: (
+  nv21Data: ArrayBuffer, // NV21数据（Y平面后接VU交错平面）
+  imgWidth: number,      // 原始帧宽度（旋转前）
+  imgHeight: number,     // 原始帧高度（旋转前）
+  rowStride: number,     // 行跨度（字节）
+  rotation: number,      // 顺时针旋转角度（0/90/180/270）
+  modelType?: string,
+  userId?: string,
+  uuid?: string,
+  timeSent?: string
+) => any[];
+
+// 设置置信度与NMS阈值，classThresholds可为每个类别单独指定置信度阈值
+// 返回false表示模型尚未初始化
+export const yolov8_set_thresholds: (
+  confThreshold: number,
+  nmsThreshold: number,
+  classThresholds?: number[]
+) => boolean;
+
 // --------------------------------------------[ yolov8 end ]--------------------------------------------
 
 // --------------------------------------------[ benchmark start ]--------------------------------------------
+// 预热与冷却：warmupMs大于0时按时长预热（忽略warmupLoops，默认预热5次），cooldownMs为每轮之间的休眠
+// profile开启逐层计时，结果在BenchmarkResult.layers中，byName只返回耗时最多的topN层（默认20）
+export interface BenchmarkSettings {
+  warmupLoops?: number;
+  warmupMs?: number;
+  cooldownMs?: number;
+  profile?: boolean;
+  topN?: number;
+}
+
+// 逐层耗时（所有测试轮次累计），byType按层类型汇总（name为空）
+export interface LayerStat {
+  name: string;
+  type: string;
+  count: number;
+  total: number;
+  avg: number;
+  max: number;
+  percent: number;
+}
+
+// total为所有层的累计耗时；trace为最后一轮的Chrome trace JSON（chrome://tracing 或 Perfetto 打开）
+export interface LayerProfile {
+  total: number;
+  byName: LayerStat[];
+  byType: LayerStat[];
+  trace: string;
+}
+
+// 耗时均为毫秒；cold为加载后的第一次推理（不计入统计），drift为后1/4与前1/4样本均值之差
+export interface BenchmarkResult {
+  loop: number;
+  min: number;
+  max: number;
+  avg: number;
+  p50: number;
+  p90: number;
+  p99: number;
+  stddev: number;
+  cold: number;
+  drift: number;
+  warmupLoops: number;
+  warmupMs: number;
+  histogram: { min: number, width: number, counts: number[] };
+  samples: number[];
+  width: number;
+  height: number;
+  layers?: LayerProfile;
+}
+
 export const benchmark_ncnn: (
   sanboxPath: string,
   model_name: string,
   param_name: string,
   option: any,
   config: any,
-  loop: number
-) => any;
+  loop: number,
+  resMgr?: resourceManager.ResourceManager,
+  settings?: BenchmarkSettings
+) => BenchmarkResult;
+
+export const benchmark_nms: (
+  loop?: number
+) => Array<{ boxes: number, kept: number, min: number, avg: number }>;
+
+// 结果转换耗时（ms）：对象数组与打包结果，分别为10/100/300个框
+export const benchmark_marshal: (
+  loop?: number
+) => Array<{ boxes: number, objects: number, packed: number }>;
 
 // --------------------------------------------[ benchmark end ]--------------------------------------------
 
+// --------------------------------------------[ async start ]--------------------------------------------
+// 异步接口：预处理、推理与后处理在native工作线程执行，不经过taskpool序列化，输入ArrayBuffer不拷贝（完成前不要修改）
+// 同一实例上排队的新帧会取代尚未开始的旧帧，被取代的Promise以 code == 'SUPERSEDED' 拒绝
+// 模型未初始化时以 'NOT_READY' 拒绝，参数无效时以 'INVALID_ARGUMENT' 拒绝
+export const detector_run_async: (
+  detector: DetectorHandle | number,
+  imgData: ArrayBuffer,
+  imgWidth: number,
+  imgHeight: number,
+  userId?: string,
+  uuid?: string,
+  timeSent?: string
+) => Promise<any[]>;
+
+// 帧参数无效时以INVALID_ARGUMENT拒绝
+export const detector_run_nv21_async: (
+  detector: DetectorHandle | number,
+  nv21Data: ArrayBuffer,
+  imgWidth: number,
+  imgHeight: number,
+  rowStride: number,
+  rotation: number,
+  userId?: string,
+  uuid?: string,
+  timeSent?: string
+) => Promise<any[]>;
+
+// 取消实例上所有排队中的异步识别
+export const detector_cancel: (
+  detector: DetectorHandle | number
+) => boolean;
+
+export const yolov8_run_async: (
+  imgData: ArrayBuffer,
+  imgWidth: number,
+  imgHeight: number,
+  modelType?: string,
+  userId?: string,
+  uuid?: string,
+  timeSent?: string
+) => Promise<any[]>;
+
+export const nanodet_run_async: (
+  imgData: ArrayBuffer,
+  imgWidth: number,
+  imgHeight: number
+) => Promise<any[]>;
+
+export const benchmark_ncnn_async: (
+  sanboxPath: string,
+  model_name: string,
+  param_name: string,
+  option: any,
+  config: any,
+  loop: number,
+  resMgr?: resourceManager.ResourceManager,
+  settings?: BenchmarkSettings
+) => Promise<BenchmarkResult>;
+
+// 选项组合测试，遍历winograd/sgemm/packing/lightMode与精度（fp32/bf16/fp16）的组合（不支持的精度跳过）
+// 返回JSON字符串 {model, device, results: [{rank, ok, winograd, ..., min, p50, p90, p99, max, avg,
+// peakBlobBytes, peakWorkspaceBytes}]}，按p50升序，同时保存到 <sanboxPath>/benchmark_sweep_<model_name>.json
+export const benchmark_sweep: (
+  sanboxPath: string,
+  model_name: string,
+  param_name: string,
+  option: any,
+  config: any,
+  loop: number,
+  resMgr?: resourceManager.ResourceManager,
+  settings?: BenchmarkSettings
+) => Promise<string>;
+
+export interface PipelineImage {
+  data: ArrayBuffer;  // RGBA
+  width: number;
+  height: number;
+}
+
+// 各阶段的耗时统计；RGBA输入的转换、缩放与归一化在一次调用中完成，计入resize，convert与normalize为0
+// marshal为结果转换为JS对象的耗时，total为识别与结果转换的总耗时
+export interface PipelineStages {
+  convert: BenchmarkResult;
+  resize: BenchmarkResult;
+  normalize: BenchmarkResult;
+  forward: BenchmarkResult;
+  decode: BenchmarkResult;
+  nms: BenchmarkResult;
+  marshal: BenchmarkResult;
+  total: BenchmarkResult;
+}
+
+// 预热后计时期间的推理blob分配；steadyState表示使用了arena（mempool开启）且blob全部来自arena，
+// arena达到上限后溢出的blob由内存池复用，此时fallbackAllocations不为0但同样不再分配堆内存
+// 只统计blob，workspace由内存池回收，ncnn内部结构（如extractor的blob表）不在统计范围内
+export interface PipelineMemory {
+  allocations: number;
+  fallbackAllocations: number;
+  arenaCapacity: number;
+  steadyState: boolean;
+}
+
+export interface PipelineResult {
+  modelType: string;
+  images: number;
+  loop: number;
+  detections: number;  // 平均检测框数
+  stages: PipelineStages;
+  memory: PipelineMemory;
+}
+
+// 端到端测试：使用真实权重识别真实图像，每轮依次识别所有图像，统计预处理、推理、后处理与结果转换各阶段耗时
+export const benchmark_pipeline: (
+  resMgr: resourceManager.ResourceManager,
+  sanboxPath: string,
+  modelType: string,
+  option: any,
+  config: any,
+  images: PipelineImage[],
+  loop: number,
+  settings?: BenchmarkSettings
+) => Promise<PipelineResult>;
+
+// 流水线设置：maxInFlight为在途帧数上限（默认3），inferThreads默认为CPU核心数减2（预处理与后处理各占一个核心）
+export interface PipelinedSettings {
+  warmupLoops?: number;
+  maxInFlight?: number;
+  inferThreads?: number;
+}
+
+// fps为吞吐，wall为全部帧的总耗时，latency为每帧延迟（流水线为提交到后处理完成）
+export interface ExecutionResult {
+  fps: number;
+  wall: number;
+  detections: number;
+  latency: BenchmarkResult;
+}
+
+export interface PipelinedResult {
+  modelType: string;
+  frames: number;
+  serialThreads: number;
+  inferThreads: number;
+  maxInFlight: number;
+  serial: ExecutionResult;
+  pipelined: ExecutionResult;
+  speedup: number;  // 串行总耗时 / 流水线总耗时
+}
+
+// 串行与三段流水线（预处理N+1、推理N、后处理N-1同时进行）的吞吐与延迟对比，仅YOLOv8
+export const benchmark_pipelined: (
+  resMgr: resourceManager.ResourceManager,
+  sanboxPath: string,
+  modelType: string,
+  option: any,
+  config: any,
+  images: PipelineImage[],
+  loop: number,
+  settings?: PipelinedSettings
+) => Promise<PipelinedResult>;
+
+// 批量识别选项：workers默认按核心数（有大小核时为大核数），threadsPerWorker默认1
+export interface BatchOptions {
+  workers?: number;
+  threadsPerWorker?: number;
+  userId?: string;
+}
+
+// 批量识别（默认YOLOv8实例，需先yolov8_init），多个extractor共用一个net并行识别，结果按图片顺序，每项同yolov8_run
+export const yolov8_run_batch: (
+  images: PipelineImage[],
+  options?: BatchOptions
+) => Promise<any[][]>;
+
+// --------------------------------------------[ async end ]--------------------------------------------
+
+
+// --------------------------------------------[ stream start ]--------------------------------------------
+// 推流识别：帧拷贝到原生帧环后立即返回，推理线程总是识别最新的一帧，结果在JS线程回调
+// 帧格式与尺寸在推流期间固定；nv21仅支持YOLOv8，rotation为顺时针旋转角度，结果坐标为旋转后的图像坐标
+// 静止画面门限：画面相对上次识别的帧变化的网格（32x24）占比不超过changedRatio（默认0.005）且未超过maxAgeMs（默认1000）时
+// 不识别，回调上次的结果；cellThreshold为网格亮度均值视为变化的阈值（0~255，默认12）
+export interface SceneGateOptions {
+  cellThreshold?: number;
+  changedRatio?: number;
+  maxAgeMs?: number;
+}
+
+// 多目标跟踪：每个框增加稳定的trackId（仅YOLOv8，打包结果不含trackId）
+// detectEvery大于1时每N帧识别一次，其余帧输出卡尔曼滤波预测的框（不经过静止画面门限）；highThreshold默认0（识别器输出的框都可以新建轨迹），
+// 低于highThreshold、不低于lowThreshold的框只延续已有轨迹；新轨迹匹配minHits次（默认2）后输出，丢失maxLost帧（默认30）后删除
+export interface TrackOptions {
+  detectEvery?: number;
+  highThreshold?: number;
+  lowThreshold?: number;
+  matchIou?: number;     // 默认0.3
+  lowMatchIou?: number;  // 默认0.5
+  minHits?: number;
+  maxLost?: number;
+}
+
+export interface StreamOptions {
+  format: 'nv21' | 'rgba';
+  width: number;
+  height: number;
+  stride?: number;    // 仅nv21，默认等于width
+  rotation?: number;  // 仅nv21，0/90/180/270；nv21的宽高须为不小于4的偶数
+  slots?: number;     // 帧环槽数，默认3
+  userId?: string;
+  gate?: boolean | SceneGateOptions;  // 开启静止画面门限
+  track?: boolean | TrackOptions;     // 开启多目标跟踪
+}
+
+// latency为入队到回调的延迟，inference为识别耗时（毫秒）
+export interface StreamFrameInfo {
+  seq: number;
+  width: number;
+  height: number;
+  latency: number;
+  inference: number;
+  cached: boolean;    // 画面未变化，沿用上次识别的结果（inference为0）
+  predicted: boolean; // 本帧未识别，框为跟踪预测（inference为0）
+}
+
+export interface SceneGateStats {
+  frames: number;       // 经过门限的帧（开启跟踪时不含只预测的帧）
+  inferred: number;
+  skipped: number;      // 沿用上次结果、未识别的帧
+  forced: number;       // 画面未变化但超过maxAgeMs而识别的帧
+  skipRatio: number;
+  lastChanged: number;  // 最近一帧的变化网格占比
+}
+
+export interface StreamStats {
+  pushed: number;
+  dropped: number;         // 未处理即被更新的帧覆盖
+  rejected: number;
+  processed: number;
+  predicted: number;       // 开启跟踪时只预测、未识别的帧
+  delivered: number;
+  resultsDropped: number;  // JS线程积压时丢弃的结果
+  avgLatency: number;
+  maxLatency: number;
+  gate?: SceneGateStats;   // 开启门限时
+}
+
+export interface DetectorStream {
+}
+
+// 失败返回undefined；句柄被回收或调用detector_stream_stop后停止
+export const detector_stream_start: (
+  detector: DetectorHandle | number,
+  callback: (boxes: any, info: StreamFrameInfo) => void,
+  options: StreamOptions
+) => DetectorStream | undefined;
+
+export const detector_stream_push: (
+  stream: DetectorStream,
+  frameData: ArrayBuffer
+) => boolean;
+
+export const detector_stream_stop: (
+  stream: DetectorStream
+) => boolean;
+
+export const detector_stream_stats: (
+  stream: DetectorStream
+) => StreamStats | undefined;
+
+// --------------------------------------------[ stream end ]--------------------------------------------
+
+
+// --------------------------------------------[ autotune start ]--------------------------------------------
+// powersave同config.core：0全部 1小核 2大核；耗时单位为毫秒
+export interface AutotuneCandidate {
+  numThreads: number;
+  powersave: number;
+  min: number;
+  avg: number;
+}
+
+export interface AutotuneResult {
+  modelType: string;
+  device: string;
+  numThreads: number;
+  powersave: number;
+  avg: number;
+  candidates: AutotuneCandidate[];
+}
+
+// 对线程数 × 核心的组合测速并保存到沙盒，之后以自动线程数（config.thread为0）初始化该模型时自动应用
+export const autotune_run: (
+  resMgr: resourceManager.ResourceManager,
+  sanboxPath: string,
+  modelType: string,
+  option: any,
+  config: any,
+  loop?: number
+) => Promise<AutotuneResult>;
+
+// 保存的调优结果，未调优或不属于当前设备时为undefined
+export const autotune_get: (
+  sanboxPath: string,
+  modelType: string
+) => AutotuneResult | undefined;
+
+export const autotune_clear: (
+  sanboxPath: string,
+  modelType: string
+) => boolean;
+
+// --------------------------------------------[ autotune end ]--------------------------------------------
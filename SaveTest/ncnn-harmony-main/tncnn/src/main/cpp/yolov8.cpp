@@ -1,4 +1,7 @@
 #include "yolov8.h"
+#include "benchmark.h"
+#include "param_graph.h"
+#include "simd_math.h"
 #include <map>
 #include <algorithm>
 #include <cmath>
@@ -48,6 +51,34 @@ static const std::map<int, std::string> SNHA_IMAGE_LABEL = {
     // 根据实际业务需求添加更多映射
 };
 
+const char *label_name(int label, bool use_snha) {
+    if (use_snha) {
+        // 使用SNHA物料编码
+        std::map<int, std::string>::const_iterator it = SNHA_LABEL_DICT.find(label);
+        if (it != SNHA_LABEL_DICT.end()) {
+            return it->second.c_str();
+        }
+    }
+    // 使用COCO标准类别名称
+    std::map<int, std::string>::const_iterator it = COCO_LABELS.find(label);
+    return it != COCO_LABELS.end() ? it->second.c_str() : "unknown";
+}
+
+const char *image_label(int label, bool use_snha) {
+    if (!use_snha || SNHA_LABEL_DICT.find(label) == SNHA_LABEL_DICT.end()) {
+        return "";
+    }
+    std::map<int, std::string>::const_iterator it = SNHA_IMAGE_LABEL.find(label);
+    return it != SNHA_IMAGE_LABEL.end() ? it->second.c_str() : "IMG_UNKNOWN";
+}
+
+bool valid_nv21(int img_w, int img_h, int rotation) {
+    if (rotation != 0 && rotation != 90 && rotation != 180 && rotation != 270) {
+        return false;
+    }
+    return img_w >= 4 && img_h >= 4 && img_w % 2 == 0 && img_h % 2 == 0;
+}
+
 YOLOv8::YOLOv8() {
     target_size = 640;
     num_classes = 80;
@@ -55,18 +86,129 @@ YOLOv8::YOLOv8() {
     conf_threshold = 0.25f;
     nms_threshold = 0.45f;
     output_format = FORMAT_UNKNOWN;
+    output_layout = LAYOUT_ANCHOR_MAJOR;
+    plan.input_blob = -1;
+    plan.output_blob = -1;
+    frame.frame_w = 0;
+    frame.frame_h = 0;
+    frame.even_size = false;
+    frame.stages = netutils::StageTimes();
+    update_logit_threshold();
 }
 
 YOLOv8::~YOLOv8() {
     net.clear();
 }
 
+// 输出Mat按二维矩阵看待时的行数与第r行
+// 2D Mat 及 c=1 的3D Mat按行，[C, 1, N] 形式的3D Mat按通道
+static inline int output_rows(const ncnn::Mat &m) {
+    return (m.dims == 3 && m.c > 1) ? m.c : m.h;
+}
+
+static inline const float *output_row(const ncnn::Mat &m, int r) {
+    return (m.dims == 3 && m.c > 1) ? (const float *)m.channel(r) : m.row(r);
+}
+
+// 去除letterbox填充并还原缩放，裁剪到图像范围后加入结果（x1/y1/x2/y2为网络输入坐标）
+static void append_box(std::vector<BoxInfo> &boxes, float x1, float y1, float x2, float y2, float score,
+                       int label, int img_w, int img_h, const LetterBox &lb) {
+    x1 = (x1 - lb.left_pad) / lb.scale;
+    y1 = (y1 - lb.top_pad) / lb.scale;
+    x2 = (x2 - lb.left_pad) / lb.scale;
+    y2 = (y2 - lb.top_pad) / lb.scale;
+
+    // 裁剪到图像范围
+    x1 = std::max(0.f, std::min(x1, (float)img_w));
+    y1 = std::max(0.f, std::min(y1, (float)img_h));
+    x2 = std::max(0.f, std::min(x2, (float)img_w));
+    y2 = std::max(0.f, std::min(y2, (float)img_h));
+
+    if (x2 > x1 && y2 > y1) {
+        BoxInfo box;
+        box.x1 = x1;
+        box.y1 = y1;
+        box.x2 = x2;
+        box.y2 = y2;
+        box.score = score;
+        box.label = label;
+        boxes.push_back(box);
+    }
+}
+
 inline float YOLOv8::sigmoid(float x) {
     return 1.0f / (1.0f + expf(-x));
 }
 
+void YOLOv8::set_thresholds(float conf, float nms, const std::vector<float> &class_thresholds) {
+    conf_threshold = conf;
+    nms_threshold = nms;
+    this->class_thresholds = class_thresholds;
+    update_logit_threshold();
+}
+
+void YOLOv8::update_logit_threshold() {
+    float min_threshold = conf_threshold;
+    for (float t : class_thresholds) {
+        min_threshold = std::min(min_threshold, t);
+    }
+
+    // sigmoid单调递增：sigmoid(x) >= t 等价于 x >= log(t / (1 - t))
+    // 留出余量抵消expf的舍入误差，被拒绝的anchor在原流程中也一定不会通过
+    if (min_threshold <= 0.f || min_threshold >= 1.f) {
+        logit_threshold = -FLT_MAX;
+    } else {
+        logit_threshold = logf(min_threshold / (1.f - min_threshold)) - 1e-3f;
+    }
+}
+
+inline float YOLOv8::class_threshold(int label) const {
+    if (label < (int)class_thresholds.size()) {
+        return class_thresholds[label];
+    }
+    return conf_threshold;
+}
+
+void YOLOv8::build_anchors() {
+    // YOLOv8输出按 stride 8/16/32 三个尺度依次排列，每个网格一个anchor，中心点位于网格中心
+    const int strides[3] = {8, 16, 32};
+    plan.anchor_centers.clear();
+    plan.anchor_strides.clear();
+    for (int stride : strides) {
+        int grid_w = target_size / stride;
+        int grid_h = target_size / stride;
+        for (int y = 0; y < grid_h; y++) {
+            for (int x = 0; x < grid_w; x++) {
+                plan.anchor_centers.push_back((x + 0.5f) * stride);
+                plan.anchor_centers.push_back((y + 0.5f) * stride);
+                plan.anchor_strides.push_back((float)stride);
+            }
+        }
+    }
+}
+
 int YOLOv8::init(ncnn::Option option, const char *param, const char *model, const char *modeltype) {
+    OH_LOG_DEBUG(LogType::LOG_APP, "load param:%{public}s", param);
+    OH_LOG_DEBUG(LogType::LOG_APP, "load bin:%{public}s", model);
+
+    std::unique_ptr<modelloader::ModelData> data(new modelloader::ModelData());
+    if (!data->load_files(param, model)) {
+        return 0;
+    }
+    return init(option, std::move(data), modeltype);
+}
+
+int YOLOv8::init(ncnn::Option option, std::unique_ptr<modelloader::ModelData> model, const char *modeltype) {
     net.opt = option;
+    // option未指定分配器时使用检测器自有的内存池，预热后blob与workspace不再分配堆内存
+    // 开启mempool时，加载期间转换的权重常驻blob内存池，推理的blob改用按帧重置的arena（在init末尾切换）
+    use_arena = net.opt.use_local_pool_allocator && net.opt.blob_allocator == nullptr;
+    if (net.opt.blob_allocator == nullptr) {
+        net.opt.blob_allocator = &blob_pool_allocator;
+    }
+    if (net.opt.workspace_allocator == nullptr) {
+        net.opt.workspace_allocator = &workspace_pool_allocator;
+    }
 
     // YOLOv8的配置映射
     const std::map<std::string, int> _target_sizes = {
@@ -110,13 +252,21 @@ int YOLOv8::init(ncnn::Option option, const char *param, const char *model, cons
         norm_vals[0] = norm_vals[1] = norm_vals[2] = 1 / 255.f;
     }
 
-    OH_LOG_DEBUG(LogType::LOG_APP, "load param:%{public}s", param);
-    OH_LOG_DEBUG(LogType::LOG_APP, "load bin:%{public}s", model);
+    // anchor表只依赖输入尺寸，初始化时生成一次
+    build_anchors();
+
+    OH_LOG_DEBUG(LogType::LOG_APP, "load param:%{public}zu bytes, bin:%{public}zu bytes", model->param.size(),
+                 model->bin.size());
 
     // 加载模型
+    double init_start = ncnn::get_current_time();
     int pr, mr;
-    pr = net.load_param(param);
-    mr = net.load_model(model);
+    model_data = std::move(model);
+    pr = net.load_param_mem(model_data->param.c_str());
+    double param_end = ncnn::get_current_time();
+    // 权重直接引用映射的内存，返回值为读取的字节数
+    mr = pr == 0 && net.load_model(model_data->bin.data()) > 0 ? 0 : -1;
+    double model_end = ncnn::get_current_time();
 
     if (pr != 0 || mr != 0) {
         OH_LOG_DEBUG(LogType::LOG_APP, "load param:%{public}d, load model:%{public}d", pr, mr);
@@ -125,208 +275,487 @@ int YOLOv8::init(ncnn::Option option, const char *param, const char *model, cons
 
     OH_LOG_DEBUG(LogType::LOG_APP, "load success");
 
-    // 自动检测输出格式
-    output_format = detect_output_format();
-    OH_LOG_DEBUG(LogType::LOG_APP, "detected output format:%{public}d", output_format);
-
+    // 解析输入输出blob，找不到常见名称时使用网络声明的第一个输入/输出
+    static const char *input_candidates[] = {"images", "data", "input", "input.1"};
+    static const char *output_candidates[] = {"output0", "output", "out"};
+    plan.input_blob = netutils::resolve_blob_index(net, input_candidates, 4, net.input_indexes());
+    plan.output_blob = netutils::resolve_blob_index(net, output_candidates, 3, net.output_indexes());
+    if (plan.input_blob < 0 || plan.output_blob < 0) {
+        OH_LOG_DEBUG(LogType::LOG_APP, "resolve blob failed, input:%{public}d output:%{public}d", plan.input_blob,
+                     plan.output_blob);
+        return 0;
+    }
+    OH_LOG_DEBUG(LogType::LOG_APP, "input blob:%{public}s, output blob:%{public}s",
+                 net.blobs()[plan.input_blob].name.c_str(), net.blobs()[plan.output_blob].name.c_str());
+
+    // 确定输出格式：优先使用描述文件，其次解析.param图结构，最后才用虚拟输入推理
+    const char *format_source = "meta";
+    bool format_ok = load_output_meta(model_data->meta);
+    if (!format_ok) {
+        format_source = "param";
+        format_ok = infer_output_from_param(model_data->param);
+    }
+    if (!format_ok) {
+        format_source = "forward";
+        format_ok = detect_output_format();
+    }
+    double format_end = ncnn::get_current_time();
+    if (!format_ok) {
+        OH_LOG_DEBUG(LogType::LOG_APP, "unknown output format");
+        return 0;
+    }
+    // 描述文件与图结构只给出格式，.param带形状提示时在此校验，否则首帧推理后由postprocess校验
+    const ncnn::Mat &shape_hint = net.blobs()[plan.output_blob].shape;
+    if (shape_hint.dims != 0 && !output_shape_ok(shape_hint)) {
+        OH_LOG_DEBUG(LogType::LOG_APP,
+                     "output shape %{public}d x %{public}d x %{public}d does not match %{public}s format",
+                     shape_hint.w, shape_hint.h, shape_hint.c, format_source);
+        return 0;
+    }
+    init_frame(frame);
+
+    OH_LOG_DEBUG(LogType::LOG_APP,
+                 "output format:%{public}d layout:%{public}d reg_max:%{public}d classes:%{public}d from %{public}s",
+                 output_format, output_layout, reg_max, num_classes, format_source);
+    OH_LOG_DEBUG(LogType::LOG_APP,
+                 "init load_param:%{public}.2f ms, load_model:%{public}.2f ms, output format:%{public}.2f ms, "
+                 "total:%{public}.2f ms",
+                 param_end - init_start, model_end - param_end, format_end - model_end, format_end - init_start);
+
+    // 之后extractor创建的blob都来自arena，每帧开始时整块回收
+    if (use_arena) {
+        net.opt.blob_allocator = &blob_arena;
+    }
     return 1;
 }
 
-YOLOv8::OutputFormat YOLOv8::detect_output_format() {
-    // 创建一个虚拟输入来检测输出格式
-    ncnn::Mat dummy_input = ncnn::Mat::from_pixels_resize(
-        nullptr, ncnn::Mat::PIXEL_RGB, target_size, target_size, target_size, target_size);
-    dummy_input.fill(0.5f);
-    dummy_input.substract_mean_normalize(mean_vals, norm_vals);
-
-    ncnn::Extractor ex = net.create_extractor();
-    
-    // 尝试常见的输入层名称
-    const char* input_names[] = {"images", "data", "input", "input.1"};
-    bool input_set = false;
-    for (const char* name : input_names) {
-        if (net.find_blob_index(name) >= 0) {
-            ex.input(name, dummy_input);
-            input_set = true;
-            OH_LOG_DEBUG(LogType::LOG_APP, "using input layer: %{public}s", name);
-            break;
+bool YOLOv8::load_output_meta(const std::string &meta) {
+    if (meta.empty()) {
+        return false;
+    }
+    std::istringstream file(meta);
+
+    OutputFormat format = FORMAT_UNKNOWN;
+    OutputLayout layout = LAYOUT_CHANNEL_MAJOR;
+    int meta_reg_max = reg_max;
+    int meta_num_classes = num_classes;
+    std::string line;
+    while (std::getline(file, line)) {
+        size_t eq = line.find('=');
+        if (line.empty() || line[0] == '#' || eq == std::string::npos) {
+            continue;
+        }
+        std::string key = line.substr(0, eq);
+        std::string value = line.substr(eq + 1);
+        if (key == "format") {
+            format = value == "dfl" ? FORMAT_DFL : (value == "direct" ? FORMAT_DIRECT_COORDS : FORMAT_UNKNOWN);
+        } else if (key == "layout") {
+            layout = value == "anchor" ? LAYOUT_ANCHOR_MAJOR : LAYOUT_CHANNEL_MAJOR;
+        } else if (key == "reg_max") {
+            meta_reg_max = atoi(value.c_str());
+        } else if (key == "num_classes") {
+            meta_num_classes = atoi(value.c_str());
         }
     }
-    
-    if (!input_set) {
-        OH_LOG_DEBUG(LogType::LOG_APP, "warning: using default input");
-        ex.input("images", dummy_input);
+
+    if (format == FORMAT_UNKNOWN || meta_reg_max <= 0 || meta_num_classes <= 0) {
+        OH_LOG_DEBUG(LogType::LOG_APP, "invalid output meta");
+        return false;
     }
+    output_format = format;
+    output_layout = layout;
+    reg_max = meta_reg_max;
+    num_classes = meta_num_classes;
+    return true;
+}
 
-    // 尝试常见的输出层名称
-    ncnn::Mat output;
-    const char* output_names[] = {"output0", "output", "out"};
-    bool output_extracted = false;
-    for (const char* name : output_names) {
-        if (net.find_blob_index(name) >= 0) {
-            ex.extract(name, output);
-            output_extracted = true;
-            OH_LOG_DEBUG(LogType::LOG_APP, "using output layer: %{public}s", name);
-            break;
+bool YOLOv8::infer_output_from_param(const std::string &param) {
+    std::vector<paramgraph::LayerInfo> layers;
+    if (!paramgraph::parse(param, layers)) {
+        return false;
+    }
+    std::map<std::string, const paramgraph::LayerInfo *> producers = paramgraph::producers(layers);
+
+    // 检测头：torch.cat((cv2(x), cv3(x)), 1)，box分支在前，cls分支在后
+    int box_channels = 0;
+    int cls_channels = 0;
+    bool has_softmax = false;
+    for (const paramgraph::LayerInfo &layer : layers) {
+        if (layer.type == "Softmax") {
+            has_softmax = true;
+        }
+        if (box_channels != 0 || layer.type != "Concat" || layer.bottoms.size() != 2) {
+            continue;
         }
+        auto box = producers.find(layer.bottoms[0]);
+        auto cls = producers.find(layer.bottoms[1]);
+        if (box == producers.end() || cls == producers.end() || box->second->type != "Convolution" ||
+            cls->second->type != "Convolution") {
+            continue;
+        }
+        box_channels = paramgraph::int_param(*box->second, 0, 0);
+        cls_channels = paramgraph::int_param(*cls->second, 0, 0);
+    }
+    if (box_channels <= 0 || cls_channels <= 0 || box_channels % 4 != 0) {
+        return false;
     }
-    
-    if (!output_extracted) {
-        OH_LOG_DEBUG(LogType::LOG_APP, "warning: using default output");
-        ex.extract("output0", output);
+
+    auto output = producers.find(net.blobs()[plan.output_blob].name);
+    bool permuted = output != producers.end() && output->second->type == "Permute";
+
+    output_format = has_softmax ? FORMAT_DIRECT_COORDS : FORMAT_DFL;
+    output_layout = permuted ? LAYOUT_ANCHOR_MAJOR : LAYOUT_CHANNEL_MAJOR;
+    reg_max = box_channels / 4;
+    num_classes = cls_channels;
+    return true;
+}
+
+bool YOLOv8::detect_output_format() {
+    // 用中灰色的虚拟输入推理一次来检测输出格式
+    ncnn::Mat input(target_size, target_size, 3);
+    preprocess::fill_normalized(input, 127.f, mean_vals, norm_vals);
+
+    ncnn::Extractor ex = net.create_extractor();
+    ex.input(plan.input_blob, input);
+
+    ncnn::Mat output;
+    if (ex.extract(plan.output_blob, output) != 0 || output.empty()) {
+        return false;
     }
 
-    // 检测输出格式
-    // YOLOv8输出通常是 [1, 84, 8400] 或 [1, 4+num_classes, num_anchors]
-    // 84 = 4*16(DFL) + 80(classes) 或 4 + 80 = 84
-    int channels = output.c;
-    int height = output.h;
-    int width = output.w;
+    // 检测输出格式与布局
+    // YOLOv8输出通常是 [84, 8400]（通道优先，ncnn标准导出）或 [8400, 84]（anchor优先）
+    // 84 = 4 + 80(classes)，DFL格式为 4*reg_max + 80
+    // anchor数远大于特征维度，以较短的一维作为特征维度
+    int rows = output_rows(output);
+    int cols = output.w;
 
-    OH_LOG_DEBUG(LogType::LOG_APP, "output shape: %{public}d x %{public}d x %{public}d", width, height, channels);
+    OH_LOG_DEBUG(LogType::LOG_APP, "output shape: %{public}d x %{public}d x %{public}d, dims:%{public}d",
+                 output.w, output.h, output.c, output.dims);
+
+    int features;
+    if (rows < cols) {
+        output_layout = LAYOUT_CHANNEL_MAJOR;
+        features = rows;
+    } else {
+        output_layout = LAYOUT_ANCHOR_MAJOR;
+        features = cols;
+    }
+    OH_LOG_DEBUG(LogType::LOG_APP, "output layout:%{public}d, features:%{public}d", output_layout, features);
 
     // 判断格式
-    if (channels == 4 + num_classes) {
+    if (features == 4 + num_classes) {
         // 直接坐标格式: [x, y, w, h, class_scores...]
-        return FORMAT_DIRECT_COORDS;
-    } else if (channels >= 64 + num_classes) {
+        output_format = FORMAT_DIRECT_COORDS;
+    } else if (features >= 64 + num_classes && (features - num_classes) % 4 == 0) {
         // DFL格式: [distance_distribution(16*4=64), class_scores...]
-        reg_max = (channels - num_classes) / 4;
-        OH_LOG_DEBUG(LogType::LOG_APP, "DFL format detected, reg_max:%{public}d", reg_max);
-        return FORMAT_DFL;
+        reg_max = (features - num_classes) / 4;
+        output_format = FORMAT_DFL;
     } else {
         // 可能是其他格式，尝试直接坐标
         OH_LOG_DEBUG(LogType::LOG_APP, "unknown format, using direct coords");
-        return FORMAT_DIRECT_COORDS;
+        output_format = FORMAT_DIRECT_COORDS;
     }
+    // 特征维少于4+类别数时无法按直接坐标解码
+    if (!output_shape_ok(output)) {
+        OH_LOG_DEBUG(LogType::LOG_APP, "features:%{public}d too few for %{public}d classes", features, num_classes);
+        return false;
+    }
+    return true;
 }
 
-std::vector<BoxInfo> YOLOv8::run(ncnn::Mat &data, int img_w, int img_h, const char *modeltype,
-                                 const char *user_id, const char *uuid, const char *time_sent) {
-    // Letterbox预处理
-    float scale = std::min((float)target_size / img_w, (float)target_size / img_h);
-    int w = (int)(img_w * scale);
-    int h = (int)(img_h * scale);
-    
-    // 计算padding
-    int wpad = target_size - w;
-    int hpad = target_size - h;
-    int left_pad = wpad / 2;
-    int top_pad = hpad / 2;
+bool YOLOv8::output_shape_ok(const ncnn::Mat &output) const {
+    int required = (output_format == FORMAT_DFL ? 4 * reg_max : 4) + num_classes;
+    int features = output_layout == LAYOUT_CHANNEL_MAJOR ? output_rows(output) : output.w;
+    return features >= required;
+}
 
-    // 缩放图像
-    ncnn::Mat resize_input = ncnn::Mat::from_pixels_resize(
-        data, ncnn::Mat::PIXEL_RGBA2RGB, img_w, img_h, w, h);
+const LetterBox &YOLOv8::update_plan(FrameState &state, int img_w, int img_h, bool even) {
+    if (state.frame_w == img_w && state.frame_h == img_h && state.even_size == even) {
+        return state.lb;
+    }
 
-    // Padding
-    ncnn::Mat in_pad;
-    ncnn::copy_make_border(resize_input, in_pad, top_pad, hpad - top_pad, 
-                          left_pad, wpad - left_pad, ncnn::BORDER_CONSTANT, 0.f);
+    LetterBox lb;
+    lb.scale = std::min((float)target_size / img_w, (float)target_size / img_h);
+    lb.w = (int)(img_w * lb.scale);
+    lb.h = (int)(img_h * lb.scale);
+    if (even) {
+        lb.w = std::max(lb.w & ~1, 2);
+        lb.h = std::max(lb.h & ~1, 2);
+    }
+    lb.left_pad = (target_size - lb.w) / 2;
+    lb.top_pad = (target_size - lb.h) / 2;
+
+    bool same_geometry = state.frame_w != 0 && state.lb.w == lb.w && state.lb.h == lb.h &&
+                         state.lb.left_pad == lb.left_pad && state.lb.top_pad == lb.top_pad;
+    if (!same_geometry) {
+        // 填充值0归一化后写满整个输入，之后每帧只覆盖有效区域
+        preprocess::fill_normalized(state.input, 0.f, mean_vals, norm_vals);
+    }
 
-    // 归一化
-    in_pad.substract_mean_normalize(mean_vals, norm_vals);
+    state.frame_w = img_w;
+    state.frame_h = img_h;
+    state.even_size = even;
+    state.lb = lb;
+    OH_LOG_DEBUG(LogType::LOG_APP, "plan rebuilt for %{public}d x %{public}d, scaled:%{public}d x %{public}d", img_w,
+                 img_h, lb.w, lb.h);
+    return state.lb;
+}
 
-    // 推理
-    ncnn::Extractor ex = net.create_extractor();
-    
-    // 设置输入
-    const char* input_names[] = {"images", "data", "input", "input.1"};
-    bool input_set = false;
-    for (const char* name : input_names) {
-        if (net.find_blob_index(name) >= 0) {
-            ex.input(name, in_pad);
-            input_set = true;
-            break;
-        }
+void YOLOv8::init_frame(FrameState &state) const {
+    // 常驻输入，首帧时按letterbox预填充
+    state.input.create(target_size, target_size, 3);
+    state.output.release();
+    state.frame_w = 0;
+    state.frame_h = 0;
+    state.even_size = false;
+    state.stages = netutils::StageTimes();
+    state.boxes.clear();
+    if (output_format == FORMAT_DFL) {
+        state.dfl_gather.resize(reg_max);
     }
-    if (!input_set) {
-        ex.input("images", in_pad);
+}
+
+const std::vector<BoxInfo> &YOLOv8::run(ncnn::Mat &data, int img_w, int img_h, const char *modeltype) {
+    if (!preprocess(frame, (const unsigned char *)data.data, img_w, img_h)) {
+        frame.boxes.clear();
+        return frame.boxes;
     }
+    forward(frame, 0, false);
+    return postprocess(frame);
+}
 
-    // 获取输出
-    ncnn::Mat output;
-    const char* output_names[] = {"output0", "output", "out"};
-    bool output_extracted = false;
-    for (const char* name : output_names) {
-        if (net.find_blob_index(name) >= 0) {
-            ex.extract(name, output);
-            output_extracted = true;
-            break;
-        }
+const std::vector<BoxInfo> &YOLOv8::run_nv21(const unsigned char *nv21, int img_w, int img_h, int stride,
+                                             int rotation, const char *modeltype) {
+    if (!preprocess_nv21(frame, nv21, img_w, img_h, stride, rotation)) {
+        frame.boxes.clear();
+        return frame.boxes;
+    }
+    forward(frame, 0, false);
+    return postprocess(frame);
+}
+
+bool YOLOv8::preprocess(FrameState &state, const unsigned char *rgba, int img_w, int img_h) {
+    if (state.input.empty()) {
+        return false;
+    }
+
+    // Letterbox预处理：RGBA取通道、缩放、归一化一次完成，直接写入常驻输入的有效区域
+    double start = ncnn::get_current_time();
+    const LetterBox &lb = update_plan(state, img_w, img_h, false);
+    state.resizer.prepare(img_w, img_h, 4, lb.w, lb.h);
+    state.resizer.run(rgba, img_w * 4, state.input, lb.left_pad, lb.top_pad, mean_vals, norm_vals);
+    state.stages.convert = 0;
+    state.stages.resize = ncnn::get_current_time() - start;
+    state.stages.normalize = 0;
+    return true;
+}
+
+bool YOLOv8::preprocess_nv21(FrameState &state, const unsigned char *nv21, int img_w, int img_h, int stride,
+                             int rotation) {
+    if (state.input.empty()) {
+        return false;
+    }
+    if (!valid_nv21(img_w, img_h, rotation)) {
+        OH_LOG_DEBUG(LogType::LOG_APP, "invalid nv21 frame %{public}dx%{public}d rotation:%{public}d", img_w, img_h,
+                     rotation);
+        return false;
+    }
+
+    // kanna_rotate的type表示源图方向，6/3/8分别对应顺时针旋转90/180/270
+    int rotate_type = 0;
+    if (rotation == 90) {
+        rotate_type = 6;
+    } else if (rotation == 180) {
+        rotate_type = 3;
+    } else if (rotation == 270) {
+        rotate_type = 8;
+    }
+    bool swap_wh = (rotate_type == 6 || rotate_type == 8);
+
+    // 旋转后的图像尺寸
+    int rot_w = swap_wh ? img_h : img_w;
+    int rot_h = swap_wh ? img_w : img_h;
+
+    // Letterbox预处理，yuv420sp要求宽高为偶数
+    double start = ncnn::get_current_time();
+    const LetterBox &lb = update_plan(state, rot_w, rot_h, true);
+
+    // 先在原始方向上缩放，整帧数据只读取一次，后续旋转与颜色转换都在缩放后的小图上进行
+    int resized_w = swap_wh ? lb.h : lb.w;
+    int resized_h = swap_wh ? lb.w : lb.h;
+    size_t yuv_size = (size_t)lb.w * lb.h * 3 / 2;
+    state.nv21_resized.resize(yuv_size);
+    unsigned char *y_dst = state.nv21_resized.data();
+    unsigned char *uv_dst = y_dst + resized_w * resized_h;
+    ncnn::resize_bilinear_c1(nv21, img_w, img_h, stride, y_dst, resized_w, resized_h, resized_w);
+    ncnn::resize_bilinear_c2(nv21 + (size_t)stride * img_h, img_w / 2, img_h / 2, stride, uv_dst, resized_w / 2,
+                             resized_h / 2, resized_w);
+    double resize_end = ncnn::get_current_time();
+
+    // 旋转
+    const unsigned char *yuv = state.nv21_resized.data();
+    if (rotate_type != 0) {
+        state.nv21_rotated.resize(yuv_size);
+        ncnn::kanna_rotate_yuv420sp(state.nv21_resized.data(), resized_w, resized_h, state.nv21_rotated.data(), lb.w,
+                                    lb.h, rotate_type);
+        yuv = state.nv21_rotated.data();
+    }
+
+    // YUV转RGB
+    state.rgb_buffer.resize((size_t)lb.w * lb.h * 3);
+    ncnn::yuv420sp2rgb(yuv, lb.w, lb.h, state.rgb_buffer.data());
+    double convert_end = ncnn::get_current_time();
+
+    // 尺寸已一致，只做归一化并写入常驻输入的有效区域
+    state.resizer.prepare(lb.w, lb.h, 3, lb.w, lb.h);
+    state.resizer.run(state.rgb_buffer.data(), lb.w * 3, state.input, lb.left_pad, lb.top_pad, mean_vals,
+                      norm_vals);
+    state.stages.resize = resize_end - start;
+    state.stages.convert = convert_end - resize_end;
+    state.stages.normalize = ncnn::get_current_time() - convert_end;
+    return true;
+}
+
+void YOLOv8::forward(FrameState &state, int num_threads, bool detach_output) {
+    double forward_start = ncnn::get_current_time();
+
+    // 上一帧的extractor已析构，释放保留的输出后回收arena（分离的输出不占用arena）
+    if (!detach_output) {
+        state.output.release();
     }
-    if (!output_extracted) {
-        ex.extract("output0", output);
+    if (use_arena) {
+        blob_arena.reset();
     }
 
-    // 计算缩放比例（用于坐标转换）
-    float scale_x = (float)img_w / target_size;
-    float scale_y = (float)img_h / target_size;
+    ncnn::Extractor ex = net.create_extractor();
+    if (num_threads > 0) {
+        ex.set_num_threads(num_threads);
+    }
+    ex.input(plan.input_blob, state.input);
+    if (detach_output) {
+        // 分配器（arena或无锁内存池）只能在推理线程使用，输出拷贝到默认分配器后交给后处理线程
+        ncnn::Mat output;
+        ex.extract(plan.output_blob, output);
+        state.output = net.opt.blob_allocator != nullptr ? output.clone() : output;
+    } else {
+        ex.extract(plan.output_blob, state.output);
+    }
+    state.stages.forward = ncnn::get_current_time() - forward_start;
+}
+
+void YOLOv8::forward_concurrent(FrameState &state, int num_threads, ncnn::Allocator *blob_allocator,
+                                ncnn::Allocator *workspace_allocator) {
+    double forward_start = ncnn::get_current_time();
+
+    // 上一帧的输出来自同一blob_allocator，先释放以便复用
+    state.output.release();
+    ncnn::Extractor ex = net.create_extractor();
+    if (num_threads > 0) {
+        ex.set_num_threads(num_threads);
+    }
+    ex.set_blob_allocator(blob_allocator);
+    ex.set_workspace_allocator(workspace_allocator);
+    ex.input(plan.input_blob, state.input);
+    ex.extract(plan.output_blob, state.output);
+    state.stages.forward = ncnn::get_current_time() - forward_start;
+}
+
+const std::vector<BoxInfo> &YOLOv8::postprocess(FrameState &state) {
+    const LetterBox &lb = state.lb;
+    ncnn::Mat &output = state.output;
 
     // 根据格式解码
-    std::vector<BoxInfo> boxes;
+    double decode_start = ncnn::get_current_time();
+    state.boxes.clear();
+    if (output.empty()) {
+        state.stages.decode = 0;
+        state.stages.nms = 0;
+        return state.boxes;
+    }
+    // 解码按 class_offset + num_classes 读取特征维，形状不符（如描述文件中的类别数有误）时跳过该帧
+    if (!output_shape_ok(output)) {
+        OH_LOG_DEBUG(LogType::LOG_APP, "output shape %{public}d x %{public}d x %{public}d does not match format",
+                     output.w, output.h, output.c);
+        state.stages.decode = 0;
+        state.stages.nms = 0;
+        return state.boxes;
+    }
     if (output_format == FORMAT_DIRECT_COORDS) {
-        boxes = decode_direct_coords(output, img_w, img_h, scale_x, scale_y);
+        decode_direct_coords(state, output, state.frame_w, state.frame_h, lb);
     } else if (output_format == FORMAT_DFL) {
-        boxes = decode_dfl(output, img_w, img_h, scale_x, scale_y);
+        decode_dfl(state, output, state.frame_w, state.frame_h, lb);
     }
+    double nms_start = ncnn::get_current_time();
 
     // NMS
-    nms(boxes, nms_threshold);
-
-    // 判断是否使用SNHA标签映射
-    bool use_snha = (user_id != nullptr && std::string(user_id) == "SNHA");
-    
-    // 为每个检测结果添加增强信息
-    for (auto &box : boxes) {
-        // 计算中心点坐标
-        box.x_center = (box.x1 + box.x2) / 2.0f;
-        box.y_center = (box.y1 + box.y2) / 2.0f;
-        
-        // 设置标签名称
-        if (use_snha && SNHA_LABEL_DICT.find(box.label) != SNHA_LABEL_DICT.end()) {
-            // 使用SNHA物料编码
-            box.label_name = SNHA_LABEL_DICT.at(box.label);
-            
-            // 设置图像级标签
-            if (SNHA_IMAGE_LABEL.find(box.label) != SNHA_IMAGE_LABEL.end()) {
-                box.imglabel = SNHA_IMAGE_LABEL.at(box.label);
-            } else {
-                box.imglabel = "IMG_UNKNOWN";
+    nms(state, nms_threshold);
+
+    state.stages.decode = nms_start - decode_start;
+    state.stages.nms = ncnn::get_current_time() - nms_start;
+    return state.boxes;
+}
+
+void YOLOv8::scan_channel_major(FrameState &state, const ncnn::Mat &output, int class_offset, int num_anchors) {
+    // 调用前postprocess已确认输出至少有 class_offset + num_classes 行
+    // 块内的最大logit与类别常驻L1，每个类别平面按块连续读取
+    const int TILE = 256;
+    float tile_max[TILE];
+    int tile_label[TILE];
+
+    state.candidates.clear();
+    for (int a0 = 0; a0 < num_anchors; a0 += TILE) {
+        int n = std::min(TILE, num_anchors - a0);
+
+        std::copy(output_row(output, class_offset) + a0, output_row(output, class_offset) + a0 + n, tile_max);
+        std::fill(tile_label, tile_label + n, 0);
+        for (int j = 1; j < num_classes; j++) {
+            simd::argmax_update(output_row(output, class_offset + j) + a0, tile_max, tile_label, n, j);
+        }
+
+        for (int k = 0; k < n; k++) {
+            // 在logit空间提前拒绝，sigmoid单调，最大logit即对应最大分数
+            if (tile_max[k] < logit_threshold) {
+                continue;
             }
-        } else {
-            // 使用COCO标准类别名称
-            if (COCO_LABELS.find(box.label) != COCO_LABELS.end()) {
-                box.label_name = COCO_LABELS.at(box.label);
-            } else {
-                box.label_name = "unknown";
+            float score = sigmoid(tile_max[k]);
+            if (score < class_threshold(tile_label[k])) {
+                continue;
             }
-            box.imglabel = "";
+            Candidate c;
+            c.anchor = a0 + k;
+            c.label = tile_label[k];
+            c.score = score;
+            state.candidates.push_back(c);
         }
-        
-        // 设置透传数据
-        box.uuid = (uuid != nullptr) ? std::string(uuid) : "";
-        box.time_sent = (time_sent != nullptr) ? std::string(time_sent) : "";
     }
-
-    return boxes;
 }
 
-std::vector<BoxInfo> YOLOv8::decode_direct_coords(ncnn::Mat &output, int img_w, int img_h, 
-                                                   float scale_x, float scale_y) {
-    std::vector<BoxInfo> boxes;
-    
+void YOLOv8::decode_direct_coords(FrameState &state, ncnn::Mat &output, int img_w, int img_h, const LetterBox &lb) {
     // YOLOv8输出格式: [x_center, y_center, width, height, class_scores...]
-    // 输出shape通常是 [1, 84, 8400] 或 [8400, 84]
-    int num_detections = output.h > 1 ? output.h : output.w;
-    int channels = output.c;
+    if (output_layout == LAYOUT_CHANNEL_MAJOR) {
+        // [84, 8400]: 先扫描类别平面，只为通过阈值的anchor读取坐标
+        scan_channel_major(state, output, 4, output.w);
+
+        const float *xs = output_row(output, 0);
+        const float *ys = output_row(output, 1);
+        const float *ws = output_row(output, 2);
+        const float *hs = output_row(output, 3);
+        for (const Candidate &c : state.candidates) {
+            float x_center = xs[c.anchor];
+            float y_center = ys[c.anchor];
+            float width = ws[c.anchor];
+            float height = hs[c.anchor];
+            append_box(state.boxes, x_center - width / 2, y_center - height / 2, x_center + width / 2,
+                       y_center + height / 2, c.score, c.label, img_w, img_h, lb);
+        }
+        return;
+    }
 
+    // [8400, 84]: 每个anchor一行
+    int num_detections = output_rows(output);
     for (int i = 0; i < num_detections; i++) {
-        const float* ptr = output.channel(0).row(i);
-        if (output.dims == 3 && output.h > 1) {
-            ptr = output.channel(0).row(i);
-        } else if (output.dims == 2) {
-            ptr = output.row(i);
-        }
+        const float* ptr = output_row(output, i);
 
         // 获取坐标（相对于输入尺寸640x640）
         float x_center = ptr[0];
@@ -334,6 +763,11 @@ std::vector<BoxInfo> YOLOv8::decode_direct_coords(ncnn::Mat &output, int img_w,
         float width = ptr[2];
         float height = ptr[3];
 
+        // 在logit空间提前拒绝，绝大多数anchor无需计算sigmoid
+        if (simd::max_reduce(ptr + 4, num_classes) < logit_threshold) {
+            continue;
+        }
+
         // 找到最大类别分数
         float max_score = 0;
         int max_class = 0;
@@ -346,70 +780,59 @@ std::vector<BoxInfo> YOLOv8::decode_direct_coords(ncnn::Mat &output, int img_w,
         }
 
         // 过滤低置信度
-        if (max_score < conf_threshold) {
+        if (max_score < class_threshold(max_class)) {
             continue;
         }
 
-        // 转换为边界框坐标
-        float x1 = (x_center - width / 2) * scale_x;
-        float y1 = (y_center - height / 2) * scale_y;
-        float x2 = (x_center + width / 2) * scale_x;
-        float y2 = (y_center + height / 2) * scale_y;
-
-        // 裁剪到图像范围
-        x1 = std::max(0.f, std::min(x1, (float)img_w));
-        y1 = std::max(0.f, std::min(y1, (float)img_h));
-        x2 = std::max(0.f, std::min(x2, (float)img_w));
-        y2 = std::max(0.f, std::min(y2, (float)img_h));
-
-        if (x2 > x1 && y2 > y1) {
-            boxes.push_back(BoxInfo{x1, y1, x2, y2, max_score, max_class});
-        }
+        append_box(state.boxes, x_center - width / 2, y_center - height / 2, x_center + width / 2,
+                   y_center + height / 2, max_score, max_class, img_w, img_h, lb);
     }
 
-    return boxes;
 }
 
-std::vector<BoxInfo> YOLOv8::decode_dfl(ncnn::Mat &output, int img_w, int img_h, 
-                                        float scale_x, float scale_y) {
-    std::vector<BoxInfo> boxes;
-    
+void YOLOv8::decode_dfl(FrameState &state, ncnn::Mat &output, int img_w, int img_h, const LetterBox &lb) {
     // DFL格式: [distance_distribution(reg_max*4), class_scores...]
-    int num_detections = output.h > 1 ? output.h : output.w;
-    
-    for (int i = 0; i < num_detections; i++) {
-        const float* ptr = output.channel(0).row(i);
-        if (output.dims == 2) {
-            ptr = output.row(i);
-        }
+    int num_detections = output_layout == LAYOUT_CHANNEL_MAJOR ? output.w : output_rows(output);
+    int num_anchors = (int)plan.anchor_strides.size();
+    if (num_detections != num_anchors) {
+        OH_LOG_DEBUG(LogType::LOG_APP, "DFL anchors mismatch: %{public}d vs %{public}d", num_detections, num_anchors);
+        return;
+    }
 
-        // 解码DFL距离
-        float distances[4];
-        for (int d = 0; d < 4; d++) {
-            float sum = 0;
-            float max_val = -FLT_MAX;
-            
-            // 找到最大值（用于数值稳定性）
-            for (int j = 0; j < reg_max; j++) {
-                max_val = std::max(max_val, ptr[d * reg_max + j]);
-            }
-            
-            // Softmax并计算期望
-            float exp_sum = 0;
-            float weighted_sum = 0;
-            for (int j = 0; j < reg_max; j++) {
-                float exp_val = expf(ptr[d * reg_max + j] - max_val);
-                exp_sum += exp_val;
-                weighted_sum += j * exp_val;
+    int class_offset = reg_max * 4;
+    if (output_layout == LAYOUT_CHANNEL_MAJOR) {
+        // [4*reg_max+80, 8400]: 先扫描类别平面，只为通过阈值的anchor收集分布
+        scan_channel_major(state, output, class_offset, num_detections);
+
+        for (const Candidate &c : state.candidates) {
+            float distances[4];
+            for (int d = 0; d < 4; d++) {
+                for (int k = 0; k < reg_max; k++) {
+                    state.dfl_gather[k] = output_row(output, d * reg_max + k)[c.anchor];
+                }
+                distances[d] = simd::softmax_expectation(state.dfl_gather.data(), reg_max);
             }
-            
-            distances[d] = weighted_sum / exp_sum;
+
+            float cx = plan.anchor_centers[c.anchor * 2];
+            float cy = plan.anchor_centers[c.anchor * 2 + 1];
+            float stride = plan.anchor_strides[c.anchor];
+            append_box(state.boxes, cx - distances[0] * stride, cy - distances[1] * stride, cx + distances[2] * stride,
+                       cy + distances[3] * stride, c.score, c.label, img_w, img_h, lb);
         }
+        return;
+    }
 
-        // 获取类别分数
+    for (int i = 0; i < num_detections; i++) {
+        const float* ptr = output_row(output, i);
+
+        // 在logit空间提前拒绝，绝大多数anchor无需计算sigmoid
+        if (simd::max_reduce(ptr + class_offset, num_classes) < logit_threshold) {
+            continue;
+        }
+
+        // 先筛选类别分数，只有通过阈值的anchor才解码边界框
         float max_score = 0;
         int max_class = 0;
-        int class_offset = reg_max * 4;
         for (int j = 0; j < num_classes; j++) {
             float score = sigmoid(ptr[class_offset + j]);
             if (score > max_score) {
@@ -419,92 +842,51 @@ std::vector<BoxInfo> YOLOv8::decode_dfl(ncnn::Mat &output, int img_w, int img_h,
         }
 
         // 过滤低置信度
-        if (max_score < conf_threshold) {
+        if (max_score < class_threshold(max_class)) {
             continue;
         }
 
-        // 计算边界框（这里需要知道anchor位置，简化处理）
-        // 注意：实际DFL解码需要结合anchor grid
-        // 这里提供简化版本
-        float x1 = distances[0] * scale_x;
-        float y1 = distances[1] * scale_y;
-        float x2 = distances[2] * scale_x;
-        float y2 = distances[3] * scale_y;
-
-        // 裁剪
-        x1 = std::max(0.f, std::min(x1, (float)img_w));
-        y1 = std::max(0.f, std::min(y1, (float)img_h));
-        x2 = std::max(0.f, std::min(x2, (float)img_w));
-        y2 = std::max(0.f, std::min(y2, (float)img_h));
-
-        if (x2 > x1 && y2 > y1) {
-            BoxInfo box;
-            box.x1 = x1;
-            box.y1 = y1;
-            box.x2 = x2;
-            box.y2 = y2;
-            box.x_center = 0;  // 将在run函数中计算
-            box.y_center = 0;
-            box.score = max_score;
-            box.label = max_class;
-            box.label_name = "";  // 将在run函数中设置
-            box.uuid = "";
-            box.time_sent = "";
-            box.imglabel = "";
-            boxes.push_back(box);
+        // 解码DFL距离（ltrb，单位为步长）
+        float distances[4];
+        for (int d = 0; d < 4; d++) {
+            distances[d] = simd::softmax_expectation(ptr + d * reg_max, reg_max);
         }
+
+        // 结合anchor中心点与步长得到输入图像上的坐标，再去除letterbox
+        float cx = plan.anchor_centers[i * 2];
+        float cy = plan.anchor_centers[i * 2 + 1];
+        float stride = plan.anchor_strides[i];
+        append_box(state.boxes, cx - distances[0] * stride, cy - distances[1] * stride, cx + distances[2] * stride,
+                   cy + distances[3] * stride, max_score, max_class, img_w, img_h, lb);
     }
 
-    return boxes;
 }
 
-void YOLOv8::nms(std::vector<BoxInfo> &boxes, float nms_threshold) {
+void YOLOv8::nms(FrameState &state, float nms_threshold) {
+    std::vector<BoxInfo> &boxes = state.boxes;
     if (boxes.empty()) {
         return;
     }
 
-    // 按分数排序
-    std::sort(boxes.begin(), boxes.end(), 
-              [](const BoxInfo &a, const BoxInfo &b) { return a.score > b.score; });
-
-    std::vector<BoxInfo> keep;
-    std::vector<bool> suppressed(boxes.size(), false);
-
-    for (size_t i = 0; i < boxes.size(); i++) {
-        if (suppressed[i]) {
-            continue;
-        }
-
-        keep.push_back(boxes[i]);
-
-        float area_i = (boxes[i].x2 - boxes[i].x1) * (boxes[i].y2 - boxes[i].y1);
-
-        for (size_t j = i + 1; j < boxes.size(); j++) {
-            if (suppressed[j] || boxes[i].label != boxes[j].label) {
-                continue;
-            }
-
-            // 计算IoU
-            float x1 = std::max(boxes[i].x1, boxes[j].x1);
-            float y1 = std::max(boxes[i].y1, boxes[j].y1);
-            float x2 = std::min(boxes[i].x2, boxes[j].x2);
-            float y2 = std::min(boxes[i].y2, boxes[j].y2);
-
-            float w = std::max(0.f, x2 - x1);
-            float h = std::max(0.f, y2 - y1);
-            float inter = w * h;
+    nms::NmsSolver &nms_solver = state.nms_solver;
+    nms_solver.clear();
+    nms_solver.reserve((int)boxes.size());
+    for (const BoxInfo &box : boxes) {
+        nms_solver.add(box.x1, box.y1, box.x2, box.y2, box.score, box.label);
+    }
 
-            float area_j = (boxes[j].x2 - boxes[j].x1) * (boxes[j].y2 - boxes[j].y1);
-            float iou = inter / (area_i + area_j - inter);
+    nms::Params params;
+    params.iou_threshold = nms_threshold;
+    params.mode = nms::MODE_CLASS_AWARE;
+    params.coord_offset = 0.f;
+    const std::vector<int> &keep = nms_solver.run(params);
 
-            if (iou > nms_threshold) {
-                suppressed[j] = true;
-            }
-        }
+    // 按分数降序取出保留的结果，两个缓冲区交替使用
+    state.kept_boxes.clear();
+    for (int idx : keep) {
+        state.kept_boxes.push_back(boxes[idx]);
     }
-
-    boxes = keep;
+    boxes.swap(state.kept_boxes);
 }
 
 } // namespace yolo
-
@@ -1,33 +1,94 @@
 #ifndef YOLOV8_H
 #define YOLOV8_H
 
+#include "arena_allocator.h"
+#include "model_loader.h"
 #include "net.h"
+#include "net_utils.h"
+#include "nms.h"
+#include "preprocess.h"
+#include <cstring>
+#include <memory>
 #include <string>
 #include <vector>
 
 namespace yolo {
 
-// 增强的检测结果结构
+// 检测结果（POD）
+// 类别名称、图像级标签与透传数据（uuid、时间戳）不随框保存，只在NAPI边界按帧解析
 typedef struct BoxInfo {
     // 边界框坐标
     float x1;
     float y1;
     float x2;
     float y2;
-    float x_center;           // 中心点X坐标
-    float y_center;           // 中心点Y坐标
-    
+
     // 检测结果信息
     float score;              // 置信度
-    int label;                // 类别ID
-    std::string label_name;   // 类别名称（可能是SNHA物料编码）
-    
-    // 透传数据
-    std::string uuid;         // 唯一ID
-    std::string time_sent;    // 时间戳
-    std::string imglabel;     // 图像级标签
+    int label;                // 类别ID（同时作为类别名称表的下标）
 } BoxInfo;
 
+// Letterbox参数（原图 -> 网络输入）
+typedef struct LetterBox {
+    float scale;              // 缩放比例
+    int w;                    // 缩放后宽度
+    int h;                    // 缩放后高度
+    int left_pad;             // 左侧填充
+    int top_pad;              // 顶部填充
+} LetterBox;
+
+// 推理计划：init时解析blob下标、生成anchor表，之后只读
+typedef struct InferencePlan {
+    int input_blob;               // 输入blob下标
+    int output_blob;              // 输出blob下标
+    std::vector<float> anchor_centers;  // 每个anchor的中心点(cx, cy)，单位为输入像素
+    std::vector<float> anchor_strides;  // 每个anchor的步长
+} InferencePlan;
+
+// 通过类别阈值的anchor
+typedef struct Candidate {
+    int anchor;
+    int label;
+    float score;
+} Candidate;
+
+// 一帧的工作状态：常驻输入、推理输出与后处理的复用缓冲区
+// 串行推理使用YOLOv8自有的一份；流水线执行时每个在途帧各有一份，各阶段在不同线程处理不同的帧。
+// 帧尺寸变化时才重新计算letterbox并预填充常驻输入。
+typedef struct FrameState {
+    int frame_w;                  // letterbox对应的帧尺寸（旋转后）
+    int frame_h;
+    bool even_size;               // letterbox缩放尺寸是否取偶数（NV21输入）
+    LetterBox lb;                 // 当前帧尺寸的letterbox
+    ncnn::Mat input;              // 常驻网络输入（target_size x target_size x 3），填充区域已写入
+    ncnn::Mat output;             // 最近一次推理的输出
+    netutils::StageTimes stages;  // 最近一次推理各阶段的耗时
+    std::vector<BoxInfo> boxes;         // 解码与NMS后的结果（复用）
+    std::vector<BoxInfo> kept_boxes;    // NMS保留结果的交替缓冲区
+    std::vector<Candidate> candidates;  // 通道优先解码的候选（复用）
+    std::vector<float> dfl_gather;      // 通道优先DFL解码时收集的单边分布（reg_max）
+    nms::NmsSolver nms_solver;
+    preprocess::ResizeNormalizer resizer;
+
+    // NV21预处理的复用缓冲区
+    std::vector<unsigned char> nv21_resized;  // 缩放后的NV21（旋转前）
+    std::vector<unsigned char> nv21_rotated;  // 旋转后的NV21
+    std::vector<unsigned char> rgb_buffer;    // 转换后的RGB
+} FrameState;
+
+// 类别名称（指向静态表，无需释放）
+// use_snha: 使用SNHA物料编码（user_id为"SNHA"时）；未映射的类别使用COCO名称，未知类别为"unknown"
+const char *label_name(int label, bool use_snha);
+
+// 图像级标签（指向静态表），仅SNHA映射有值，未映射时为"IMG_UNKNOWN"，非SNHA为空串
+const char *image_label(int label, bool use_snha);
+
+// NV21帧参数是否有效：宽高为不小于4的偶数（yuv420sp要求，VU平面的缩放至少需要2x2），旋转角度为0/90/180/270
+bool valid_nv21(int img_w, int img_h, int rotation);
+
+// 是否使用SNHA标签映射
+inline bool is_snha_user(const char *user_id) { return user_id != nullptr && strcmp(user_id, "SNHA") == 0; }
+
 class YOLOv8 {
 public:
     YOLOv8();
@@ -40,16 +101,68 @@ public:
     // modeltype: 模型类型（如"yolov8n", "yolov8s"等）
     int init(ncnn::Option option, const char *param, const char *model, const char *modeltype);
 
+    // 初始化模型（模型内容已加载到内存，bin在原地引用，由YOLOv8持有直到释放）
+    int init(ncnn::Option option, std::unique_ptr<modelloader::ModelData> model, const char *modeltype);
+
     // 执行推理
     // data: 输入图像数据（RGBA格式）
     // img_w: 图像宽度
     // img_h: 图像高度
     // modeltype: 模型类型
-    // user_id: 用户ID（用于SNHA标签映射）
-    // uuid: 唯一ID（透传）
-    // time_sent: 时间戳（透传）
-    std::vector<BoxInfo> run(ncnn::Mat &data, int img_w, int img_h, const char *modeltype,
-                            const char *user_id = "", const char *uuid = "", const char *time_sent = "");
+    // 返回的结果由YOLOv8持有，下次推理前有效（结果缓冲区跨帧复用，预热后解码与NMS不再分配内存）
+    const std::vector<BoxInfo> &run(ncnn::Mat &data, int img_w, int img_h, const char *modeltype);
+
+    // 执行推理（相机NV21原始帧，YUV转RGB、旋转与letterbox缩放在native完成）
+    // nv21: NV21数据（Y平面后接VU交错平面，两个平面行跨度均为stride）
+    // img_w: 原始帧宽度（旋转前）
+    // img_h: 原始帧高度（旋转前）
+    // stride: 行跨度（字节）
+    // rotation: 顺时针旋转角度（0/90/180/270）
+    // 返回的坐标位于旋转后的图像坐标系；参数无效（见valid_nv21）时返回空结果
+    const std::vector<BoxInfo> &run_nv21(const unsigned char *nv21, int img_w, int img_h, int stride, int rotation,
+                                         const char *modeltype);
+
+    // 设置阈值
+    // conf: 置信度阈值
+    // nms: NMS阈值
+    // class_thresholds: 每个类别的置信度阈值（为空时所有类别使用conf）
+    void set_thresholds(float conf, float nms, const std::vector<float> &class_thresholds);
+
+    // 类别数量（init后有效）
+    int class_count() const { return num_classes; }
+
+    // 推理blob的内存统计（未使用arena时全部为0）
+    void memory_stats(arena::Stats &out) const { blob_arena.stats(out); }
+
+    // 最近一次推理各阶段的耗时
+    const netutils::StageTimes &stage_times() const { return frame.stages; }
+
+    // 分阶段执行（流水线与批量识别使用），一帧依次经过 preprocess -> forward -> postprocess
+    // 各阶段只修改传入的state，不同state可以在不同线程同时处理；forward共用net的分配器，同一时刻只能有一个调用；
+    // 执行期间不能修改阈值，也不能调用run。
+
+    // 按当前模型准备帧状态（init成功后调用）
+    void init_frame(FrameState &state) const;
+
+    // 预处理RGBA图像，写入state.input；模型未初始化时返回false
+    bool preprocess(FrameState &state, const unsigned char *rgba, int img_w, int img_h);
+
+    // 预处理NV21相机帧，参数同run_nv21；模型未初始化或参数无效时返回false
+    bool preprocess_nv21(FrameState &state, const unsigned char *nv21, int img_w, int img_h, int stride,
+                         int rotation);
+
+    // 推理，输出写入state.output
+    // num_threads: 本次推理的线程数，<=0时使用option中的设置
+    // detach_output: 输出拷贝到独立的内存，不占用net的分配器（下一帧推理前输出仍在其他线程使用时需要）
+    void forward(FrameState &state, int num_threads, bool detach_output);
+
+    // 并发推理：多个线程可同时调用，各自使用自己的state与分配器（分配器只在调用线程使用，可以是无锁内存池）
+    // 与forward不同，不使用net的分配器，因此可以和其他并发推理同时进行；输出由blob_allocator分配
+    void forward_concurrent(FrameState &state, int num_threads, ncnn::Allocator *blob_allocator,
+                            ncnn::Allocator *workspace_allocator);
+
+    // 解码与NMS，结果由state持有
+    const std::vector<BoxInfo> &postprocess(FrameState &state);
 
 private:
     // 自动检测输出格式
@@ -59,30 +172,77 @@ private:
         FORMAT_DFL = 2              // DFL格式: [distance_distribution, scores...]
     };
 
-    // 检测输出格式
-    OutputFormat detect_output_format();
+    // 输出布局
+    enum OutputLayout {
+        LAYOUT_ANCHOR_MAJOR = 0,    // [N x C]: 每个anchor的C个值连续存放
+        LAYOUT_CHANNEL_MAJOR = 1    // [C x N]: 每个通道的N个anchor值连续存放（ncnn标准导出）
+    };
+
+    // 读取 <param>.meta 描述文件确定输出格式与布局
+    // 每行 key=value：format=direct|dfl, layout=channel|anchor, reg_max=16, num_classes=80
+    bool load_output_meta(const std::string &meta);
+
+    // 由.param图结构推断输出格式与布局
+    // 检测头每个尺度的 Concat(box卷积, cls卷积) 给出 4*reg_max 与类别数；
+    // 图中存在Softmax（DFL已在图内解码）时为直接坐标格式；输出由Permute产生时为anchor优先布局
+    bool infer_output_from_param(const std::string &param);
+
+    // 兜底：虚拟输入推理后按输出形状判断格式与布局
+    bool detect_output_format();
+
+    // 输出形状能否按当前格式解码：特征维（通道优先为行数，anchor优先为列数）不少于框回归维度+类别数
+    bool output_shape_ok(const ncnn::Mat &output) const;
 
-    // 解码直接坐标格式
-    std::vector<BoxInfo> decode_direct_coords(ncnn::Mat &output, int img_w, int img_h, float scale_x, float scale_y);
+    // 通道优先布局的类别扫描，结果写入candidates
+    // 按anchor分块，块内依次连续读取每个类别平面并维护每个anchor的最大logit与类别
+    void scan_channel_major(FrameState &state, const ncnn::Mat &output, int class_offset, int num_anchors);
 
-    // 解码DFL格式
-    std::vector<BoxInfo> decode_dfl(ncnn::Mat &output, int img_w, int img_h, float scale_x, float scale_y);
+    // 生成anchor中心点与步长表
+    void build_anchors();
 
-    // NMS非极大值抑制
-    static void nms(std::vector<BoxInfo> &boxes, float nms_threshold);
+    // 帧尺寸变化时重新计算letterbox，几何变化时重新预填充常驻输入
+    // even: 缩放尺寸取偶数（yuv420sp要求）
+    const LetterBox &update_plan(FrameState &state, int img_w, int img_h, bool even);
+
+    // 解码直接坐标格式，结果追加到state.boxes
+    void decode_direct_coords(FrameState &state, ncnn::Mat &output, int img_w, int img_h, const LetterBox &lb);
+
+    // 解码DFL格式，结果追加到state.boxes
+    void decode_dfl(FrameState &state, ncnn::Mat &output, int img_w, int img_h, const LetterBox &lb);
+
+    // 对state.boxes做NMS非极大值抑制（按类别）
+    void nms(FrameState &state, float nms_threshold);
 
     // 快速sigmoid函数
     inline float sigmoid(float x);
 
+    // 由置信度阈值换算logit阈值，用于在sigmoid之前提前拒绝anchor
+    void update_logit_threshold();
+
+    // 类别的置信度阈值
+    inline float class_threshold(int label) const;
+
+    // 自有分配器（option未指定时使用；arena仅在开启mempool时使用），需在net与plan之后析构
+    ncnn::UnlockedPoolAllocator blob_pool_allocator;
+    ncnn::PoolAllocator workspace_pool_allocator;
+    arena::ArenaAllocator blob_arena;
+    bool use_arena = false;       // 推理blob是否来自blob_arena
+
     ncnn::Net net;
+    std::unique_ptr<modelloader::ModelData> model_data;  // 模型内容（net引用其中的权重）
     int target_size;              // 目标输入尺寸（YOLOv8通常为640）
     float mean_vals[3];            // 均值
     float norm_vals[3];            // 归一化值
     int num_classes;               // 类别数量（默认80）
     OutputFormat output_format;    // 检测到的输出格式
+    OutputLayout output_layout;    // 检测到的输出布局
     int reg_max;                   // DFL格式的reg_max值（通常为16）
     float conf_threshold;          // 置信度阈值
     float nms_threshold;           // NMS阈值
+    std::vector<float> class_thresholds;  // 每个类别的置信度阈值（可选）
+    float logit_threshold;         // 所有类别阈值中最低者对应的logit（已留余量）
+    InferencePlan plan;                 // 推理计划
+    FrameState frame;                   // 串行推理（run/run_nv21）的帧状态
 };
 
 } // namespace yolo
@@ -0,0 +1,244 @@
+// 稳定状态零分配测试：预热后每帧的 run / run_nv21 不应在检测器代码中分配堆内存
+// 计数三类分配：全局operator new、未指定分配器的Mat（fastMalloc）、经ncnn::Allocator且内存池未能复用的分配。
+// ncnn内部（extractor的blob表、像素缩放的系数表等）在真实ncnn中每帧都会分配，替身以InternalScope标记，不计入。
+#include "nanodet.h"
+#include "test_util.h"
+#include "yolov8.h"
+#include <atomic>
+#include <cstdlib>
+#include <mutex>
+#include <new>
+
+// ---------------------------------------------------------------- 计数的operator new
+
+static std::atomic<size_t> g_news(0);
+
+static void *counted_malloc(size_t size) {
+    if (!ncnnstub::in_ncnn()) {
+        g_news++;
+    }
+    void *ptr = malloc(size ? size : 1);
+    if (ptr == nullptr) {
+        throw std::bad_alloc();
+    }
+    return ptr;
+}
+
+void *operator new(size_t size) { return counted_malloc(size); }
+
+void *operator new[](size_t size) { return counted_malloc(size); }
+
+void *operator new(size_t size, const std::nothrow_t &) noexcept {
+    try {
+        return counted_malloc(size);
+    } catch (...) {
+        return nullptr;
+    }
+}
+
+void *operator new[](size_t size, const std::nothrow_t &) noexcept {
+    try {
+        return counted_malloc(size);
+    } catch (...) {
+        return nullptr;
+    }
+}
+
+void operator delete(void *ptr) noexcept { free(ptr); }
+
+void operator delete[](void *ptr) noexcept { free(ptr); }
+
+void operator delete(void *ptr, size_t) noexcept { free(ptr); }
+
+void operator delete[](void *ptr, size_t) noexcept { free(ptr); }
+
+// ---------------------------------------------------------------- 计数的ncnn::Allocator
+
+// 内存池：复用大小相近的空闲块（规则同ncnn::PoolAllocator），heap_allocations为未能复用、向堆申请的次数
+// 块表为定长数组，记账本身不调用operator new
+class CountingAllocator : public ncnn::Allocator {
+public:
+    CountingAllocator() : calls(0), heap_allocations(0), count(0) {}
+
+    virtual ~CountingAllocator() {
+        for (int i = 0; i < count; i++) {
+            ncnn::fastFree(blocks[i].ptr);
+        }
+    }
+
+    virtual void *fastMalloc(size_t size) {
+        std::lock_guard<std::mutex> lock(mutex);
+        calls++;
+        for (int i = 0; i < count; i++) {
+            Block &b = blocks[i];
+            if (!b.in_use && b.size >= size && b.size * 3 / 4 <= size) {
+                b.in_use = true;
+                return b.ptr;
+            }
+        }
+        if (count == MAX_BLOCKS) {
+            abort();
+        }
+        heap_allocations++;
+        Block &b = blocks[count++];
+        b.size = size;
+        b.ptr = ncnn::fastMalloc(size);
+        b.in_use = true;
+        return b.ptr;
+    }
+
+    virtual void fastFree(void *ptr) {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (int i = 0; i < count; i++) {
+            if (blocks[i].ptr == ptr) {
+                blocks[i].in_use = false;
+                return;
+            }
+        }
+        abort();
+    }
+
+    size_t calls;
+    size_t heap_allocations;
+
+private:
+    static const int MAX_BLOCKS = 256;
+    typedef struct Block {
+        size_t size;
+        void *ptr;
+        bool in_use;
+    } Block;
+
+    std::mutex mutex;
+    Block blocks[MAX_BLOCKS];
+    int count;
+};
+
+// ---------------------------------------------------------------- 测试
+
+static const int WARMUP_FRAMES = 3;
+static const int MEASURED_FRAMES = 10;
+
+// 一段时间内ncnn之外的分配次数
+typedef struct Counts {
+    size_t news;
+    size_t default_mats;
+    size_t pool_heap;
+} Counts;
+
+static Counts snapshot(const CountingAllocator *allocator) {
+    Counts c;
+    c.news = g_news.load();
+    c.default_mats = ncnnstub::default_mat_allocations();
+    c.pool_heap = allocator ? allocator->heap_allocations : 0;
+    return c;
+}
+
+// 预热后连续运行frame()，检查三类分配都没有增加；返回计时期间最后一帧的框数
+template <typename Frame>
+static size_t check_steady_state(const char *name, const CountingAllocator *allocator, Frame frame) {
+    size_t boxes = 0;
+    for (int i = 0; i < WARMUP_FRAMES; i++) {
+        boxes = frame();
+    }
+    Counts before = snapshot(allocator);
+    for (int i = 0; i < MEASURED_FRAMES; i++) {
+        boxes = frame();
+    }
+    Counts after = snapshot(allocator);
+
+    printf("%-28s boxes:%zu new:%zu mat:%zu pool:%zu (over %d frames)\n", name, boxes, after.news - before.news,
+           after.default_mats - before.default_mats, after.pool_heap - before.pool_heap, MEASURED_FRAMES);
+    CHECK_EQ(after.news - before.news, 0);
+    CHECK_EQ(after.default_mats - before.default_mats, 0);
+    CHECK_EQ(after.pool_heap - before.pool_heap, 0);
+    return boxes;
+}
+
+// 三种分配器配置：检测器自有的内存池、按帧重置的arena（mempool开启）、调用方指定的分配器
+enum AllocatorMode { OWN_POOLS, ARENA, CALLER_ALLOCATOR };
+
+static ncnn::Option make_option(AllocatorMode mode, CountingAllocator *allocator) {
+    ncnn::Option option;
+    option.num_threads = 1;
+    option.use_local_pool_allocator = mode == ARENA;
+    if (mode == CALLER_ALLOCATOR) {
+        option.blob_allocator = allocator;
+        option.workspace_allocator = allocator;
+    }
+    return option;
+}
+
+static void test_yolov8(AllocatorMode mode, bool dfl) {
+    testutil::install_yolov8_forward(dfl, 64);
+    CountingAllocator allocator;
+    yolo::YOLOv8 model;
+    CHECK(model.init(make_option(mode, &allocator), testutil::make_yolov8_model(dfl), "yolov8n") == 1);
+
+    std::vector<unsigned char> rgba = testutil::random_pixels(1280, 720, 4, 1);
+    ncnn::Mat image(1280, 720, 4, (void *)rgba.data());
+    const char *modes[] = {"own pools", "arena", "caller alloc"};
+    char name[64];
+    snprintf(name, sizeof(name), "yolov8 %s rgba (%s)", dfl ? "dfl" : "direct", modes[mode]);
+    size_t boxes = check_steady_state(name, mode == CALLER_ALLOCATOR ? &allocator : nullptr,
+                                      [&]() { return model.run(image, 1280, 720, "yolov8n").size(); });
+    CHECK(boxes > 0);
+    if (mode == CALLER_ALLOCATOR) {
+        CHECK(allocator.calls > 0);
+    }
+    if (mode == ARENA) {
+        // arena预热后不再溢出
+        arena::Stats warm;
+        model.memory_stats(warm);
+        model.run(image, 1280, 720, "yolov8n");
+        arena::Stats end;
+        model.memory_stats(end);
+        CHECK(end.frames > warm.frames);
+        CHECK_EQ(end.fallback_allocations - warm.fallback_allocations, 0);
+    }
+}
+
+static void test_yolov8_nv21(int rotation) {
+    testutil::install_yolov8_forward(false, 64);
+    CountingAllocator allocator;
+    yolo::YOLOv8 model;
+    CHECK(model.init(make_option(CALLER_ALLOCATOR, &allocator), testutil::make_yolov8_model(false), "yolov8n") == 1);
+
+    const int width = 1280;
+    const int height = 720;
+    const int stride = 1344;
+    std::vector<unsigned char> nv21 = testutil::random_pixels(stride, height * 3 / 2, 1, 2);
+    char name[64];
+    snprintf(name, sizeof(name), "yolov8 nv21 (rotation %d)", rotation);
+    size_t boxes = check_steady_state(name, &allocator, [&]() {
+        return model.run_nv21(nv21.data(), width, height, stride, rotation, "yolov8n").size();
+    });
+    CHECK(boxes > 0);
+}
+
+static void test_nanodet() {
+    testutil::install_nanodet_forward(16);
+    CountingAllocator allocator;
+    nanodet::NanoDet model;
+    CHECK(model.init(make_option(CALLER_ALLOCATOR, &allocator), testutil::make_nanodet_model(), "nanodet-m") == 1);
+
+    std::vector<unsigned char> rgba = testutil::random_pixels(640, 480, 4, 3);
+    ncnn::Mat image(640, 480, 4, (void *)rgba.data());
+    size_t boxes = check_steady_state("nanodet rgba (caller alloc)", &allocator,
+                                      [&]() { return model.run(image, 640, 480, "nanodet-m").size(); });
+    CHECK(boxes > 0);
+}
+
+int main() {
+    test_yolov8(OWN_POOLS, false);
+    test_yolov8(ARENA, false);
+    test_yolov8(CALLER_ALLOCATOR, false);
+    test_yolov8(CALLER_ALLOCATOR, true);
+    test_yolov8_nv21(0);
+    test_yolov8_nv21(90);
+    test_nanodet();
+    ncnnstub::set_forward(nullptr);
+
+    printf("%s\n", testutil::failures == 0 ? "PASS" : "FAIL");
+    return testutil::failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,79 @@
+// 批量识别的扩展性：同一批图片分别用1、2、4…个worker识别，报告吞吐、相对1个worker的加速比与实际并行度
+// 推理由测试模拟，forward_ms为每张图片推理忙等的时长；结果与串行run逐张比较。
+//   batch_benchmark [images] [forward_ms]
+#include "batch.h"
+#include "cpu.h"
+#include "test_util.h"
+#include <cstdlib>
+
+// 图库中常见的几种尺寸，轮流使用
+static const int SIZES[][2] = {{1280, 720}, {720, 1280}, {1024, 768}, {640, 480}};
+
+static bool same_boxes(const std::vector<yolo::BoxInfo> &a, const std::vector<yolo::BoxInfo> &b) {
+    if (a.size() != b.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < a.size(); i++) {
+        if (a[i].x1 != b[i].x1 || a[i].y1 != b[i].y1 || a[i].x2 != b[i].x2 || a[i].y2 != b[i].y2 ||
+            a[i].score != b[i].score || a[i].label != b[i].label) {
+            return false;
+        }
+    }
+    return true;
+}
+
+int main(int argc, char **argv) {
+    int count = argc > 1 ? atoi(argv[1]) : 64;
+    double forward_ms = argc > 2 ? atof(argv[2]) : 8;
+    if (count <= 0 || forward_ms < 0) {
+        fprintf(stderr, "usage: %s [images] [forward_ms]\n", argv[0]);
+        return 2;
+    }
+
+    testutil::install_yolov8_forward(false, 64, forward_ms);
+    yolo::YOLOv8 model;
+    ncnn::Option option;
+    option.num_threads = 1;
+    CHECK(model.init(option, testutil::make_yolov8_model(false), "yolov8n") == 1);
+
+    std::vector<std::vector<unsigned char>> pixels;
+    std::vector<batch::Image> images;
+    for (int i = 0; i < count; i++) {
+        const int *size = SIZES[i % 4];
+        pixels.push_back(testutil::random_pixels(size[0], size[1], 4, i + 1));
+    }
+    for (int i = 0; i < count; i++) {
+        images.push_back({pixels[i].data(), SIZES[i % 4][0], SIZES[i % 4][1]});
+    }
+
+    // 串行结果作为参照
+    std::vector<std::vector<yolo::BoxInfo>> expected;
+    for (const batch::Image &image : images) {
+        ncnn::Mat data(image.width, image.height, 4, (void *)image.rgba);
+        expected.push_back(model.run(data, image.width, image.height, "yolov8n"));
+    }
+
+    int cpus = ncnn::get_cpu_count();
+    printf("yolov8n, %d images, forward %.1f ms, %d cpus\n", count, forward_ms, cpus);
+    double base_wall = 0;
+    for (int workers = 1; workers <= std::max(cpus, 4); workers *= 2) {
+        batch::Options options = {workers, 1};
+        std::vector<std::vector<yolo::BoxInfo>> results;
+        batch::Stats stats;
+        batch::run(model, images, options, results, stats);
+        if (workers == 1) {
+            base_wall = stats.wall;
+        }
+        printf("workers:%3d  %7.1f images/s  speedup %.2fx  parallelism %.2f\n", stats.workers,
+               count * 1000.0 / stats.wall, base_wall / stats.wall, stats.busy / stats.wall);
+
+        CHECK_EQ(results.size(), images.size());
+        for (size_t i = 0; i < results.size() && i < expected.size(); i++) {
+            CHECK(same_boxes(results[i], expected[i]));
+        }
+    }
+    ncnnstub::set_forward(nullptr);
+
+    printf("%s\n", testutil::failures == 0 ? "PASS" : "FAIL");
+    return testutil::failures == 0 ? 0 : 1;
+}
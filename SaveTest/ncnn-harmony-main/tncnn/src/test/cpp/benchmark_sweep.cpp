@@ -0,0 +1,33 @@
+// 选项组合测试的主机命令行：与benchmark_sweep接口相同，逐一测试 winograd/sgemm/packing/lightmode/精度 的组合，
+// 模型使用空权重，按p50排序的结果以JSON输出到标准输出。需要主机上编译的ncnn（见CMakeLists.txt的TNCNN_NCNN_DIR）。
+//   benchmark_sweep model.param [size] [loops] [threads]
+#include "benchmark_ncnn.h"
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+int main(int argc, char **argv) {
+    if (argc < 2) {
+        fprintf(stderr, "usage: %s model.param [size=640] [loops=20] [threads=4]\n", argv[0]);
+        return 2;
+    }
+    std::string param_path = argv[1];
+    int size = argc > 2 ? atoi(argv[2]) : 640;
+    int loops = argc > 3 ? atoi(argv[3]) : 20;
+    int threads = argc > 4 ? atoi(argv[4]) : 4;
+    if (size <= 0 || loops <= 0 || threads <= 0) {
+        fprintf(stderr, "size, loops and threads must be positive\n");
+        return 2;
+    }
+
+    ncnn::Option base;
+    base.num_threads = threads;
+
+    // 模型名取param文件名（不含目录与扩展名）
+    std::string name = param_path.substr(param_path.find_last_of('/') + 1);
+    name = name.substr(0, name.find_last_of('.'));
+
+    std::vector<benchmark::SweepEntry> entries = benchmark::run_sweep("", param_path, base, size, loops);
+    printf("%s\n", benchmark::sweep_to_json(name, entries).c_str());
+    return !entries.empty() && entries.front().ok ? 0 : 1;
+}
@@ -0,0 +1,65 @@
+// YOLOv8后处理基准：640输入、8400个anchor的通道优先输出，分别计时解码与NMS
+// 输出由fill_yolov8_output生成，不经过推理；hits为类别分数高于阈值的anchor数。
+//   decode_benchmark [iterations]
+#include "test_util.h"
+#include "yolov8.h"
+#include <algorithm>
+#include <cstdlib>
+
+static const int IMAGE_W = 1280;
+static const int IMAGE_H = 720;
+
+// 已排序耗时的分位数
+static double percentile(const std::vector<double> &sorted, double p) {
+    size_t i = (size_t)(p * (sorted.size() - 1) + 0.5);
+    return sorted[i];
+}
+
+static void bench(bool dfl, int hits, int iterations) {
+    yolo::YOLOv8 model;
+    ncnn::Option option;
+    option.num_threads = 1;
+    CHECK(model.init(option, testutil::make_yolov8_model(dfl), "yolov8n") == 1);
+
+    // 预处理一帧以得到letterbox，随后直接放入合成的网络输出
+    yolo::FrameState state;
+    model.init_frame(state);
+    std::vector<unsigned char> rgba = testutil::random_pixels(IMAGE_W, IMAGE_H, 4, 1);
+    CHECK(model.preprocess(state, rgba.data(), IMAGE_W, IMAGE_H));
+    state.output.create(8400, (dfl ? 4 * 16 : 4) + 80);
+    testutil::fill_yolov8_output(state.output, dfl, hits);
+
+    std::vector<double> decode(iterations);
+    std::vector<double> nms(iterations);
+    size_t boxes = 0;
+    for (int i = 0; i < iterations; i++) {
+        boxes = model.postprocess(state).size();
+        decode[i] = state.stages.decode;
+        nms[i] = state.stages.nms;
+    }
+    std::sort(decode.begin(), decode.end());
+    std::sort(nms.begin(), nms.end());
+
+    printf("%-6s hits:%5d boxes:%4zu  decode p50:%8.1f us p99:%8.1f us  nms p50:%8.1f us p99:%8.1f us\n",
+           dfl ? "dfl" : "direct", hits, boxes, percentile(decode, 0.5) * 1000, percentile(decode, 0.99) * 1000,
+           percentile(nms, 0.5) * 1000, percentile(nms, 0.99) * 1000);
+    CHECK((boxes > 0) == (hits > 0));
+    CHECK(boxes <= (size_t)hits);
+}
+
+int main(int argc, char **argv) {
+    int iterations = argc > 1 ? atoi(argv[1]) : 1000;
+    if (iterations <= 0) {
+        fprintf(stderr, "usage: %s [iterations]\n", argv[0]);
+        return 2;
+    }
+
+    const int hits[] = {0, 64, 1024};
+    for (int dfl = 0; dfl < 2; dfl++) {
+        for (int h : hits) {
+            bench(dfl != 0, h, iterations);
+        }
+    }
+    printf("%s\n", testutil::failures == 0 ? "PASS" : "FAIL");
+    return testutil::failures == 0 ? 0 : 1;
+}
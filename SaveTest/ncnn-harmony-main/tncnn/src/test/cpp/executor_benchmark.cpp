@@ -0,0 +1,111 @@
+// 流水线执行器与串行推理的吞吐与延迟对比
+// 推理由测试模拟，forward_ms为每帧推理忙等的时长（占用推理线程一个核心）；预处理与后处理为真实代码。
+//   executor_benchmark [frames] [forward_ms]
+#include "benchmark.h"
+#include "cpu.h"
+#include "pipeline.h"
+#include "test_util.h"
+#include <algorithm>
+#include <cstdlib>
+
+static const int IMAGE_W = 1280;
+static const int IMAGE_H = 720;
+
+typedef struct Report {
+    double wall;                  // 总耗时（毫秒）
+    std::vector<double> latency;  // 每帧延迟
+    std::vector<size_t> boxes;    // 每帧框数
+} Report;
+
+static double percentile(const std::vector<double> &sorted, double p) {
+    size_t i = (size_t)(p * (sorted.size() - 1) + 0.5);
+    return sorted[i];
+}
+
+static void print(const char *name, Report &report) {
+    std::vector<double> sorted = report.latency;
+    std::sort(sorted.begin(), sorted.end());
+    printf("%-24s frames:%4zu  %7.1f fps  latency p50:%7.2f ms p99:%7.2f ms\n", name, sorted.size(),
+           sorted.size() * 1000.0 / report.wall, percentile(sorted, 0.5), percentile(sorted, 0.99));
+}
+
+static Report run_serial(yolo::YOLOv8 &model, const ncnn::Mat &image, int frames) {
+    Report report;
+    ncnn::Mat data = image;
+    double start = ncnn::get_current_time();
+    for (int i = 0; i < frames; i++) {
+        double frame_start = ncnn::get_current_time();
+        size_t boxes = model.run(data, IMAGE_W, IMAGE_H, "yolov8n").size();
+        report.latency.push_back(ncnn::get_current_time() - frame_start);
+        report.boxes.push_back(boxes);
+    }
+    report.wall = ncnn::get_current_time() - start;
+    return report;
+}
+
+static Report run_pipelined(yolo::YOLOv8 &model, const ncnn::Mat &image, int frames, int max_in_flight) {
+    Report report;
+    uint64_t last_seq = 0;
+    bool all_ok = true;
+    pipeline::Config config;
+    config.max_in_flight = max_in_flight;
+    config.infer_threads = 1;
+    config.powersave = -1;
+
+    double start = ncnn::get_current_time();
+    {
+        pipeline::Executor executor(model, config, [&](const pipeline::Output &output) {
+            // 结果按提交顺序在后处理线程回调
+            all_ok = all_ok && output.ok && output.seq == last_seq + 1;
+            last_seq = output.seq;
+            report.latency.push_back(output.latency);
+            report.boxes.push_back(output.boxes->size());
+        });
+        pipeline::Input input = {(const unsigned char *)image.data, IMAGE_W, IMAGE_H, false, 0, 0};
+        for (int i = 0; i < frames; i++) {
+            executor.submit(input);
+        }
+        executor.drain();
+    }
+    report.wall = ncnn::get_current_time() - start;
+    CHECK(all_ok);
+    return report;
+}
+
+int main(int argc, char **argv) {
+    int frames = argc > 1 ? atoi(argv[1]) : 200;
+    double forward_ms = argc > 2 ? atof(argv[2]) : 8;
+    if (frames <= 0 || forward_ms < 0) {
+        fprintf(stderr, "usage: %s [frames] [forward_ms]\n", argv[0]);
+        return 2;
+    }
+
+    testutil::install_yolov8_forward(false, 64, forward_ms);
+    yolo::YOLOv8 model;
+    ncnn::Option option;
+    option.num_threads = 1;
+    CHECK(model.init(option, testutil::make_yolov8_model(false), "yolov8n") == 1);
+
+    std::vector<unsigned char> rgba = testutil::random_pixels(IMAGE_W, IMAGE_H, 4, 1);
+    ncnn::Mat image(IMAGE_W, IMAGE_H, 4, (void *)rgba.data());
+
+    // 三个阶段各需一个核心才能重叠，核心不足时流水线只增加延迟
+    printf("yolov8n rgba %dx%d, forward %.1f ms, %d cpus\n", IMAGE_W, IMAGE_H, forward_ms, ncnn::get_cpu_count());
+    run_serial(model, image, 2);
+    Report serial = run_serial(model, image, frames);
+    print("serial", serial);
+    const int in_flight[] = {3, 4};
+    for (int n : in_flight) {
+        Report pipelined = run_pipelined(model, image, frames, n);
+        char name[64];
+        snprintf(name, sizeof(name), "pipelined (%d in flight)", n);
+        print(name, pipelined);
+        printf("  speedup %.2fx\n", serial.wall / pipelined.wall);
+        CHECK_EQ(pipelined.boxes.size(), frames);
+        CHECK(pipelined.boxes == serial.boxes);
+    }
+    ncnnstub::set_forward(nullptr);
+
+    printf("%s\n", testutil::failures == 0 ? "PASS" : "FAIL");
+    return testutil::failures == 0 ? 0 : 1;
+}
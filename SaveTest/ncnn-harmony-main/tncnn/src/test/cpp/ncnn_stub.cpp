@@ -0,0 +1,853 @@
+#include "ncnn_stub.h"
+#include "benchmark.h"
+#include "cpu.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <climits>
+#include <cmath>
+#include <cstring>
+#include <mutex>
+#include <sstream>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace ncnnstub {
+
+static ForwardFunc g_forward;
+static thread_local int g_internal_depth = 0;
+static std::atomic<size_t> g_default_mat_allocations(0);
+
+void set_forward(ForwardFunc func) { g_forward = std::move(func); }
+
+bool in_ncnn() { return g_internal_depth > 0; }
+
+size_t default_mat_allocations() { return g_default_mat_allocations.load(); }
+
+InternalScope::InternalScope() { g_internal_depth++; }
+
+InternalScope::~InternalScope() { g_internal_depth--; }
+
+} // namespace ncnnstub
+
+namespace ncnn {
+
+// ---------------------------------------------------------------- Mat
+
+// 与ncnn相同的分配方式：数据后紧跟引用计数
+static void *allocate_mat(size_t totalsize, Allocator *allocator, int *&refcount) {
+    if (allocator == nullptr && !ncnnstub::in_ncnn()) {
+        ncnnstub::g_default_mat_allocations++;
+    }
+    void *data = allocator ? allocator->fastMalloc(totalsize + sizeof(*refcount))
+                           : fastMalloc(totalsize + sizeof(*refcount));
+    refcount = (int *)((unsigned char *)data + totalsize);
+    *refcount = 1;
+    return data;
+}
+
+void Mat::create(int _w, size_t _elemsize, Allocator *_allocator) {
+    if (dims == 1 && w == _w && elemsize == _elemsize && elempack == 1 && allocator == _allocator) {
+        return;
+    }
+    release();
+
+    elemsize = _elemsize;
+    elempack = 1;
+    allocator = _allocator;
+    dims = 1;
+    w = _w;
+    h = 1;
+    d = 1;
+    c = 1;
+    cstep = w;
+
+    size_t totalsize = alignSize(total() * elemsize, 4);
+    if (totalsize > 0) {
+        data = allocate_mat(totalsize, allocator, refcount);
+    }
+}
+
+void Mat::create(int _w, int _h, size_t _elemsize, Allocator *_allocator) {
+    if (dims == 2 && w == _w && h == _h && elemsize == _elemsize && elempack == 1 && allocator == _allocator) {
+        return;
+    }
+    release();
+
+    elemsize = _elemsize;
+    elempack = 1;
+    allocator = _allocator;
+    dims = 2;
+    w = _w;
+    h = _h;
+    d = 1;
+    c = 1;
+    cstep = (size_t)w * h;
+
+    size_t totalsize = alignSize(total() * elemsize, 4);
+    if (totalsize > 0) {
+        data = allocate_mat(totalsize, allocator, refcount);
+    }
+}
+
+void Mat::create(int _w, int _h, int _c, size_t _elemsize, Allocator *_allocator) {
+    if (dims == 3 && w == _w && h == _h && c == _c && elemsize == _elemsize && elempack == 1 &&
+        allocator == _allocator) {
+        return;
+    }
+    release();
+
+    elemsize = _elemsize;
+    elempack = 1;
+    allocator = _allocator;
+    dims = 3;
+    w = _w;
+    h = _h;
+    d = 1;
+    c = _c;
+    cstep = alignSize((size_t)w * h * elemsize, 16) / elemsize;
+
+    size_t totalsize = alignSize(total() * elemsize, 4);
+    if (totalsize > 0) {
+        data = allocate_mat(totalsize, allocator, refcount);
+    }
+}
+
+Mat Mat::clone(Allocator *_allocator) const {
+    if (empty()) {
+        return Mat();
+    }
+    Mat m;
+    if (dims == 1) {
+        m.create(w, elemsize, _allocator);
+    } else if (dims == 2) {
+        m.create(w, h, elemsize, _allocator);
+    } else {
+        m.create(w, h, c, elemsize, _allocator);
+    }
+    if (total() > 0) {
+        if (cstep == m.cstep) {
+            memcpy(m.data, data, total() * elemsize);
+        } else {
+            size_t size = (size_t)w * h * elemsize;
+            for (int q = 0; q < c; q++) {
+                memcpy(m.channel(q).data, channel(q).data, size);
+            }
+        }
+    }
+    return m;
+}
+
+// 按ncnn的Scale/Bias层：均值与归一化都有时 x * norm + (-mean * norm)，只有均值时 x + (-mean)，只有归一化时 x * norm
+void Mat::substract_mean_normalize(const float *mean_vals, const float *norm_vals) {
+    for (int q = 0; q < c; q++) {
+        float *ptr = channel(q);
+        int size = w * h;
+        if (mean_vals && norm_vals) {
+            float scale = norm_vals[q];
+            float bias = -mean_vals[q] * norm_vals[q];
+            for (int i = 0; i < size; i++) {
+                ptr[i] = ptr[i] * scale + bias;
+            }
+        } else if (mean_vals) {
+            float bias = -mean_vals[q];
+            for (int i = 0; i < size; i++) {
+                ptr[i] += bias;
+            }
+        } else if (norm_vals) {
+            float scale = norm_vals[q];
+            for (int i = 0; i < size; i++) {
+                ptr[i] *= scale;
+            }
+        }
+    }
+}
+
+Mat Mat::from_pixels(const unsigned char *pixels, int type, int w, int h, Allocator *allocator) {
+    int type_from = type & PIXEL_FORMAT_MASK;
+    int type_to = (type & PIXEL_CONVERT_MASK) ? (type >> PIXEL_CONVERT_SHIFT) : type_from;
+    int src_channels = type_from == PIXEL_RGBA || type_from == PIXEL_BGRA ? 4 : 3;
+    if ((type_from != PIXEL_RGB && type_from != PIXEL_RGBA) || (type_to != PIXEL_RGB && type_to != PIXEL_BGR)) {
+        // 替身只支持tncnn用到的RGB/RGBA输入
+        return Mat();
+    }
+
+    Mat m(w, h, 3, 4u, allocator);
+    float *ptr0 = m.channel(0);
+    float *ptr1 = m.channel(1);
+    float *ptr2 = m.channel(2);
+    bool bgr = type_to == PIXEL_BGR;
+    for (int i = 0; i < w * h; i++) {
+        const unsigned char *p = pixels + (size_t)i * src_channels;
+        ptr0[i] = bgr ? p[2] : p[0];
+        ptr1[i] = p[1];
+        ptr2[i] = bgr ? p[0] : p[2];
+    }
+    return m;
+}
+
+Mat Mat::from_pixels_resize(const unsigned char *pixels, int type, int w, int h, int target_width,
+                            int target_height, Allocator *allocator) {
+    int type_from = type & PIXEL_FORMAT_MASK;
+    int channels = type_from == PIXEL_RGBA || type_from == PIXEL_BGRA ? 4 : 3;
+    std::vector<unsigned char> resized;
+    {
+        ncnnstub::InternalScope scope;
+        resized.resize((size_t)target_width * target_height * channels);
+    }
+    if (channels == 4) {
+        resize_bilinear_c4(pixels, w, h, resized.data(), target_width, target_height);
+    } else {
+        resize_bilinear_c3(pixels, w, h, resized.data(), target_width, target_height);
+    }
+    return from_pixels(resized.data(), type, target_width, target_height, allocator);
+}
+
+void copy_make_border(const Mat &src, Mat &dst, int top, int bottom, int left, int right, int type, float v,
+                      const Option &opt) {
+    // 替身只支持常量填充的3维float Mat
+    if (type != BORDER_CONSTANT || src.dims != 3 || src.elemsize != 4u) {
+        dst = Mat();
+        return;
+    }
+    int outw = src.w + left + right;
+    int outh = src.h + top + bottom;
+    dst.create(outw, outh, src.c, src.elemsize, opt.blob_allocator);
+    for (int q = 0; q < src.c; q++) {
+        Mat out = dst.channel(q);
+        out.fill(v);
+        const float *inptr = src.channel(q);
+        for (int y = 0; y < src.h; y++) {
+            memcpy(out.row(top + y) + left, inptr + (size_t)y * src.w, src.w * sizeof(float));
+        }
+    }
+}
+
+// ---------------------------------------------------------------- 像素缩放、旋转与转换
+
+#define SATURATE_CAST_SHORT(X) (short)::std::min(::std::max((int)(X + (X >= 0.f ? 0.5f : -0.5f)), SHRT_MIN), SHRT_MAX);
+
+// ncnn::resize_bilinear_c* 的标量实现：11位定点系数，水平插值结果右移4位存为short，
+// 垂直插值 ((b0*r0 >> 16) + (b1*r1 >> 16) + 2) >> 2；坐标与系数表与行缓冲每次调用都重新分配
+template <int CN>
+static void resize_bilinear_cn(const unsigned char *src, int srcw, int srch, int srcstride, unsigned char *dst, int w,
+                               int h, int stride) {
+    ncnnstub::InternalScope scope;
+    const int INTER_RESIZE_COEF_BITS = 11;
+    const int INTER_RESIZE_COEF_SCALE = 1 << INTER_RESIZE_COEF_BITS;
+
+    double scale_x = (double)srcw / w;
+    double scale_y = (double)srch / h;
+
+    int *buf = new int[w + h + w + h];
+    int *xofs = buf;
+    int *yofs = buf + w;
+    short *ialpha = (short *)(buf + w + h);
+    short *ibeta = (short *)(buf + w + h + w);
+
+    for (int dx = 0; dx < w; dx++) {
+        float fx = (float)((dx + 0.5) * scale_x - 0.5);
+        int sx = static_cast<int>(floor(fx));
+        fx -= sx;
+        if (sx < 0) {
+            sx = 0;
+            fx = 0.f;
+        }
+        if (sx >= srcw - 1) {
+            sx = srcw - 2;
+            fx = 1.f;
+        }
+        xofs[dx] = sx * CN;
+
+        float a0 = (1.f - fx) * INTER_RESIZE_COEF_SCALE;
+        float a1 = fx * INTER_RESIZE_COEF_SCALE;
+        ialpha[dx * 2] = SATURATE_CAST_SHORT(a0);
+        ialpha[dx * 2 + 1] = SATURATE_CAST_SHORT(a1);
+    }
+
+    for (int dy = 0; dy < h; dy++) {
+        float fy = (float)((dy + 0.5) * scale_y - 0.5);
+        int sy = static_cast<int>(floor(fy));
+        fy -= sy;
+        if (sy < 0) {
+            sy = 0;
+            fy = 0.f;
+        }
+        if (sy >= srch - 1) {
+            sy = srch - 2;
+            fy = 1.f;
+        }
+        yofs[dy] = sy;
+
+        float b0 = (1.f - fy) * INTER_RESIZE_COEF_SCALE;
+        float b1 = fy * INTER_RESIZE_COEF_SCALE;
+        ibeta[dy * 2] = SATURATE_CAST_SHORT(b0);
+        ibeta[dy * 2 + 1] = SATURATE_CAST_SHORT(b1);
+    }
+
+    Mat rowsbuf0(w * CN + 2, (size_t)2u);
+    Mat rowsbuf1(w * CN + 2, (size_t)2u);
+    short *rows0 = (short *)rowsbuf0.data;
+    short *rows1 = (short *)rowsbuf1.data;
+
+    int prev_sy1 = -2;
+    for (int dy = 0; dy < h; dy++) {
+        int sy = yofs[dy];
+        if (sy == prev_sy1) {
+            // 两行都可复用
+        } else if (sy == prev_sy1 + 1) {
+            std::swap(rows0, rows1);
+            const unsigned char *S1 = src + (size_t)srcstride * (sy + 1);
+            for (int dx = 0; dx < w; dx++) {
+                const unsigned char *S1p = S1 + xofs[dx];
+                short a0 = ialpha[dx * 2];
+                short a1 = ialpha[dx * 2 + 1];
+                for (int k = 0; k < CN; k++) {
+                    rows1[dx * CN + k] = (S1p[k] * a0 + S1p[k + CN] * a1) >> 4;
+                }
+            }
+        } else {
+            const unsigned char *S0 = src + (size_t)srcstride * sy;
+            const unsigned char *S1 = src + (size_t)srcstride * (sy + 1);
+            for (int dx = 0; dx < w; dx++) {
+                const unsigned char *S0p = S0 + xofs[dx];
+                const unsigned char *S1p = S1 + xofs[dx];
+                short a0 = ialpha[dx * 2];
+                short a1 = ialpha[dx * 2 + 1];
+                for (int k = 0; k < CN; k++) {
+                    rows0[dx * CN + k] = (S0p[k] * a0 + S0p[k + CN] * a1) >> 4;
+                    rows1[dx * CN + k] = (S1p[k] * a0 + S1p[k + CN] * a1) >> 4;
+                }
+            }
+        }
+        prev_sy1 = sy;
+
+        short b0 = ibeta[dy * 2];
+        short b1 = ibeta[dy * 2 + 1];
+        unsigned char *Dp = dst + (size_t)stride * dy;
+        for (int x = 0; x < w * CN; x++) {
+            short v0 = (short)((b0 * (short)rows0[x]) >> 16);
+            short v1 = (short)((b1 * (short)rows1[x]) >> 16);
+            Dp[x] = (unsigned char)((v0 + v1 + 2) >> 2);
+        }
+    }
+
+    delete[] buf;
+}
+
+void resize_bilinear_c1(const unsigned char *src, int srcw, int srch, unsigned char *dst, int w, int h) {
+    resize_bilinear_cn<1>(src, srcw, srch, srcw, dst, w, h, w);
+}
+
+void resize_bilinear_c2(const unsigned char *src, int srcw, int srch, unsigned char *dst, int w, int h) {
+    resize_bilinear_cn<2>(src, srcw, srch, srcw * 2, dst, w, h, w * 2);
+}
+
+void resize_bilinear_c3(const unsigned char *src, int srcw, int srch, unsigned char *dst, int w, int h) {
+    resize_bilinear_cn<3>(src, srcw, srch, srcw * 3, dst, w, h, w * 3);
+}
+
+void resize_bilinear_c4(const unsigned char *src, int srcw, int srch, unsigned char *dst, int w, int h) {
+    resize_bilinear_cn<4>(src, srcw, srch, srcw * 4, dst, w, h, w * 4);
+}
+
+void resize_bilinear_c1(const unsigned char *src, int srcw, int srch, int srcstride, unsigned char *dst, int w, int h,
+                        int stride) {
+    resize_bilinear_cn<1>(src, srcw, srch, srcstride, dst, w, h, stride);
+}
+
+void resize_bilinear_c2(const unsigned char *src, int srcw, int srch, int srcstride, unsigned char *dst, int w, int h,
+                        int stride) {
+    resize_bilinear_cn<2>(src, srcw, srch, srcstride, dst, w, h, stride);
+}
+
+void resize_bilinear_c3(const unsigned char *src, int srcw, int srch, int srcstride, unsigned char *dst, int w, int h,
+                        int stride) {
+    resize_bilinear_cn<3>(src, srcw, srch, srcstride, dst, w, h, stride);
+}
+
+void resize_bilinear_c4(const unsigned char *src, int srcw, int srch, int srcstride, unsigned char *dst, int w, int h,
+                        int stride) {
+    resize_bilinear_cn<4>(src, srcw, srch, srcstride, dst, w, h, stride);
+}
+
+// 按EXIF方向（1~8）旋转/翻转，dst(x, y) 取自 src(sx, sy)
+template <int CN>
+static void kanna_rotate_cn(const unsigned char *src, int srcw, int srch, unsigned char *dst, int w, int h, int type) {
+    for (int y = 0; y < h; y++) {
+        for (int x = 0; x < w; x++) {
+            int sx = x;
+            int sy = y;
+            switch (type) {
+            case 2: sx = srcw - 1 - x; break;
+            case 3: sx = srcw - 1 - x; sy = srch - 1 - y; break;
+            case 4: sy = srch - 1 - y; break;
+            case 5: sx = y; sy = x; break;
+            case 6: sx = y; sy = srch - 1 - x; break;
+            case 7: sx = srcw - 1 - y; sy = srch - 1 - x; break;
+            case 8: sx = srcw - 1 - y; sy = x; break;
+            default: break;
+            }
+            memcpy(dst + ((size_t)y * w + x) * CN, src + ((size_t)sy * srcw + sx) * CN, CN);
+        }
+    }
+}
+
+void kanna_rotate_yuv420sp(const unsigned char *src, int srcw, int srch, unsigned char *dst, int w, int h, int type) {
+    kanna_rotate_cn<1>(src, srcw, srch, dst, w, h, type);
+    kanna_rotate_cn<2>(src + (size_t)srcw * srch, srcw / 2, srch / 2, dst + (size_t)w * h, w / 2, h / 2, type);
+}
+
+static inline unsigned char saturate_uchar(int v) { return (unsigned char)std::min(std::max(v, 0), 255); }
+
+// ncnn::yuv420sp2rgb 的定点公式（系数放大64倍）
+void yuv420sp2rgb(const unsigned char *yuv420sp, int w, int h, unsigned char *rgb) {
+    const unsigned char *yptr = yuv420sp;
+    const unsigned char *vuptr = yuv420sp + (size_t)w * h;
+    for (int y = 0; y < h; y += 2) {
+        const unsigned char *yptr0 = yptr;
+        const unsigned char *yptr1 = yptr + w;
+        unsigned char *rgb0 = rgb;
+        unsigned char *rgb1 = rgb + (size_t)w * 3;
+        for (int remain = w; remain > 0; remain -= 2) {
+            int v = vuptr[0] - 128;
+            int u = vuptr[1] - 128;
+            int ruv = 90 * v;
+            int guv = -46 * v + -22 * u;
+            int buv = 113 * u;
+
+            const unsigned char *ys[4] = {yptr0, yptr0 + 1, yptr1, yptr1 + 1};
+            unsigned char *outs[4] = {rgb0, rgb0 + 3, rgb1, rgb1 + 3};
+            for (int k = 0; k < 4; k++) {
+                int yy = ys[k][0] << 6;
+                outs[k][0] = saturate_uchar((yy + ruv) >> 6);
+                outs[k][1] = saturate_uchar((yy + guv) >> 6);
+                outs[k][2] = saturate_uchar((yy + buv) >> 6);
+            }
+
+            yptr0 += 2;
+            yptr1 += 2;
+            vuptr += 2;
+            rgb0 += 6;
+            rgb1 += 6;
+        }
+        yptr += 2 * (size_t)w;
+        rgb += 2 * 3 * (size_t)w;
+    }
+}
+
+// ---------------------------------------------------------------- 分配器
+
+Allocator::~Allocator() {}
+
+// 与ncnn的内存池相同的复用规则：空闲块不小于请求、且请求不小于空闲块的size_compare_ratio时复用
+class PoolState {
+public:
+    PoolState() : size_compare_ratio(192), size_drop_threshold(10) {}
+
+    void *malloc_block(size_t size) {
+        ncnnstub::InternalScope scope;
+        for (size_t i = 0; i < budgets.size(); i++) {
+            size_t bs = budgets[i].first;
+            if (bs >= size && ((bs * size_compare_ratio) >> 8) <= size) {
+                std::pair<size_t, void *> block = budgets[i];
+                budgets.erase(budgets.begin() + i);
+                payouts.push_back(block);
+                return block.second;
+            }
+        }
+        void *ptr = ncnn::fastMalloc(size);
+        payouts.push_back(std::make_pair(size, ptr));
+        return ptr;
+    }
+
+    void free_block(void *ptr) {
+        ncnnstub::InternalScope scope;
+        for (size_t i = 0; i < payouts.size(); i++) {
+            if (payouts[i].second == ptr) {
+                budgets.push_back(payouts[i]);
+                payouts.erase(payouts.begin() + i);
+                return;
+            }
+        }
+        ncnn::fastFree(ptr);
+    }
+
+    void clear() {
+        for (const auto &block : budgets) {
+            ncnn::fastFree(block.second);
+        }
+        budgets.clear();
+    }
+
+    unsigned int size_compare_ratio;  // 0~256
+    size_t size_drop_threshold;
+    std::vector<std::pair<size_t, void *>> budgets;  // 空闲块
+    std::vector<std::pair<size_t, void *>> payouts;  // 已借出的块
+};
+
+class PoolAllocatorPrivate : public PoolState {
+public:
+    std::mutex lock;
+};
+
+class UnlockedPoolAllocatorPrivate : public PoolState {};
+
+PoolAllocator::PoolAllocator() : Allocator(), d(new PoolAllocatorPrivate) {}
+
+PoolAllocator::~PoolAllocator() {
+    clear();
+    delete d;
+}
+
+void PoolAllocator::clear() {
+    std::lock_guard<std::mutex> guard(d->lock);
+    d->clear();
+}
+
+void PoolAllocator::set_size_compare_ratio(float scr) { d->size_compare_ratio = (unsigned int)(scr * 256); }
+
+void PoolAllocator::set_size_drop_threshold(size_t threshold) { d->size_drop_threshold = threshold; }
+
+void *PoolAllocator::fastMalloc(size_t size) {
+    std::lock_guard<std::mutex> guard(d->lock);
+    return d->malloc_block(size);
+}
+
+void PoolAllocator::fastFree(void *ptr) {
+    std::lock_guard<std::mutex> guard(d->lock);
+    d->free_block(ptr);
+}
+
+UnlockedPoolAllocator::UnlockedPoolAllocator() : Allocator(), d(new UnlockedPoolAllocatorPrivate) {}
+
+UnlockedPoolAllocator::~UnlockedPoolAllocator() {
+    clear();
+    delete d;
+}
+
+void UnlockedPoolAllocator::clear() { d->clear(); }
+
+void UnlockedPoolAllocator::set_size_compare_ratio(float scr) { d->size_compare_ratio = (unsigned int)(scr * 256); }
+
+void UnlockedPoolAllocator::set_size_drop_threshold(size_t threshold) { d->size_drop_threshold = threshold; }
+
+void *UnlockedPoolAllocator::fastMalloc(size_t size) { return d->malloc_block(size); }
+
+void UnlockedPoolAllocator::fastFree(void *ptr) { d->free_block(ptr); }
+
+// ---------------------------------------------------------------- Option / Blob
+
+Option::Option() {
+    lightmode = true;
+    num_threads = get_big_cpu_count();
+    blob_allocator = 0;
+    workspace_allocator = 0;
+    openmp_blocktime = 20;
+    use_winograd_convolution = true;
+    use_sgemm_convolution = true;
+    use_int8_inference = true;
+    use_vulkan_compute = false;
+    use_bf16_storage = false;
+    use_fp16_packed = true;
+    use_fp16_storage = true;
+    use_fp16_arithmetic = true;
+    use_int8_packed = true;
+    use_int8_storage = true;
+    use_int8_arithmetic = false;
+    use_packing_layout = true;
+    use_shader_pack8 = false;
+    use_subgroup_basic = false;
+    use_subgroup_vote = false;
+    use_subgroup_ballot = false;
+    use_subgroup_shuffle = false;
+    use_image_storage = false;
+    use_tensor_storage = false;
+    use_reserved_0 = false;
+    flush_denormals = 3;
+    use_local_pool_allocator = true;
+    use_shader_local_memory = true;
+    use_cooperative_matrix = true;
+    use_winograd23_convolution = true;
+    use_winograd43_convolution = true;
+    use_winograd63_convolution = true;
+    use_a53_a55_optimized_kernel = false;
+    use_fp16_uniform = true;
+    use_int8_uniform = true;
+    use_reserved_9 = false;
+    use_reserved_10 = false;
+    use_reserved_11 = false;
+}
+
+Blob::Blob() : producer(-1), consumer(-1) {}
+
+// ---------------------------------------------------------------- Net / Extractor
+
+class NetPrivate {
+public:
+    std::vector<Blob> blobs;
+    std::vector<Layer *> layers;  // 替身不创建层，始终为空
+    std::vector<int> input_indexes;
+    std::vector<int> output_indexes;
+};
+
+class ExtractorPrivate {
+public:
+    const Net *net;
+    std::vector<Mat> blob_mats;
+    Option opt;
+};
+
+Net::Net() : d(new NetPrivate) {}
+
+Net::~Net() {
+    clear();
+    delete d;
+}
+
+// 只解析blob：每行 "类型 名称 输入数 输出数 输入... 输出... 参数..."，Input层的输出为网络输入，没有消费者的blob为网络输出
+int Net::load_param_mem(const char *mem) {
+    clear();
+    std::istringstream in(mem ? mem : "");
+    int magic = 0;
+    int layer_count = 0;
+    int blob_count = 0;
+    if (!(in >> magic >> layer_count >> blob_count) || magic != 7767517 || layer_count <= 0) {
+        return -1;
+    }
+
+    auto blob_index = [this](const std::string &name) {
+        for (size_t i = 0; i < d->blobs.size(); i++) {
+            if (d->blobs[i].name == name) {
+                return (int)i;
+            }
+        }
+        Blob blob;
+        blob.name = name;
+        d->blobs.push_back(blob);
+        return (int)d->blobs.size() - 1;
+    };
+
+    std::string line;
+    std::getline(in, line);
+    for (int i = 0; i < layer_count; i++) {
+        if (!std::getline(in, line)) {
+            clear();
+            return -1;
+        }
+        std::istringstream fields(line);
+        std::string type;
+        std::string name;
+        int bottom_count = 0;
+        int top_count = 0;
+        if (!(fields >> type >> name >> bottom_count >> top_count)) {
+            clear();
+            return -1;
+        }
+        for (int j = 0; j < bottom_count; j++) {
+            std::string bottom;
+            fields >> bottom;
+            d->blobs[blob_index(bottom)].consumer = i;
+        }
+        for (int j = 0; j < top_count; j++) {
+            std::string top;
+            fields >> top;
+            int index = blob_index(top);
+            d->blobs[index].producer = i;
+            if (type == "Input") {
+                d->input_indexes.push_back(index);
+            }
+        }
+    }
+    for (size_t i = 0; i < d->blobs.size(); i++) {
+        if (d->blobs[i].consumer < 0 && d->blobs[i].producer >= 0) {
+            d->output_indexes.push_back((int)i);
+        }
+    }
+    return 0;
+}
+
+// 不读取权重，加载成功时按读取了一个float返回
+int Net::load_model(const unsigned char *mem) { return mem != nullptr && !d->blobs.empty() ? (int)sizeof(float) : 0; }
+
+void Net::clear() {
+    d->blobs.clear();
+    d->input_indexes.clear();
+    d->output_indexes.clear();
+}
+
+Extractor Net::create_extractor() const { return Extractor(this, d->blobs.size()); }
+
+const std::vector<int> &Net::input_indexes() const { return d->input_indexes; }
+
+const std::vector<int> &Net::output_indexes() const { return d->output_indexes; }
+
+const std::vector<Blob> &Net::blobs() const { return d->blobs; }
+
+const std::vector<Layer *> &Net::layers() const { return d->layers; }
+
+std::vector<Blob> &Net::mutable_blobs() { return d->blobs; }
+
+std::vector<Layer *> &Net::mutable_layers() { return d->layers; }
+
+int Net::find_blob_index_by_name(const char *name) const {
+    for (size_t i = 0; i < d->blobs.size(); i++) {
+        if (d->blobs[i].name == name) {
+            return (int)i;
+        }
+    }
+    return -1;
+}
+
+int Net::custom_layer_to_index(const char *) { return -1; }
+
+Layer *Net::create_custom_layer(const char *) { return 0; }
+
+Layer *Net::create_overwrite_builtin_layer(const char *) { return 0; }
+
+Layer *Net::create_custom_layer(int) { return 0; }
+
+Layer *Net::create_overwrite_builtin_layer(int) { return 0; }
+
+// 与ncnn一样，每个extractor在堆上分配私有状态与blob表
+static ExtractorPrivate *new_extractor_private(const Net *net, size_t blob_count) {
+    ncnnstub::InternalScope scope;
+    ExtractorPrivate *d = new ExtractorPrivate;
+    d->net = net;
+    d->blob_mats.resize(blob_count);
+    d->opt = net->opt;
+    return d;
+}
+
+static ExtractorPrivate *copy_extractor_private(const ExtractorPrivate *rhs) {
+    ncnnstub::InternalScope scope;
+    return new ExtractorPrivate(*rhs);
+}
+
+Extractor::Extractor(const Net *_net, size_t blob_count) : d(new_extractor_private(_net, blob_count)) {}
+
+Extractor::Extractor(const Extractor &rhs) : d(copy_extractor_private(rhs.d)) {}
+
+Extractor &Extractor::operator=(const Extractor &rhs) {
+    if (this != &rhs) {
+        ncnnstub::InternalScope scope;
+        *d = *rhs.d;
+    }
+    return *this;
+}
+
+Extractor::~Extractor() {
+    clear();
+    delete d;
+}
+
+void Extractor::clear() {
+    for (Mat &m : d->blob_mats) {
+        m.release();
+    }
+}
+
+void Extractor::set_light_mode(bool enable) { d->opt.lightmode = enable; }
+
+void Extractor::set_num_threads(int num_threads) { d->opt.num_threads = num_threads; }
+
+void Extractor::set_blob_allocator(Allocator *allocator) { d->opt.blob_allocator = allocator; }
+
+void Extractor::set_workspace_allocator(Allocator *allocator) { d->opt.workspace_allocator = allocator; }
+
+int Extractor::input(int blob_index, const Mat &in) {
+    if (blob_index < 0 || blob_index >= (int)d->blob_mats.size()) {
+        return -1;
+    }
+    d->blob_mats[blob_index] = in;
+    return 0;
+}
+
+int Extractor::input(const char *blob_name, const Mat &in) {
+    return input(d->net->find_blob_index_by_name(blob_name), in);
+}
+
+int Extractor::extract(int blob_index, Mat &feat, int) {
+    if (blob_index < 0 || blob_index >= (int)d->blob_mats.size()) {
+        return -1;
+    }
+    if (d->blob_mats[blob_index].dims == 0) {
+        if (!ncnnstub::g_forward) {
+            return -1;
+        }
+        Mat input;
+        for (int index : d->net->input_indexes()) {
+            if (!d->blob_mats[index].empty()) {
+                input = d->blob_mats[index];
+                break;
+            }
+        }
+        ncnnstub::InternalScope scope;
+        int ret = ncnnstub::g_forward(d->net->blobs()[blob_index].name, input, d->blob_mats[blob_index],
+                                      d->opt.blob_allocator);
+        if (ret != 0) {
+            d->blob_mats[blob_index].release();
+            return ret;
+        }
+    }
+    feat = d->blob_mats[blob_index];
+    return 0;
+}
+
+int Extractor::extract(const char *blob_name, Mat &feat, int type) {
+    return extract(d->net->find_blob_index_by_name(blob_name), feat, type);
+}
+
+// ---------------------------------------------------------------- cpu / 计时
+
+// 替身不做真实的绑核：affinity掩码包含全部核心，设置总是成功
+static int g_powersave = 0;
+
+CpuSet::CpuSet() { disable_all(); }
+
+void CpuSet::enable(int cpu) { CPU_SET(cpu, &cpu_set); }
+
+void CpuSet::disable(int cpu) { CPU_CLR(cpu, &cpu_set); }
+
+void CpuSet::disable_all() { CPU_ZERO(&cpu_set); }
+
+bool CpuSet::is_enabled(int cpu) const { return CPU_ISSET(cpu, &cpu_set); }
+
+int CpuSet::num_enabled() const { return CPU_COUNT(&cpu_set); }
+
+int get_cpu_count() { return std::max(1, (int)std::thread::hardware_concurrency()); }
+
+int get_little_cpu_count() { return 0; }
+
+int get_big_cpu_count() { return get_cpu_count(); }
+
+int get_cpu_powersave() { return g_powersave; }
+
+int set_cpu_powersave(int powersave) {
+    if (powersave < 0 || powersave > 2) {
+        return -1;
+    }
+    g_powersave = powersave;
+    return 0;
+}
+
+const CpuSet &get_cpu_thread_affinity_mask(int) {
+    static CpuSet mask = [] {
+        CpuSet all;
+        for (int i = 0; i < get_cpu_count() && i < CPU_SETSIZE; i++) {
+            all.enable(i);
+        }
+        return all;
+    }();
+    return mask;
+}
+
+int set_cpu_thread_affinity(const CpuSet &) { return 0; }
+
+double get_current_time() {
+    auto now = std::chrono::steady_clock::now().time_since_epoch();
+    return std::chrono::duration<double, std::milli>(now).count();
+}
+
+} // namespace ncnn
@@ -0,0 +1,46 @@
+#ifndef NCNN_STUB_H
+#define NCNN_STUB_H
+
+#include "net.h"
+#include <cstddef>
+#include <functional>
+#include <string>
+
+// 主机测试用的ncnn替身（ncnn_stub.cpp）
+// 只实现tncnn用到的接口，链接时代替libncnn：Mat与内存池、Net/Extractor、像素缩放与转换、cpu与计时函数。
+// Net只解析.param中的blob名称，不创建层；extract的结果由测试安装的forward函数生成。
+// 像素函数按ncnn的标量实现移植，from_pixels_resize + copy_make_border + substract_mean_normalize
+// 可以作为ResizeNormalizer的逐位参考。
+namespace ncnnstub {
+
+// 生成一个输出blob：blob为名称，input为extractor的第一个输入，output须由allocator分配
+// （与ncnn一样，blob来自extractor的blob_allocator，为空时使用默认的fastMalloc）
+// 返回非0表示推理失败；可能被多个extractor同时调用
+typedef std::function<int(const std::string &blob, const ncnn::Mat &input, ncnn::Mat &output,
+                          ncnn::Allocator *allocator)>
+    ForwardFunc;
+
+// 安装forward函数（测试开始前设置，推理期间不能修改）
+void set_forward(ForwardFunc func);
+
+// 当前线程是否正在执行替身内部的代码
+// 替身和真实ncnn一样在extractor、内存池、像素缩放中分配内存，测试据此把这些分配与检测器自身的分配区分开
+bool in_ncnn();
+
+// ncnn之外（in_ncnn()为false时）未指定分配器、直接由fastMalloc分配的Mat次数
+size_t default_mat_allocations();
+
+// 在作用域内标记当前线程处于替身内部（forward函数由替身调用，已在作用域内）
+class InternalScope {
+public:
+    InternalScope();
+    ~InternalScope();
+
+private:
+    InternalScope(const InternalScope &) = delete;
+    InternalScope &operator=(const InternalScope &) = delete;
+};
+
+} // namespace ncnnstub
+
+#endif // NCNN_STUB_H
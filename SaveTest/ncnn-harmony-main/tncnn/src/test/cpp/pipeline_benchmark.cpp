@@ -0,0 +1,95 @@
+// 端到端基准：用真实的YOLOv8/NanoDet类处理图像，报告各阶段耗时的分布
+// 网络输出由测试生成（替身不能推理），forward_ms大于0时推理忙等该时长；JS结果转换只能在设备上测量。
+//   pipeline_benchmark [frames] [forward_ms]
+#include "benchmark.h"
+#include "nanodet.h"
+#include "test_util.h"
+#include "yolov8.h"
+#include <algorithm>
+#include <cstdlib>
+
+static const int STAGE_COUNT = 7;
+static const char *STAGE_NAMES[STAGE_COUNT] = {"convert", "resize", "normalize", "forward", "decode", "nms",
+                                               "total"};
+
+// 各阶段的样本
+typedef struct StageSamples {
+    std::vector<double> values[STAGE_COUNT];
+
+    void add(const netutils::StageTimes &t, double total) {
+        const double v[STAGE_COUNT] = {t.convert, t.resize, t.normalize, t.forward, t.decode, t.nms, total};
+        for (int i = 0; i < STAGE_COUNT; i++) {
+            values[i].push_back(v[i]);
+        }
+    }
+} StageSamples;
+
+static double percentile(const std::vector<double> &sorted, double p) {
+    size_t i = (size_t)(p * (sorted.size() - 1) + 0.5);
+    return sorted[i];
+}
+
+static void report(const char *name, size_t boxes, StageSamples &samples) {
+    printf("%s (boxes:%zu)\n", name, boxes);
+    printf("  %-10s %10s %10s %10s %10s\n", "stage(ms)", "min", "p50", "p90", "p99");
+    for (int i = 0; i < STAGE_COUNT; i++) {
+        std::vector<double> &v = samples.values[i];
+        std::sort(v.begin(), v.end());
+        printf("  %-10s %10.3f %10.3f %10.3f %10.3f\n", STAGE_NAMES[i], v.front(), percentile(v, 0.5),
+               percentile(v, 0.9), percentile(v, 0.99));
+        CHECK(v.front() >= 0);
+    }
+}
+
+// 预热一帧后运行frames帧，frame()返回框数
+template <typename Model, typename Frame>
+static void bench(const char *name, const Model &model, int frames, Frame frame) {
+    size_t boxes = frame();
+    StageSamples samples;
+    for (int i = 0; i < frames; i++) {
+        double start = ncnn::get_current_time();
+        boxes = frame();
+        samples.add(model.stage_times(), ncnn::get_current_time() - start);
+    }
+    report(name, boxes, samples);
+    CHECK(boxes > 0);
+}
+
+static ncnn::Option make_option() {
+    ncnn::Option option;
+    option.num_threads = 1;
+    return option;
+}
+
+int main(int argc, char **argv) {
+    int frames = argc > 1 ? atoi(argv[1]) : 200;
+    double forward_ms = argc > 2 ? atof(argv[2]) : 0;
+    if (frames <= 0 || forward_ms < 0) {
+        fprintf(stderr, "usage: %s [frames] [forward_ms]\n", argv[0]);
+        return 2;
+    }
+
+    testutil::install_yolov8_forward(false, 64, forward_ms);
+    yolo::YOLOv8 yolov8;
+    CHECK(yolov8.init(make_option(), testutil::make_yolov8_model(false), "yolov8n") == 1);
+
+    std::vector<unsigned char> rgba = testutil::random_pixels(1280, 720, 4, 1);
+    ncnn::Mat image(1280, 720, 4, (void *)rgba.data());
+    bench("yolov8n rgba 1280x720", yolov8, frames, [&]() { return yolov8.run(image, 1280, 720, "yolov8n").size(); });
+
+    std::vector<unsigned char> nv21 = testutil::random_pixels(1280, 720 * 3 / 2, 1, 2);
+    bench("yolov8n nv21 1280x720 rotation 90", yolov8, frames,
+          [&]() { return yolov8.run_nv21(nv21.data(), 1280, 720, 1280, 90, "yolov8n").size(); });
+
+    testutil::install_nanodet_forward(16);
+    nanodet::NanoDet nanodet;
+    CHECK(nanodet.init(make_option(), testutil::make_nanodet_model(), "nanodet-m") == 1);
+    std::vector<unsigned char> small = testutil::random_pixels(640, 480, 4, 3);
+    ncnn::Mat small_image(640, 480, 4, (void *)small.data());
+    bench("nanodet-m rgba 640x480", nanodet, frames,
+          [&]() { return nanodet.run(small_image, 640, 480, "nanodet-m").size(); });
+    ncnnstub::set_forward(nullptr);
+
+    printf("%s\n", testutil::failures == 0 ? "PASS" : "FAIL");
+    return testutil::failures == 0 ? 0 : 1;
+}
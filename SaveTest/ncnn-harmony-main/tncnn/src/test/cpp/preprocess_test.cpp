@@ -0,0 +1,148 @@
+// ResizeNormalizer与ncnn三步预处理（from_pixels_resize + copy_make_border + substract_mean_normalize）的逐位比较
+// preprocess.cpp按指令集分别编译（见CMakeLists.txt），本文件不带指令集选项，CPU不支持时以77退出（ctest记为跳过）。
+// 均值为0时要求逐位一致；均值非0时 x*norm-mean*norm 可能被编译器融合为乘加，允许1ulp。
+#include "preprocess.h"
+#include "test_util.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+static const int SKIP_RETURN_CODE = 77;
+
+static const float YOLO_MEAN[3] = {0.f, 0.f, 0.f};
+static const float YOLO_NORM[3] = {1 / 255.f, 1 / 255.f, 1 / 255.f};
+static const float NANODET_MEAN[3] = {103.53f, 116.28f, 123.675f};
+static const float NANODET_NORM[3] = {0.017429f, 0.017507f, 0.01712475f};
+
+// 两个float之间相差的ulp数（同号时按位序比较）
+static int64_t ulp_distance(float a, float b) {
+    int32_t ia, ib;
+    memcpy(&ia, &a, sizeof(ia));
+    memcpy(&ib, &b, sizeof(ib));
+    if (ia < 0) {
+        ia = INT32_MIN - ia;
+    }
+    if (ib < 0) {
+        ib = INT32_MIN - ib;
+    }
+    return ia > ib ? (int64_t)ia - ib : (int64_t)ib - ia;
+}
+
+typedef struct Case {
+    int srcw;
+    int srch;
+    int src_channels;
+    int w;        // 缩放后尺寸
+    int h;
+    int target_w; // 网络输入尺寸，缩放结果放在(left, top)处，其余为填充
+    int target_h;
+    int left;
+    int top;
+    int stride_pad; // 源行跨度在 srcw * src_channels 之外多出的字节
+} Case;
+
+// 三步流程的参考结果
+static ncnn::Mat reference(const Case &c, const unsigned char *packed, bool bgr, float pad, const float *mean_vals,
+                           const float *norm_vals) {
+    int type;
+    if (c.src_channels == 4) {
+        type = bgr ? ncnn::Mat::PIXEL_RGBA2BGR : ncnn::Mat::PIXEL_RGBA2RGB;
+    } else {
+        type = bgr ? ncnn::Mat::PIXEL_RGB2BGR : ncnn::Mat::PIXEL_RGB;
+    }
+    ncnn::Mat in = ncnn::Mat::from_pixels_resize(packed, type, c.srcw, c.srch, c.w, c.h);
+    ncnn::Mat out;
+    ncnn::copy_make_border(in, out, c.top, c.target_h - c.h - c.top, c.left, c.target_w - c.w - c.left,
+                           ncnn::BORDER_CONSTANT, pad);
+    out.substract_mean_normalize(mean_vals, norm_vals);
+    return out;
+}
+
+// 比较一种组合，返回最大ulp差
+static int64_t compare(preprocess::ResizeNormalizer &resizer, const Case &c, bool bgr, const float *mean_vals,
+                       const float *norm_vals) {
+    const float pad = 114.f;
+    int row_bytes = c.srcw * c.src_channels;
+    int stride = row_bytes + c.stride_pad;
+    std::vector<unsigned char> pixels = testutil::random_pixels(stride, c.srch, 1, c.srcw * 31 + c.srch);
+    std::vector<unsigned char> packed((size_t)row_bytes * c.srch);
+    for (int y = 0; y < c.srch; y++) {
+        memcpy(packed.data() + (size_t)y * row_bytes, pixels.data() + (size_t)y * stride, row_bytes);
+    }
+
+    ncnn::Mat expected = reference(c, packed.data(), bgr, pad, mean_vals, norm_vals);
+
+    ncnn::Mat actual(c.target_w, c.target_h, 3);
+    preprocess::fill_normalized(actual, pad, mean_vals, norm_vals);
+    resizer.prepare(c.srcw, c.srch, c.src_channels, c.w, c.h);
+    resizer.run(pixels.data(), stride, actual, c.left, c.top, mean_vals, norm_vals, bgr);
+
+    CHECK(expected.w == actual.w && expected.h == actual.h && expected.c == actual.c);
+    int64_t max_ulp = 0;
+    for (int q = 0; q < expected.c; q++) {
+        const float *e = expected.channel(q);
+        const float *a = actual.channel(q);
+        for (int i = 0; i < expected.w * expected.h; i++) {
+            max_ulp = std::max(max_ulp, ulp_distance(e[i], a[i]));
+        }
+    }
+    return max_ulp;
+}
+
+static bool cpu_supported() {
+#if defined(TNCNN_TEST_ISA) && (defined(__x86_64__) || defined(__i386__))
+    return __builtin_cpu_supports(TNCNN_TEST_ISA);
+#else
+    return true;
+#endif
+}
+
+int main() {
+#ifdef TNCNN_TEST_ISA
+    const char *isa = TNCNN_TEST_ISA;
+#else
+    const char *isa = "default";
+#endif
+    if (!cpu_supported()) {
+        printf("preprocess (%s): not supported by this CPU, skipped\n", isa);
+        return SKIP_RETURN_CODE;
+    }
+
+    // 覆盖letterbox的常见形状、放大、奇数宽度（各SIMD宽度的尾部）与带填充的行跨度
+    const Case cases[] = {
+        {1280, 720, 4, 640, 360, 640, 640, 0, 140, 0},
+        {720, 1280, 4, 360, 640, 640, 640, 140, 0, 0},
+        {640, 480, 4, 320, 320, 320, 320, 0, 0, 0},
+        {1920, 1080, 3, 416, 234, 416, 416, 0, 91, 0},
+        {333, 211, 4, 117, 75, 128, 96, 5, 9, 12},
+        {37, 23, 3, 101, 67, 101, 67, 0, 0, 3},
+        {64, 64, 4, 23, 15, 31, 17, 3, 1, 0},
+        {2, 2, 3, 9, 7, 9, 7, 0, 0, 0},
+        {501, 377, 3, 17, 31, 32, 32, 7, 0, 1},
+    };
+
+    preprocess::ResizeNormalizer resizer;
+    int64_t worst_zero_mean = 0;
+    int64_t worst_mean = 0;
+    for (const Case &c : cases) {
+        for (int bgr = 0; bgr < 2; bgr++) {
+            int64_t ulp = compare(resizer, c, bgr != 0, YOLO_MEAN, YOLO_NORM);
+            int64_t ulp_no_mean = compare(resizer, c, bgr != 0, nullptr, YOLO_NORM);
+            int64_t ulp_mean = compare(resizer, c, bgr != 0, NANODET_MEAN, NANODET_NORM);
+            if (ulp != 0 || ulp_no_mean != 0 || ulp_mean > 1) {
+                fprintf(stderr, "%dx%dx%d -> %dx%d bgr:%d: ulp %lld/%lld/%lld\n", c.srcw, c.srch, c.src_channels,
+                        c.w, c.h, bgr, (long long)ulp, (long long)ulp_no_mean, (long long)ulp_mean);
+            }
+            CHECK_EQ(ulp, 0);
+            CHECK_EQ(ulp_no_mean, 0);
+            CHECK(ulp_mean <= 1);
+            worst_zero_mean = std::max(worst_zero_mean, std::max(ulp, ulp_no_mean));
+            worst_mean = std::max(worst_mean, ulp_mean);
+        }
+    }
+
+    printf("preprocess (%s): %zu shapes, max ulp zero mean:%lld mean:%lld\n", isa, sizeof(cases) / sizeof(cases[0]),
+           (long long)worst_zero_mean, (long long)worst_mean);
+    printf("%s\n", testutil::failures == 0 ? "PASS" : "FAIL");
+    return testutil::failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,14 @@
+#ifndef HOST_STUB_HILOG_LOG_H
+#define HOST_STUB_HILOG_LOG_H
+
+// 主机测试用的hilog替身：丢弃日志，但和真实hilog一样对参数求值（格式字符串中的%{public}不做解析）
+enum LogType { LOG_APP = 0 };
+
+inline void host_log_discard(int, const char *, ...) {}
+
+#define OH_LOG_DEBUG(type, ...) host_log_discard(type, __VA_ARGS__)
+#define OH_LOG_INFO(type, ...) host_log_discard(type, __VA_ARGS__)
+#define OH_LOG_WARN(type, ...) host_log_discard(type, __VA_ARGS__)
+#define OH_LOG_ERROR(type, ...) host_log_discard(type, __VA_ARGS__)
+
+#endif // HOST_STUB_HILOG_LOG_H
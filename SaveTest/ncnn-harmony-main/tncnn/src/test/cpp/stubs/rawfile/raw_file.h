@@ -0,0 +1,25 @@
+#ifndef HOST_STUB_RAWFILE_RAW_FILE_H
+#define HOST_STUB_RAWFILE_RAW_FILE_H
+
+#include <cstddef>
+
+// 主机测试用的rawfile替身：主机上没有hap资源，打开任何rawfile都失败（模型由测试直接构造ModelData）
+struct RawFile;
+
+typedef struct RawFileDescriptor {
+    int fd;
+    long start;
+    long length;
+} RawFileDescriptor;
+
+inline long OH_ResourceManager_GetRawFileSize(RawFile *) { return 0; }
+
+inline int OH_ResourceManager_ReadRawFile(const RawFile *, void *, size_t) { return 0; }
+
+inline void OH_ResourceManager_CloseRawFile(RawFile *) {}
+
+inline bool OH_ResourceManager_GetRawFileDescriptor(const RawFile *, RawFileDescriptor &) { return false; }
+
+inline bool OH_ResourceManager_ReleaseRawFileDescriptor(const RawFileDescriptor &) { return true; }
+
+#endif // HOST_STUB_RAWFILE_RAW_FILE_H
@@ -0,0 +1,10 @@
+#ifndef HOST_STUB_RAWFILE_RAW_FILE_MANAGER_H
+#define HOST_STUB_RAWFILE_RAW_FILE_MANAGER_H
+
+#include "rawfile/raw_file.h"
+
+struct NativeResourceManager;
+
+inline RawFile *OH_ResourceManager_OpenRawFile(const NativeResourceManager *, const char *) { return nullptr; }
+
+#endif // HOST_STUB_RAWFILE_RAW_FILE_MANAGER_H
@@ -0,0 +1,160 @@
+#include "test_util.h"
+#include <cstring>
+#include <ctime>
+#include <string>
+
+namespace testutil {
+
+int failures = 0;
+
+static const int YOLO_TARGET = 640;
+static const int YOLO_ANCHORS = 8400;  // 80*80 + 40*40 + 20*20
+static const int YOLO_CLASSES = 80;
+static const int YOLO_REG_MAX = 16;
+static const float LOW_LOGIT = -8.f;   // sigmoid约为0.0003，低于任何常用阈值
+
+static std::unique_ptr<modelloader::ModelData> make_model(const std::string &param, const std::string &meta) {
+    std::unique_ptr<modelloader::ModelData> model(new modelloader::ModelData());
+    model->param = param;
+    model->meta = meta;
+    memset(model->bin.allocate(sizeof(float)), 0, sizeof(float));
+    return model;
+}
+
+std::unique_ptr<modelloader::ModelData> make_yolov8_model(bool dfl) {
+    int features = (dfl ? 4 * YOLO_REG_MAX : 4) + YOLO_CLASSES;
+    std::string param = "7767517\n2 2\n"
+                        "Input images 0 1 images\n"
+                        "Convolution head 1 1 images output0 0=" + std::to_string(features) + "\n";
+    std::string meta = std::string("format=") + (dfl ? "dfl" : "direct") + "\nlayout=channel\nreg_max=" +
+                       std::to_string(YOLO_REG_MAX) + "\nnum_classes=" + std::to_string(YOLO_CLASSES) + "\n";
+    return make_model(param, meta);
+}
+
+// 与YOLOv8::build_anchors相同的anchor排列
+static void anchor_center(int anchor, float &cx, float &cy) {
+    const int strides[3] = {8, 16, 32};
+    for (int stride : strides) {
+        int grid = YOLO_TARGET / stride;
+        if (anchor < grid * grid) {
+            cx = (anchor % grid + 0.5f) * stride;
+            cy = (anchor / grid + 0.5f) * stride;
+            return;
+        }
+        anchor -= grid * grid;
+    }
+    cx = cy = 0;
+}
+
+void fill_yolov8_output(ncnn::Mat &output, bool dfl, int hits) {
+    int box_rows = dfl ? 4 * YOLO_REG_MAX : 4;
+    for (int r = 0; r < box_rows + YOLO_CLASSES; r++) {
+        float *row = output.row(r);
+        for (int a = 0; a < YOLO_ANCHORS; a++) {
+            if (r >= box_rows) {
+                row[a] = LOW_LOGIT;
+            } else if (dfl) {
+                // 每条边的分布在第3个区间取峰值，期望约为3个步长
+                row[a] = (r % YOLO_REG_MAX) == 3 ? 4.f : 0.f;
+            } else {
+                float cx, cy;
+                anchor_center(a, cx, cy);
+                row[a] = r == 0 ? cx : (r == 1 ? cy : 48.f);
+            }
+        }
+    }
+
+    // 每4个相邻anchor一组，同组的框大量重叠，NMS只保留其中一个
+    for (int i = 0; i < hits; i++) {
+        int group = i / 4;
+        int anchor = (group * 523) % (6400 - 4) + i % 4;
+        int label = group % YOLO_CLASSES;
+        output.row(box_rows + label)[anchor] = 2.f + 0.1f * (i % 4);
+    }
+}
+
+void install_yolov8_forward(bool dfl, int hits, double cost_ms) {
+    std::shared_ptr<ncnn::Mat> templ = std::make_shared<ncnn::Mat>();
+    {
+        ncnnstub::InternalScope scope;
+        templ->create(YOLO_ANCHORS, (dfl ? 4 * YOLO_REG_MAX : 4) + YOLO_CLASSES);
+    }
+    fill_yolov8_output(*templ, dfl, hits);
+
+    ncnnstub::set_forward([templ, cost_ms](const std::string &blob, const ncnn::Mat &, ncnn::Mat &output,
+                                           ncnn::Allocator *allocator) {
+        if (blob != "output0") {
+            return -1;
+        }
+        if (cost_ms > 0) {
+            spin(cost_ms);
+        }
+        output.create(templ->w, templ->h, 4u, allocator);
+        memcpy(output.data, templ->data, templ->total() * templ->elemsize);
+        return 0;
+    });
+}
+
+std::unique_ptr<modelloader::ModelData> make_nanodet_model() {
+    // cls_pred|dis_pred 与nanodet.h的heads_info一致
+    std::string param = "7767517\n7 7\n"
+                        "Input input.1 0 1 input.1\n"
+                        "Convolution cls8 1 1 input.1 792 0=80\n"
+                        "Convolution dis8 1 1 input.1 795 0=32\n"
+                        "Convolution cls16 1 1 input.1 814 0=80\n"
+                        "Convolution dis16 1 1 input.1 817 0=32\n"
+                        "Convolution cls32 1 1 input.1 836 0=80\n"
+                        "Convolution dis32 1 1 input.1 839 0=32\n";
+    return make_model(param, "");
+}
+
+void install_nanodet_forward(int hits) {
+    ncnnstub::set_forward([hits](const std::string &blob, const ncnn::Mat &, ncnn::Mat &output,
+                                 ncnn::Allocator *allocator) {
+        static const char *cls_blobs[] = {"792", "814", "836"};
+        static const char *dis_blobs[] = {"795", "817", "839"};
+        for (int head = 0; head < 3; head++) {
+            int grid = 320 / (8 << head);
+            if (blob == dis_blobs[head]) {
+                // 全0的分布，softmax期望为中间的区间
+                output.create(32, grid * grid, 4u, allocator);
+                output.fill(0.f);
+                return 0;
+            }
+            if (blob == cls_blobs[head]) {
+                output.create(80, grid * grid, 4u, allocator);
+                output.fill(0.f);
+                for (int i = 0; i < hits; i++) {
+                    output.row((i * 37) % (grid * grid))[i % 80] = 0.8f;
+                }
+                return 0;
+            }
+        }
+        return -1;
+    });
+}
+
+std::vector<unsigned char> random_pixels(int width, int height, int channels, unsigned int seed) {
+    std::vector<unsigned char> pixels((size_t)width * height * channels);
+    unsigned int state = seed * 2654435761u + 1;
+    for (unsigned char &p : pixels) {
+        state = state * 1664525u + 1013904223u;
+        p = (unsigned char)(state >> 24);
+    }
+    return pixels;
+}
+
+// 按线程CPU时间计时：多个线程同时忙等时与真实推理一样竞争核心，核心不足时墙钟耗时随之变长
+static double thread_cpu_ms() {
+    timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1000000.0;
+}
+
+void spin(double ms) {
+    double start = thread_cpu_ms();
+    while (thread_cpu_ms() - start < ms) {
+    }
+}
+
+} // namespace testutil
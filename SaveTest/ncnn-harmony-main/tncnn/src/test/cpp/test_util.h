@@ -0,0 +1,60 @@
+#ifndef TEST_UTIL_H
+#define TEST_UTIL_H
+
+#include "model_loader.h"
+#include "ncnn_stub.h"
+#include <cstdio>
+#include <memory>
+#include <vector>
+
+// 主机测试的公共部分：断言、合成模型与测试图像
+namespace testutil {
+
+// 失败的断言数，main以此作为退出码
+extern int failures;
+
+#define CHECK(cond)                                                                                                    \
+    do {                                                                                                               \
+        if (!(cond)) {                                                                                                 \
+            fprintf(stderr, "%s:%d: CHECK failed: %s\n", __FILE__, __LINE__, #cond);                                  \
+            testutil::failures++;                                                                                      \
+        }                                                                                                              \
+    } while (0)
+
+#define CHECK_EQ(a, b)                                                                                                 \
+    do {                                                                                                               \
+        long long _va = (long long)(a);                                                                                \
+        long long _vb = (long long)(b);                                                                                \
+        if (_va != _vb) {                                                                                              \
+            fprintf(stderr, "%s:%d: CHECK_EQ failed: %s = %lld, %s = %lld\n", __FILE__, __LINE__, #a, _va, #b, _vb);  \
+            testutil::failures++;                                                                                      \
+        }                                                                                                              \
+    } while (0)
+
+// 合成的YOLOv8模型（640输入，80类，8400个anchor）
+// 输出为通道优先的 [4+80, 8400]（直接坐标）或 [4*16+80, 8400]（DFL），格式由.meta给出
+// hits个anchor的某个类别logit高于阈值（框成簇分布，NMS会去掉一部分），其余anchor全部低于阈值
+std::unique_ptr<modelloader::ModelData> make_yolov8_model(bool dfl);
+
+// 安装合成YOLOv8模型的forward：每次推理把预先生成的输出拷贝到blob分配器分配的Mat
+// cost_ms大于0时忙等该时长，模拟网络推理占用一个核心
+void install_yolov8_forward(bool dfl, int hits, double cost_ms = 0);
+
+// 生成与install_yolov8_forward相同的输出（不经过extractor，供解码基准直接使用）
+void fill_yolov8_output(ncnn::Mat &output, bool dfl, int hits);
+
+// 合成的NanoDet-m模型（320输入，三个检测头，输出blob名与nanodet.h的heads_info一致）
+std::unique_ptr<modelloader::ModelData> make_nanodet_model();
+
+// 安装合成NanoDet模型的forward，每个检测头有hits个位置的类别分数高于阈值
+void install_nanodet_forward(int hits);
+
+// 确定性的伪随机图像
+std::vector<unsigned char> random_pixels(int width, int height, int channels, unsigned int seed);
+
+// 忙等ms毫秒（调用线程的CPU时间）
+void spin(double ms);
+
+} // namespace testutil
+
+#endif // TEST_UTIL_H